@@ -0,0 +1,102 @@
+// Tesseract 引擎池基准
+// 对同一组图片分别以不同的池大小识别，输出 页/秒 与相对单引擎的加速比
+// 用法: xs_bench_tesseract <图片目录> [语言=chi_sim+eng] [池大小=1,2,4,8] [轮数=1]
+#include "adapters/TesseractAdapter.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <cstdio>
+
+static void quietHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    if (type == QtDebugMsg) return;
+    fprintf(stderr, "%s\n", qFormatLogMessage(type, context, msg).toLocal8Bit().constData());
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    qInstallMessageHandler(quietHandler);
+
+    const QStringList args = app.arguments();
+    if (args.size() < 2) {
+        fprintf(stderr, "usage: %s <image-dir> [lang=chi_sim+eng] [pool-sizes=1,2,4,8] [rounds=1]\n",
+                qPrintable(QFileInfo(args.first()).fileName()));
+        return 1;
+    }
+    const QString lang = args.value(2, "chi_sim+eng");
+    const QStringList sizeList = args.value(3, "1,2,4,8").split(',', Qt::SkipEmptyParts);
+    const int rounds = qMax(1, args.value(4, "1").toInt());
+
+    QVector<QImage> images;
+    const QFileInfoList files = QDir(args.at(1)).entryInfoList(
+        QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp" << "*.tif" << "*.tiff", QDir::Files, QDir::Name);
+    for (const QFileInfo& file : files) {
+        QImage image(file.absoluteFilePath());
+        if (!image.isNull()) images.append(image);
+    }
+    if (images.isEmpty()) {
+        fprintf(stderr, "no images in %s\n", qPrintable(args.at(1)));
+        return 1;
+    }
+
+    printf("images: %d  rounds: %d  lang: %s  libtesseract: %s\n",
+           images.size(), rounds, qPrintable(lang), TesseractEnginePool::available() ? "yes" : "no (process mode)");
+    printf("%6s %8s %10s %10s %8s\n", "pool", "pages", "seconds", "pages/s", "speedup");
+
+    double baseline = 0.0;
+    for (const QString& sizeText : sizeList) {
+        const int poolSize = qMax(1, sizeText.toInt());
+
+        ModelConfig config;
+        config.id = "bench_tesseract";
+        config.displayName = "Tesseract";
+        config.type = "local";
+        config.engine = "tesseract";
+        config.params["lang"] = lang;
+        config.params["pool_size"] = QString::number(poolSize);
+
+        TesseractAdapter adapter(config);
+        if (!adapter.initialize()) {
+            fprintf(stderr, "tesseract initialization failed\n");
+            return 1;
+        }
+
+        QThreadPool workers;
+        workers.setMaxThreadCount(poolSize);
+        auto runAll = [&](int count) {
+            QVector<QFuture<OCRResult>> futures;
+            for (int i = 0; i < count; ++i) {
+                const QImage image = images.at(i % images.size());
+                futures.append(QtConcurrent::run(&workers, [&adapter, image]() {
+                    return adapter.recognize(image);
+                }));
+            }
+            int failed = 0;
+            for (QFuture<OCRResult>& future : futures) {
+                if (!future.result().success) failed++;
+            }
+            return failed;
+        };
+
+        // 预热：让池中引擎全部完成初始化，计时只包含识别本身
+        runAll(poolSize);
+
+        const int pages = images.size() * rounds;
+        QElapsedTimer timer;
+        timer.start();
+        const int failed = runAll(pages);
+        const double seconds = timer.elapsed() / 1000.0;
+        const double rate = seconds > 0 ? pages / seconds : 0.0;
+        if (baseline <= 0.0) baseline = rate;
+
+        printf("%6d %8d %10.2f %10.2f %7.2fx%s\n", poolSize, pages, seconds, rate,
+               baseline > 0 ? rate / baseline : 0.0,
+               failed > 0 ? qPrintable(QString("  (%1 failed)").arg(failed)) : "");
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "CascadeAdapter.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+namespace {
+// 区域裁剪时上下左右的留白 (相对行高)，避免笔画被切掉
+const qreal kRegionPadding = 0.25;
+}
+
+CascadeAdapter::CascadeAdapter(const ModelConfig &config, const AdapterResolver &resolver, QObject *parent)
+    : ModelAdapter(config, parent), m_resolver(resolver), m_initialized(false)
+{
+    bool ok = false;
+    m_minConfidence = m_config.params.value("min_confidence").toFloat(&ok);
+    if (!ok || m_minConfidence <= 0.0f) {
+        m_minConfidence = 0.8f;
+    }
+    m_escalateRegions = m_config.params.value("escalate", "image") == "regions";
+    m_maxRegions = m_config.params.value("max_regions", "8").toInt();
+    if (m_maxRegions <= 0) {
+        m_maxRegions = 8;
+    }
+    m_regionPrompt = m_config.params.value("region_prompt",
+        "图片是文档中的一行文字，只输出这一行的文字内容，不要解释，不要换行");
+}
+
+CascadeAdapter::~CascadeAdapter()
+{
+    const int total = m_localAccepted.loadAcquire() + m_regionEscalated.loadAcquire() + m_imageEscalated.loadAcquire();
+    if (total > 0) {
+        qDebug() << "CascadeAdapter:" << m_config.id << "共" << total << "次，本地通过" << m_localAccepted.loadAcquire()
+                 << "区域升级" << m_regionEscalated.loadAcquire() << "整图升级" << m_imageEscalated.loadAcquire();
+    }
+}
+
+ModelAdapter *CascadeAdapter::resolveStage(const QString &paramKey)
+{
+    const QString id = m_config.params.value(paramKey);
+    if (id.isEmpty()) {
+        qWarning() << "CascadeAdapter: 未配置" << paramKey;
+        return nullptr;
+    }
+    if (id == m_config.id) {
+        qWarning() << "CascadeAdapter:" << paramKey << "不能引用自身";
+        return nullptr;
+    }
+
+    ModelAdapter *adapter = m_resolver ? m_resolver(id) : nullptr;
+    if (!adapter) {
+        qWarning() << "CascadeAdapter:" << paramKey << "引用的模型不存在或未启用:" << id;
+        return nullptr;
+    }
+    if (qobject_cast<CascadeAdapter *>(adapter)) {
+        qWarning() << "CascadeAdapter:" << paramKey << "不能引用另一个级联模型:" << id;
+        return nullptr;
+    }
+    // 级联模型可能先于其引用的模型初始化
+    if (!adapter->isInitialized() && !adapter->initialize()) {
+        qWarning() << "CascadeAdapter:" << paramKey << "模型初始化失败:" << id;
+        return nullptr;
+    }
+    return adapter;
+}
+
+bool CascadeAdapter::initialize()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_initialized) {
+        return true;
+    }
+
+    qDebug() << "=== Initializing CascadeAdapter ===" << m_config.id;
+
+    ModelAdapter *local = resolveStage("local_model");
+    ModelAdapter *vlm = resolveStage("vlm_model");
+    if (!local || !vlm) {
+        return false;
+    }
+
+    m_local = local;
+    m_vlm = vlm;
+    m_initialized = true;
+    qDebug() << "CascadeAdapter:" << local->config().displayName << "->" << vlm->config().displayName
+             << "置信度阈值:" << m_minConfidence << "升级方式:" << (m_escalateRegions ? "区域" : "整图");
+    return true;
+}
+
+bool CascadeAdapter::refineRegions(ModelAdapter *vlm, const QImage &image, const QVector<int> &lowLines, OCRResult &result)
+{
+    const qreal w = image.width();
+    const qreal h = image.height();
+    QVector<QRectF> replaced;
+
+    // 逐行串行识别：级联本身运行在流水线的工作线程中，这里再向同一线程池派发任务可能互相等待
+    for (int index : lowLines) {
+        TextBlock &line = result.textBlocks[index];
+        const QRectF &box = line.boundingBox;
+        const qreal pad = box.height() * h * kRegionPadding;
+        const QRect rect = QRectF(box.x() * w - pad, box.y() * h - pad,
+                                  box.width() * w + 2 * pad, box.height() * h + 2 * pad).toAlignedRect()
+                           & image.rect();
+        if (rect.isEmpty()) {
+            continue;
+        }
+
+        const OCRResult region = vlm->recognize(image.copy(rect), m_regionPrompt);
+        if (!region.success) {
+            qWarning() << "CascadeAdapter: 区域识别失败:" << region.errorMessage;
+            return false;
+        }
+        const QString text = region.fullText.simplified();
+        if (text.isEmpty()) {
+            continue;
+        }
+
+        line.text = text;
+        // VLM 不给置信度，复核过的行按刚好通过阈值计，下游按置信度路由时不会再次升级
+        line.confidence = qMax(line.confidence, m_minConfidence);
+        replaced.append(box);
+    }
+
+    // 被替换的行中原有的词级块与新文本不再对应，一并去掉
+    for (int i = result.textBlocks.size() - 1; i >= 0; --i) {
+        const TextBlock &block = result.textBlocks.at(i);
+        if (block.level != TextBlock::Word) continue;
+        for (const QRectF &box : replaced) {
+            if (box.contains(block.boundingBox.center())) {
+                result.textBlocks.remove(i);
+                break;
+            }
+        }
+    }
+    if (!replaced.isEmpty()) {
+        result.mergeFullText();
+    }
+    return true;
+}
+
+OCRResult CascadeAdapter::recognize(const QImage &image, const QString &prompt)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    OCRResult result;
+    result.modelName = m_config.displayName;
+
+    // 引用的模型可能在设置变更时被删除
+    ModelAdapter *local = m_local.data();
+    ModelAdapter *vlm = m_vlm.data();
+    if (!m_initialized || !local || !vlm) {
+        result.success = false;
+        result.errorMessage = "级联模型未初始化";
+        return result;
+    }
+
+    OCRResult first = local->recognize(image, prompt);
+
+    // 统计行级 (没有行时退回整段) 置信度
+    QVector<int> lowLines;
+    bool hasLines = false;
+    bool lowBlocks = false;
+    for (int i = 0; i < first.textBlocks.size(); ++i) {
+        const TextBlock &block = first.textBlocks.at(i);
+        if (block.level == TextBlock::Line) {
+            hasLines = true;
+            if (block.confidence < m_minConfidence) lowLines.append(i);
+        } else if (block.level == TextBlock::Block && block.confidence < m_minConfidence) {
+            lowBlocks = true;
+        }
+    }
+    const bool accepted = first.success && !first.fullText.trimmed().isEmpty()
+                          && (hasLines ? lowLines.isEmpty() : !lowBlocks);
+
+    if (accepted) {
+        m_localAccepted.ref();
+        result = first;
+        result.modelName = QString("%1 (%2)").arg(m_config.displayName, local->config().displayName);
+        result.processingTimeMs = timer.elapsed();
+        return result;
+    }
+
+    if (m_escalateRegions && first.success && hasLines && lowLines.size() <= m_maxRegions) {
+        qDebug() << "CascadeAdapter: 低置信度行" << lowLines.size() << "交给" << vlm->config().displayName;
+        OCRResult refined = first;
+        if (refineRegions(vlm, image, lowLines, refined)) {
+            m_regionEscalated.ref();
+            result = refined;
+            result.modelName = QString("%1 (%2 + %3)").arg(m_config.displayName, local->config().displayName,
+                                                           vlm->config().displayName);
+            result.processingTimeMs = timer.elapsed();
+            return result;
+        }
+    }
+
+    qDebug() << "CascadeAdapter: 本地结果置信度不足，整图交给" << vlm->config().displayName;
+    m_imageEscalated.ref();
+    result = vlm->recognize(image, prompt);
+    if (result.success) {
+        result.modelName = QString("%1 (%2)").arg(m_config.displayName, vlm->config().displayName);
+    } else if (first.success && !first.fullText.trimmed().isEmpty()) {
+        // VLM 不可用时保留本地结果，比直接报错更有用
+        qWarning() << "CascadeAdapter: VLM 识别失败，返回本地结果:" << result.errorMessage;
+        result = first;
+        result.modelName = QString("%1 (%2)").arg(m_config.displayName, local->config().displayName);
+    }
+    result.processingTimeMs = timer.elapsed();
+    return result;
+}
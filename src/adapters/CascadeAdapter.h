@@ -0,0 +1,51 @@
+#pragma once
+#include "../core/ModelAdapter.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPointer>
+#include <functional>
+
+// 级联适配器 (engine = cascade)
+// 先用本地引擎识别，按文本块置信度决定是否升级到 VLM：
+//   - 本地结果的行置信度都不低于 min_confidence 时直接返回，不产生 API 调用
+//   - escalate = regions：只把低置信度的行裁出来交给 VLM 重新识别，替换对应行
+//     (低置信度行超过 max_regions 或本地没有行级结果时退回整图)
+//   - escalate = image (默认)：整张图片交给 VLM
+// 两级模型都引用 models_config.json 中其它模型的 id：
+//   "params": { "local_model": "tesseract_local", "vlm_model": "qwen3_vl_plus", "min_confidence": "0.8" }
+class CascadeAdapter : public ModelAdapter {
+    Q_OBJECT
+
+public:
+    // 按模型 id 查找已创建的适配器
+    typedef std::function<ModelAdapter*(const QString&)> AdapterResolver;
+
+    CascadeAdapter(const ModelConfig& config, const AdapterResolver& resolver, QObject* parent = nullptr);
+    ~CascadeAdapter() override;
+
+    bool initialize() override;
+    OCRResult recognize(const QImage& image, const QString& prompt = QString()) override;
+    bool isInitialized() const override { return m_initialized; }
+    QString typeDescription() const override { return "[级联]"; }
+
+private:
+    // 查找并初始化一级模型
+    ModelAdapter* resolveStage(const QString& paramKey);
+
+    // 只重新识别低置信度的行，成功返回 true
+    bool refineRegions(ModelAdapter* vlm, const QImage& image, const QVector<int>& lowLines, OCRResult& result);
+
+    AdapterResolver m_resolver;
+    QPointer<ModelAdapter> m_local;
+    QPointer<ModelAdapter> m_vlm;
+    bool m_initialized;
+    float m_minConfidence;
+    bool m_escalateRegions;
+    int m_maxRegions;
+    QString m_regionPrompt;
+
+    QAtomicInt m_localAccepted;     // 本地直接通过的次数
+    QAtomicInt m_regionEscalated;   // 按区域升级的次数
+    QAtomicInt m_imageEscalated;    // 整图升级的次数
+    QMutex m_mutex;                 // 保护初始化
+};
@@ -1,4 +1,5 @@
 #include "CustomAdapter.h"
+#include "../core/ImagePayload.h"
 #include <QNetworkRequest>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -469,7 +470,7 @@ OCRResult CustomAdapter::recognize(const QImage &image, const QString &prompt)
             // 编码图片
             qDebug() << "";
             qDebug() << "CustomAdapter: 步骤 1/2: 编码图片为 base64...";
-            imageBase64 = encodeImageToBase64(image);
+            imageBase64 = ImagePayload::base64(image, "base64:png-rgb32", [this, &image]() { return encodeImageToBase64(image); });
             qDebug() << "CustomAdapter: 图片编码完成";
             qDebug() << "CustomAdapter: Base64 长度:" << imageBase64.length() << "字符";
         }
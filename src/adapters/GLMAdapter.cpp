@@ -1,4 +1,5 @@
 #include "GLMAdapter.h"
+#include "../core/ImagePayload.h"
 #include <QNetworkRequest>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -135,7 +136,7 @@ OCRResult GLMAdapter::recognize(const QImage &image, const QString &prompt)
     // 编码图片
     QString imageBase64;
     if (hasValidImage) {
-        imageBase64 = encodeImageToBase64(image);
+        imageBase64 = ImagePayload::base64(image, "base64:png", [this, &image]() { return encodeImageToBase64(image); });
         if (imageBase64.isEmpty()) {
             result.success = false;
             result.errorMessage = "图片编码失败";
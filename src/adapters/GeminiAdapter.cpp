@@ -1,4 +1,5 @@
 #include "GeminiAdapter.h"
+#include "../core/ImagePayload.h"
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QJsonDocument>
@@ -169,7 +170,7 @@ OCRResult GeminiAdapter::recognize(const QImage& image, const QString& prompt)
     bool hasValidImage = !image.isNull() && image.width() > 0 && image.height() > 0;
     QString imageBase64;
     if (hasValidImage) {
-        imageBase64 = encodeImageToBase64(image);
+        imageBase64 = ImagePayload::base64(image, "base64:auto", [this, &image]() { return encodeImageToBase64(image); });
     }
 
     QString errorMsg;
@@ -1,4 +1,5 @@
 #include "PaddleAdapter.h"
+#include "../core/ImagePayload.h"
 #include <QNetworkRequest>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -94,7 +95,7 @@ OCRResult PaddleAdapter::recognize(const QImage &image, const QString &prompt)
     }
     
     // 编码图片
-    QString imageBase64 = encodeImageToBase64(image);
+    QString imageBase64 = ImagePayload::base64(image, "base64:png", [this, &image]() { return encodeImageToBase64(image); });
     if (imageBase64.isEmpty()) {
         result.success = false;
         result.errorMessage = "图片编码失败";
@@ -0,0 +1,503 @@
+#include "PaddleOnnxAdapter.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTransform>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#ifdef XS_HAVE_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#endif
+
+namespace {
+float paramFloat(const QMap<QString, QString>& params, const QString& key, float defaultValue)
+{
+    bool ok = false;
+    const float value = params.value(key).toFloat(&ok);
+    return ok && value > 0.0f ? value : defaultValue;
+}
+
+#ifdef XS_HAVE_ONNXRUNTIME
+const int kRecHeight = 48;          // 识别 / 方向分类输入高度
+const int kRecBaseWidth = 320;      // 识别输入的最小宽度
+const int kClsWidth = 192;          // 方向分类输入宽度
+const int kClsBatch = 6;
+const float kClsThresh = 0.9f;      // 判为倒置所需的最低概率
+
+const float kDetMean[3] = { 0.485f, 0.456f, 0.406f };
+const float kDetStd[3] = { 0.229f, 0.224f, 0.225f };
+const float kHalf[3] = { 0.5f, 0.5f, 0.5f };
+
+// 归一化写入 CHW 张量，通道为 BGR 顺序 (与 PaddleOCR 用 OpenCV 读图训练时一致)
+// 张量为 3 x tensorHeight x tensorWidth，图像未覆盖的位置保持调用方预先填充的值 (补零)
+void fillTensor(const QImage& image, float* tensor, int tensorWidth, int tensorHeight,
+                const float mean[3], const float stdv[3])
+{
+    const QImage rgb = image.format() == QImage::Format_RGB888 ? image : image.convertToFormat(QImage::Format_RGB888);
+    const int w = qMin(rgb.width(), tensorWidth);
+    const int h = qMin(rgb.height(), tensorHeight);
+    const int plane = tensorWidth * tensorHeight;
+
+    // (v / 255 - mean) / std = v * scale - shift
+    float scale[3];
+    float shift[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = 1.0f / (255.0f * stdv[c]);
+        shift[c] = mean[c] / stdv[c];
+    }
+    for (int y = 0; y < h; ++y) {
+        const uchar* line = rgb.constScanLine(y);
+        float* b = tensor + y * tensorWidth;
+        float* g = b + plane;
+        float* r = g + plane;
+        for (int x = 0; x < w; ++x) {
+            const uchar* px = line + x * 3;
+            b[x] = px[2] * scale[0] - shift[0];
+            g[x] = px[1] * scale[1] - shift[1];
+            r[x] = px[0] * scale[2] - shift[2];
+        }
+    }
+}
+
+// 按高度缩放到 kRecHeight，宽度按比例并限制在 maxWidth 以内
+QImage scaleToHeight(const QImage& crop, int maxWidth)
+{
+    const int width = qBound(1, int(std::ceil(kRecHeight * double(crop.width()) / crop.height())), maxWidth);
+    return crop.scaled(width, kRecHeight, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+#endif
+}
+
+#ifdef XS_HAVE_ONNXRUNTIME
+struct PaddleOnnxAdapter::Sessions {
+    Ort::Env env;
+    Ort::SessionOptions options;
+    std::unique_ptr<Ort::Session> det;
+    std::unique_ptr<Ort::Session> cls;      // 可选
+    std::unique_ptr<Ort::Session> rec;
+    std::string detInput, detOutput;
+    std::string clsInput, clsOutput;
+    std::string recInput, recOutput;
+    Ort::MemoryInfo memory;
+
+    Sessions()
+        : env(ORT_LOGGING_LEVEL_WARNING, "xs-vlm-ocr"),
+          memory(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault))
+    {
+    }
+
+    std::unique_ptr<Ort::Session> open(const QString& path, std::string& inputName, std::string& outputName)
+    {
+#ifdef Q_OS_WIN
+        const std::wstring file = path.toStdWString();
+#else
+        const std::string file = QFile::encodeName(path).toStdString();
+#endif
+        std::unique_ptr<Ort::Session> session(new Ort::Session(env, file.c_str(), options));
+        Ort::AllocatorWithDefaultOptions allocator;
+        inputName = session->GetInputNameAllocated(0, allocator).get();
+        outputName = session->GetOutputNameAllocated(0, allocator).get();
+        return session;
+    }
+
+    // 单输入单输出推理；Session::Run 可被多个线程同时调用
+    std::vector<Ort::Value> run(Ort::Session& session, const std::string& inputName, const std::string& outputName,
+                                std::vector<float>& data, const std::vector<int64_t>& shape)
+    {
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory, data.data(), data.size(), shape.data(), shape.size());
+        const char* inputNames[] = { inputName.c_str() };
+        const char* outputNames[] = { outputName.c_str() };
+        return session.Run(Ort::RunOptions{ nullptr }, inputNames, &input, 1, outputNames, 1);
+    }
+};
+#else
+struct PaddleOnnxAdapter::Sessions {
+};
+#endif
+
+PaddleOnnxAdapter::PaddleOnnxAdapter(const ModelConfig &config, QObject *parent)
+    : ModelAdapter(config, parent), m_initialized(false)
+{
+    // 多个识别任务会并发推理，默认每次推理只用一半核心，避免线程过度订阅
+    m_threads = m_config.params.value("threads", "0").toInt();
+    if (m_threads <= 0) {
+        m_threads = qMax(1, QThread::idealThreadCount() / 2);
+    }
+    m_recBatch = qMax(1, m_config.params.value("rec_batch", "6").toInt());
+    m_detLimitSide = qMax(32, m_config.params.value("det_limit_side", "960").toInt());
+    m_detThresh = paramFloat(m_config.params, "det_thresh", 0.3f);
+    m_boxThresh = paramFloat(m_config.params, "box_thresh", 0.6f);
+    m_unclipRatio = paramFloat(m_config.params, "unclip_ratio", 1.5f);
+    m_dropScore = paramFloat(m_config.params, "drop_score", 0.5f);
+    // 流水线攒批：同时到达的多张图片合并为一次 recognizeBatch()，文本行跨图片分批识别
+    m_batchSize = qMax(1, m_config.params.value("batch_size", "4").toInt());
+}
+
+PaddleOnnxAdapter::~PaddleOnnxAdapter()
+{
+}
+
+QString PaddleOnnxAdapter::modelPath(const QString &key, const QString &fileName) const
+{
+    // 相对路径以程序目录为基准
+    const QDir appDir(QCoreApplication::applicationDirPath());
+    const QString dir = appDir.filePath(m_config.params.value("model_dir", "models/ppocrv4"));
+    const QString configured = m_config.params.value(key);
+    if (configured.isEmpty()) {
+        return QDir(dir).filePath(fileName);
+    }
+    return QFileInfo(configured).isAbsolute() ? configured : QDir(dir).filePath(configured);
+}
+
+bool PaddleOnnxAdapter::initialize()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_initialized) {
+        return true;
+    }
+
+    qDebug() << "=== Initializing PaddleOnnxAdapter ===";
+
+#ifdef XS_HAVE_ONNXRUNTIME
+    const QString detPath = modelPath("det_model", "det.onnx");
+    const QString recPath = modelPath("rec_model", "rec.onnx");
+    const QString clsPath = modelPath("cls_model", "cls.onnx");
+    const QString dictPath = modelPath("rec_dict", "ppocr_keys_v1.txt");
+    for (const QString &path : { detPath, recPath, dictPath }) {
+        if (!QFileInfo::exists(path)) {
+            qWarning() << "PaddleOnnxAdapter: 模型文件不存在:" << path;
+            return false;
+        }
+    }
+
+    QFile dictFile(dictPath);
+    if (!dictFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "PaddleOnnxAdapter: 无法读取字典:" << dictPath;
+        return false;
+    }
+    QStringList dict = QString::fromUtf8(dictFile.readAll()).split('\n');
+    for (QString &entry : dict) {
+        if (entry.endsWith('\r')) entry.chop(1);
+    }
+    while (!dict.isEmpty() && dict.last().isEmpty()) {
+        dict.removeLast();
+    }
+
+    try {
+        std::unique_ptr<Sessions> sessions(new Sessions());
+        sessions->options.SetIntraOpNumThreads(m_threads);
+        sessions->options.SetInterOpNumThreads(1);
+        sessions->options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        sessions->det = sessions->open(detPath, sessions->detInput, sessions->detOutput);
+        sessions->rec = sessions->open(recPath, sessions->recInput, sessions->recOutput);
+        if (m_config.params.value("use_cls", "true") != "false" && QFileInfo::exists(clsPath)) {
+            sessions->cls = sessions->open(clsPath, sessions->clsInput, sessions->clsOutput);
+        }
+        m_sessions = std::move(sessions);
+    } catch (const Ort::Exception &e) {
+        qWarning() << "PaddleOnnxAdapter: 加载模型失败:" << e.what();
+        return false;
+    }
+
+    m_dict = dict;
+    m_initialized = true;
+    qDebug() << "PaddleOnnxAdapter: ONNX Runtime" << OrtGetApiBase()->GetVersionString()
+             << "字典" << m_dict.size() << "字" << "方向分类:" << (m_sessions->cls ? "开启" : "关闭")
+             << "推理线程:" << m_threads << "识别批大小:" << m_recBatch;
+    return true;
+#else
+    qWarning() << "PaddleOnnxAdapter: 未编译 ONNX Runtime 支持，请使用 -DXS_WITH_ONNXRUNTIME=ON 重新构建";
+    return false;
+#endif
+}
+
+QVector<QRect> PaddleOnnxAdapter::detect(const QImage &image)
+{
+    QVector<QRect> boxes;
+#ifdef XS_HAVE_ONNXRUNTIME
+    // 长边不超过 det_limit_side，宽高取 32 的倍数
+    const int w = image.width();
+    const int h = image.height();
+    const double ratio = qMax(w, h) > m_detLimitSide ? double(m_detLimitSide) / qMax(w, h) : 1.0;
+    const int dw = qMax(32, qRound(w * ratio / 32.0) * 32);
+    const int dh = qMax(32, qRound(h * ratio / 32.0) * 32);
+
+    std::vector<float> input(size_t(3) * dw * dh, 0.0f);
+    fillTensor(image.scaled(dw, dh, Qt::IgnoreAspectRatio, Qt::SmoothTransformation),
+               input.data(), dw, dh, kDetMean, kDetStd);
+    std::vector<Ort::Value> outputs = m_sessions->run(*m_sessions->det, m_sessions->detInput, m_sessions->detOutput,
+                                                      input, { 1, 3, dh, dw });
+    const std::vector<int64_t> shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+    if (shape.size() != 4 || shape[2] != dh || shape[3] != dw) {
+        qWarning() << "PaddleOnnxAdapter: 检测模型输出尺寸不符";
+        return boxes;
+    }
+    const float *prob = outputs[0].GetTensorData<float>();
+
+    // 概率图二值化后按 8 邻域连通域取外接矩形
+    const double sx = double(w) / dw;
+    const double sy = double(h) / dh;
+    std::vector<uchar> visited(size_t(dw) * dh, 0);
+    std::vector<int> stack;
+    for (int start = 0; start < dw * dh; ++start) {
+        if (visited[start] || prob[start] <= m_detThresh) continue;
+        visited[start] = 1;
+        stack.assign(1, start);
+        int minX = dw, minY = dh, maxX = -1, maxY = -1;
+        double sum = 0.0;
+        int count = 0;
+        while (!stack.empty()) {
+            const int index = stack.back();
+            stack.pop_back();
+            const int x = index % dw;
+            const int y = index / dw;
+            minX = qMin(minX, x);
+            maxX = qMax(maxX, x);
+            minY = qMin(minY, y);
+            maxY = qMax(maxY, y);
+            sum += prob[index];
+            ++count;
+            for (int ny = qMax(0, y - 1); ny <= qMin(dh - 1, y + 1); ++ny) {
+                for (int nx = qMax(0, x - 1); nx <= qMin(dw - 1, x + 1); ++nx) {
+                    const int n = ny * dw + nx;
+                    if (!visited[n] && prob[n] > m_detThresh) {
+                        visited[n] = 1;
+                        stack.push_back(n);
+                    }
+                }
+            }
+        }
+
+        const int bw = maxX - minX + 1;
+        const int bh = maxY - minY + 1;
+        if (qMin(bw, bh) < 3 || sum / count < m_boxThresh) continue;
+
+        // DB 预测的是收缩后的文字核心区，按 面积 * unclip_ratio / 周长 向外扩回
+        const double distance = double(bw) * bh * m_unclipRatio / (2.0 * (bw + bh));
+        const QRectF box((minX - distance) * sx, (minY - distance) * sy,
+                         (bw + 2 * distance) * sx, (bh + 2 * distance) * sy);
+        const QRect rect = box.toAlignedRect() & image.rect();
+        if (rect.width() > 3 && rect.height() > 3) {
+            boxes.append(rect);
+        }
+    }
+
+    // 阅读顺序：从上到下，同一行 (上沿相差不足 10 像素) 从左到右
+    std::sort(boxes.begin(), boxes.end(), [](const QRect &a, const QRect &b) {
+        return a.top() != b.top() ? a.top() < b.top() : a.left() < b.left();
+    });
+    for (int i = 0; i + 1 < boxes.size(); ++i) {
+        for (int j = i; j >= 0; --j) {
+            if (qAbs(boxes[j + 1].top() - boxes[j].top()) < 10 && boxes[j + 1].left() < boxes[j].left()) {
+                std::swap(boxes[j], boxes[j + 1]);
+            } else {
+                break;
+            }
+        }
+    }
+#else
+    Q_UNUSED(image);
+#endif
+    return boxes;
+}
+
+void PaddleOnnxAdapter::classify(QVector<TextLine> &lines)
+{
+#ifdef XS_HAVE_ONNXRUNTIME
+    if (!m_sessions->cls) return;
+
+    const size_t stride = size_t(3) * kRecHeight * kClsWidth;
+    for (int begin = 0; begin < lines.size(); begin += kClsBatch) {
+        const int count = qMin(kClsBatch, lines.size() - begin);
+        std::vector<float> input(stride * count, 0.0f);
+        for (int i = 0; i < count; ++i) {
+            fillTensor(scaleToHeight(lines[begin + i].crop, kClsWidth), input.data() + stride * i,
+                       kClsWidth, kRecHeight, kHalf, kHalf);
+        }
+        std::vector<Ort::Value> outputs = m_sessions->run(*m_sessions->cls, m_sessions->clsInput, m_sessions->clsOutput,
+                                                          input, { count, 3, kRecHeight, kClsWidth });
+        const float *prob = outputs[0].GetTensorData<float>();
+        // 两类：0° / 180°
+        for (int i = 0; i < count; ++i) {
+            if (prob[i * 2 + 1] > prob[i * 2] && prob[i * 2 + 1] > kClsThresh) {
+                TextLine &line = lines[begin + i];
+                line.crop = line.crop.transformed(QTransform().rotate(180));
+            }
+        }
+    }
+#else
+    Q_UNUSED(lines);
+#endif
+}
+
+void PaddleOnnxAdapter::recognizeLines(QVector<TextLine> &lines)
+{
+#ifdef XS_HAVE_ONNXRUNTIME
+    // 按宽高比排序，同一批宽度相近，补零更少
+    QVector<int> order;
+    order.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i) order.append(i);
+    std::sort(order.begin(), order.end(), [&lines](int a, int b) {
+        const QImage &ca = lines.at(a).crop;
+        const QImage &cb = lines.at(b).crop;
+        return double(ca.width()) / ca.height() < double(cb.width()) / cb.height();
+    });
+
+    for (int begin = 0; begin < order.size(); begin += m_recBatch) {
+        const int count = qMin(m_recBatch, order.size() - begin);
+
+        // 同批统一宽度：取最宽的宽高比，且不小于 320 / 48
+        double maxRatio = double(kRecBaseWidth) / kRecHeight;
+        for (int i = 0; i < count; ++i) {
+            const QImage &crop = lines.at(order[begin + i]).crop;
+            maxRatio = qMax(maxRatio, double(crop.width()) / crop.height());
+        }
+        const int width = int(std::ceil(kRecHeight * maxRatio));
+        const size_t stride = size_t(3) * kRecHeight * width;
+        std::vector<float> input(stride * count, 0.0f);
+        for (int i = 0; i < count; ++i) {
+            fillTensor(scaleToHeight(lines.at(order[begin + i]).crop, width), input.data() + stride * i,
+                       width, kRecHeight, kHalf, kHalf);
+        }
+
+        std::vector<Ort::Value> outputs = m_sessions->run(*m_sessions->rec, m_sessions->recInput, m_sessions->recOutput,
+                                                          input, { count, 3, kRecHeight, width });
+        const std::vector<int64_t> shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() != 3 || shape[0] != count) {
+            qWarning() << "PaddleOnnxAdapter: 识别模型输出尺寸不符";
+            continue;
+        }
+        const int steps = int(shape[1]);
+        const int classes = int(shape[2]);
+        const float *probs = outputs[0].GetTensorData<float>();
+
+        // CTC 贪心解码：逐步取最大类，去掉 blank (0) 与连续重复
+        for (int i = 0; i < count; ++i) {
+            TextLine &line = lines[order[begin + i]];
+            QString text;
+            float confidenceSum = 0.0f;
+            int kept = 0;
+            int previous = -1;
+            for (int t = 0; t < steps; ++t) {
+                const float *row = probs + (size_t(i) * steps + t) * classes;
+                const int best = int(std::max_element(row, row + classes) - row);
+                if (best != 0 && best != previous) {
+                    text += best - 1 < m_dict.size() ? m_dict.at(best - 1) : QString(" ");
+                    confidenceSum += row[best];
+                    kept++;
+                }
+                previous = best;
+            }
+            line.text = text;
+            line.confidence = kept > 0 ? confidenceSum / kept : 0.0f;
+        }
+    }
+#else
+    Q_UNUSED(lines);
+#endif
+}
+
+OCRResult PaddleOnnxAdapter::recognize(const QImage &image, const QString &prompt)
+{
+    return recognizeBatch(QVector<QImage>() << image, prompt).first();
+}
+
+QVector<OCRResult> PaddleOnnxAdapter::recognizeBatch(const QVector<QImage> &images, const QString &prompt)
+{
+    Q_UNUSED(prompt); // 纯 OCR 模型，不使用提示词
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<OCRResult> results(images.size());
+    for (OCRResult &result : results) {
+        result.modelName = m_config.displayName;
+    }
+
+    if (!m_initialized || !m_sessions) {
+        for (OCRResult &result : results) {
+            result.success = false;
+            result.errorMessage = "PP-OCR 模型未初始化";
+        }
+        return results;
+    }
+
+    try {
+        // 检测逐张进行 (输入尺寸各不相同)；各图的文本行合并后统一分批做方向分类与识别
+        QVector<QImage> rgbImages(images.size());
+        QVector<TextLine> lines;
+        QVector<int> owners;    // 每行所属的图片下标
+        int boxCount = 0;
+        for (int i = 0; i < images.size(); ++i) {
+            if (images.at(i).isNull()) {
+                results[i].success = false;
+                results[i].errorMessage = "Invalid image";
+                continue;
+            }
+            rgbImages[i] = images.at(i).convertToFormat(QImage::Format_RGB888);
+            const QVector<QRect> boxes = detect(rgbImages.at(i));
+            boxCount += boxes.size();
+            for (const QRect &rect : boxes) {
+                TextLine line;
+                line.rect = rect;
+                line.crop = rgbImages.at(i).copy(rect);
+                // 竖排文本 (高 ≥ 1.5 倍宽) 逆时针转正，与 PaddleOCR 一致
+                if (line.crop.height() >= line.crop.width() * 1.5) {
+                    line.crop = line.crop.transformed(QTransform().rotate(-90));
+                }
+                lines.append(line);
+                owners.append(i);
+            }
+            results[i].success = true;
+        }
+        const qint64 detectMs = timer.elapsed();
+
+        classify(lines);
+        recognizeLines(lines);
+
+        for (int k = 0; k < lines.size(); ++k) {
+            const TextLine &line = lines.at(k);
+            const QString text = line.text.trimmed();
+            if (text.isEmpty() || line.confidence < m_dropScore) continue;
+            const QImage &rgb = rgbImages.at(owners.at(k));
+            const qreal w = rgb.width();
+            const qreal h = rgb.height();
+            TextBlock block;
+            block.text = text;
+            block.boundingBox = QRectF(line.rect.x() / w, line.rect.y() / h, line.rect.width() / w, line.rect.height() / h);
+            block.confidence = line.confidence;
+            block.level = TextBlock::Line;
+            results[owners.at(k)].textBlocks.append(block);
+        }
+
+        // 同批结果同时完成，耗时按整批计
+        const qint64 elapsed = timer.elapsed();
+        for (OCRResult &result : results) {
+            if (!result.success) continue;
+            result.mergeFullText();
+            result.processingTimeMs = elapsed;
+        }
+
+        qDebug() << "PaddleOnnxAdapter: 图片" << images.size() << "文本框" << boxCount
+                 << "检测" << detectMs << "ms 总计" << elapsed << "ms";
+    } catch (const std::exception &e) {
+        const QString errorMessage = QString("ONNX Runtime 推理失败: %1").arg(e.what());
+        qWarning() << "PaddleOnnxAdapter:" << errorMessage;
+        for (OCRResult &result : results) {
+            result.success = false;
+            result.errorMessage = errorMessage;
+            result.textBlocks.clear();
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "../core/ModelAdapter.h"
+#include <QMutex>
+#include <QRect>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+// 本地 PP-OCR 适配器 (engine = paddle_onnx)
+// 基于 ONNX Runtime CPU 推理 PP-OCRv4 的 检测 (DB) → 方向分类 (可选) → 识别 (SVTR, CTC) 三个模型，完全离线：
+//   - 检测：概率图二值化后按连通域取外接矩形并按 DB 的 unclip 比例外扩 (不依赖 OpenCV，只支持水平/竖直文本框)
+//   - 识别：文本行按宽高比排序后分批 (rec_batch) 送入，同批统一宽度、右侧补零
+//   - 流水线把同时到达的多张图片 (batch_size) 合并为一次 recognizeBatch()，各图的文本行一起分批识别
+//   - 会话可被多个识别任务并发调用；单次推理的线程数由 threads 控制 (intra-op)
+// 模型文件默认位于 <程序目录>/models/ppocrv4/ 下的 det.onnx / rec.onnx / cls.onnx / ppocr_keys_v1.txt，
+// 可用 model_dir 或 det_model / rec_model / cls_model / rec_dict 分别指定；未编译 XS_WITH_ONNXRUNTIME 时初始化失败
+class PaddleOnnxAdapter : public ModelAdapter {
+    Q_OBJECT
+
+public:
+    explicit PaddleOnnxAdapter(const ModelConfig& config, QObject* parent = nullptr);
+    ~PaddleOnnxAdapter() override;
+
+    bool initialize() override;
+    OCRResult recognize(const QImage& image, const QString& prompt = QString()) override;
+    QVector<OCRResult> recognizeBatch(const QVector<QImage>& images, const QString& prompt = QString()) override;
+    int preferredBatchSize() const override { return m_batchSize; }
+    bool isInitialized() const override { return m_initialized; }
+
+private:
+    struct Sessions;    // ONNX Runtime 环境与三个会话，类型不出现在头文件中
+
+    // 文本行：在原图中的区域、识别文本与置信度
+    struct TextLine {
+        QRect rect;
+        QImage crop;
+        QString text;
+        float confidence = 0.0f;
+    };
+
+    // 检测文本框 (原图像素坐标，按阅读顺序排列)
+    QVector<QRect> detect(const QImage& image);
+
+    // 方向分类：识别为倒置的文本行旋转 180°
+    void classify(QVector<TextLine>& lines);
+
+    // 分批识别文本行
+    void recognizeLines(QVector<TextLine>& lines);
+
+    // 模型文件路径：参数 key 优先，否则为 model_dir 下的 fileName
+    QString modelPath(const QString& key, const QString& fileName) const;
+
+    bool m_initialized;
+    std::unique_ptr<Sessions> m_sessions;
+    QStringList m_dict;         // 识别字典，下标 0 为 CTC blank，字典外最后一类为空格
+    int m_threads;              // 单次推理的 intra-op 线程数
+    int m_recBatch;             // 识别批大小 (文本行)
+    int m_batchSize;            // 流水线攒批的图片数
+    int m_detLimitSide;         // 检测输入长边上限
+    float m_detThresh;          // 概率图二值化阈值
+    float m_boxThresh;          // 文本框平均概率阈值
+    float m_unclipRatio;        // 文本框外扩比例
+    float m_dropScore;          // 识别置信度低于此值的行丢弃
+    QMutex m_mutex;             // 保护初始化
+};
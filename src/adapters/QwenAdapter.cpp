@@ -1,4 +1,5 @@
 #include "QwenAdapter.h"
+#include "../core/ImagePayload.h"
 #include <QNetworkRequest>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -523,7 +524,7 @@ OCRResult QwenAdapter::recognize(const QImage &image, const QString &prompt)
             // 编码图片
             qDebug() << "";
             qDebug() << "QwenAdapter: 步骤 1/2: 编码图片为 base64...";
-            imageBase64 = encodeImageToBase64(image);
+            imageBase64 = ImagePayload::base64(image, "base64:auto", [this, &image]() { return encodeImageToBase64(image); });
             qDebug() << "QwenAdapter: 图片编码完成";
             qDebug() << "QwenAdapter: Base64 长度:" << imageBase64.length() << "字符";
             qDebug() << "QwenAdapter: 预计大小:" << (imageBase64.length() / 1024.0) << "KB";
@@ -1,29 +1,209 @@
 #include "TesseractAdapter.h"
 #include <QProcess>
-#include <QTemporaryFile>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QElapsedTimer>
 #include <QBuffer>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
+#include <QThread>
+
+#ifdef XS_HAVE_LIBTESSERACT
+#include <tesseract/baseapi.h>
+#include <tesseract/resultiterator.h>
+#endif
+
+namespace {
+// TSV 中的版面层级：1 页 2 块 3 段 4 行 5 词
+const int kTsvLevelLine = 4;
+const int kTsvLevelWord = 5;
+
+// 单张图片识别的超时
+const int kProcessTimeoutMs = 30000;
+
+// 脚本检测用图的长边上限：OSD 只需看清字形，大图缩小后检测更快
+const int kOsdMaxSide = 1600;
+
+// 脚本检测从未成功过时，连续失败多少次后停止检测
+const int kOsdMaxFailures = 3;
+
+// 语言包对应的书写系统 (与 OSD 输出的脚本名一致)，未列出的按拉丁字母处理
+QString scriptOfLanguage(const QString& code)
+{
+    if (code.startsWith("chi_")) return "Han";
+    if (code.startsWith("jpn")) return "Japanese";
+    if (code.startsWith("kor")) return "Hangul";
+    static const QStringList cyrillic = QStringList() << "rus" << "ukr" << "bel" << "bul" << "srp" << "mkd" << "kaz";
+    if (cyrillic.contains(code)) return "Cyrillic";
+    static const QStringList arabic = QStringList() << "ara" << "fas" << "urd" << "pus";
+    if (arabic.contains(code)) return "Arabic";
+    if (code == "ell" || code == "grc") return "Greek";
+    if (code == "heb" || code == "yid") return "Hebrew";
+    if (code == "tha") return "Thai";
+    if (code == "hin" || code == "mar" || code == "nep" || code == "san") return "Devanagari";
+    return "Latin";
+}
+
+// OSD 的脚本名归并：平假名 / 片假名按日文，Fraktur 按拉丁字母
+QString normalizeScript(const QString& script)
+{
+    if (script == "Hiragana" || script == "Katakana") return "Japanese";
+    if (script == "Korean") return "Hangul";
+    if (script == "Fraktur") return "Latin";
+    return script;
+}
+
+// 解析 "Script: Latin" / "Script confidence: 2.33" 形式的 OSD 输出 (命令行 --psm 0 与工作进程相同)
+bool parseOsd(const QString& output, QString& script, float& confidence)
+{
+    bool found = false;
+    for (const QString& row : output.split('\n'))
+    {
+        const QString line = row.trimmed();
+        if (line.startsWith("Script confidence:"))
+        {
+            confidence = line.mid(line.indexOf(':') + 1).trimmed().toFloat();
+        }
+        else if (line.startsWith("Script:"))
+        {
+            script = line.mid(line.indexOf(':') + 1).trimmed();
+            found = !script.isEmpty();
+        }
+    }
+    return found;
+}
+
+// 进程模式下传给 tesseract 的图片编码：不压缩，管道传输不在乎体积，省去 deflate 耗时
+QByteArray encodeImage(const QImage& image)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG", 100);
+    return data;
+}
+
+QRectF normalizedBox(int left, int top, int width, int height, const QSize& imageSize)
+{
+    if (imageSize.isEmpty()) return QRectF(0, 0, 1, 1);
+    const qreal w = imageSize.width();
+    const qreal h = imageSize.height();
+    return QRectF(left / w, top / h, width / w, height / h) & QRectF(0, 0, 1, 1);
+}
+
+#ifdef XS_HAVE_LIBTESSERACT
+// 遍历识别结果，按指定层级收集文本块 (Tesseract 置信度为 0-100)
+void collectBlocks(tesseract::TessBaseAPI* api, tesseract::PageIteratorLevel level,
+                   TextBlock::Level blockLevel, const QSize& imageSize, QVector<TextBlock>& blocks)
+{
+    tesseract::ResultIterator* it = api->GetIterator();
+    if (!it) return;
+    do {
+        if (it->Empty(level)) continue;
+        char* text = it->GetUTF8Text(level);
+        if (!text) continue;
+        TextBlock block;
+        block.text = QString::fromUtf8(text).trimmed();
+        delete[] text;
+        if (block.text.isEmpty()) continue;
+
+        int left = 0, top = 0, right = 0, bottom = 0;
+        it->BoundingBox(level, &left, &top, &right, &bottom);
+        block.boundingBox = normalizedBox(left, top, right - left, bottom - top, imageSize);
+        block.confidence = qBound(0.0f, it->Confidence(level) / 100.0f, 1.0f);
+        block.level = blockLevel;
+        blocks.append(block);
+    } while (it->Next(level));
+    delete it;
+}
+#endif
+}
 
 TesseractAdapter::TesseractAdapter(const ModelConfig &config, QObject *parent)
     : ModelAdapter(config, parent), m_initialized(false)
 {
     // 从配置中读取语言参数
     m_language = m_config.params.value("lang", "chi_sim+eng");
+    // 自动语言：每张图片先做脚本检测 (OSD)，只加载需要的语言包
+    const QString autoLang = m_config.params.value("auto_lang").toLower();
+    m_autoLanguage = (autoLang == "true" || autoLang == "1") && m_language.contains('+');
+    bool ok = false;
+    m_autoLanguageMinConfidence = m_config.params.value("auto_lang_min_conf").toFloat(&ok);
+    if (!ok || m_autoLanguageMinConfidence < 0.0f)
+    {
+        m_autoLanguageMinConfidence = 1.0f;
+    }
+    // 引擎池大小：每个引擎同时只服务一个线程，默认与 CPU 核心数一致
+    m_poolSize = m_config.params.value("pool_size", "0").toInt();
+    if (m_poolSize <= 0)
+    {
+        m_poolSize = qMax(1, QThread::idealThreadCount());
+    }
+    m_processSlots.reset(new QSemaphore(m_poolSize));
+
+    // 预处理：窄图放大到 800 像素宽以上；未配置 preprocess 时做对比度归一化与纠偏
+    ImagePreprocessor::Options defaults;
+    defaults.contrast = true;
+    defaults.deskew = true;
+    defaults.minWidth = 800;
+    m_preprocess = ImagePreprocessor::fromParams(m_config.params, defaults);
 }
 
 TesseractAdapter::~TesseractAdapter()
 {
 }
 
+bool TesseractAdapter::initializeAPI()
+{
+#ifdef XS_HAVE_LIBTESSERACT
+    // tessdata 目录可在配置中指定，未指定时由 TESSDATA_PREFIX 或库的默认路径决定
+    std::unique_ptr<TesseractEnginePool> pool(
+        new TesseractEnginePool(m_poolSize, m_config.params.value("tessdata").toLocal8Bit()));
+
+    // 预热一个引擎：校验语言数据可用，首张图片不必等待加载
+    {
+        TesseractEnginePool::Lease lease = pool->acquire(m_language);
+        if (!lease.isValid())
+        {
+            qWarning() << "TesseractAdapter: libtesseract 初始化失败，语言:" << m_language;
+            return false;
+        }
+    }
+
+    m_pool = std::move(pool);
+    // OSD 引擎单独成池 (与工作进程的 m_osd 相同)：与识别引擎共用 LRU 时，每次检测都可能淘汰一个识别引擎，
+    // 下一张图片又要重新加载 traineddata；引擎按需创建，未开启自动语言时不占内存
+    m_osdPool.reset(new TesseractEnginePool(m_poolSize, m_config.params.value("tessdata").toLocal8Bit()));
+    qDebug() << "TesseractAdapter: libtesseract" << tesseract::TessBaseAPI::Version()
+             << "已加载，语言:" << m_language << "引擎池上限:" << m_poolSize;
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool TesseractAdapter::initialize()
 {
     QMutexLocker locker(&m_mutex);
 
     qDebug() << "=== Initializing TesseractAdapter ===";
 
+    // 库模式优先：语言数据只加载一次；mode=process 可强制使用命令行
+    if (m_config.params.value("mode") != "process" && initializeAPI())
+    {
+        m_useAPI = true;
+        m_initialized = true;
+        return true;
+    }
+
+    // 常驻工作进程：语言数据只加载一次，不需要 tesseract 命令行
+    if (initializeWorkers())
+    {
+        m_initialized = true;
+        return true;
+    }
+
     // 查找 tesseract 可执行文件
     // Windows: tesseract.exe, Linux/Mac: tesseract
 #ifdef Q_OS_WIN
@@ -92,70 +272,397 @@ bool TesseractAdapter::initialize()
     return true;
 }
 
-QImage TesseractAdapter::preprocessImage(const QImage &image)
+bool TesseractAdapter::initializeWorkers()
 {
-    // 基本预处理：转换为灰度图
-    QImage processed = image.convertToFormat(QImage::Format_Grayscale8);
+    const int count = qMin(m_config.params.value("workers", "0").toInt(), m_poolSize);
+    if (count <= 0)
+    {
+        return false;
+    }
 
-    // 可选：放大小图片以提高识别率
-    if (processed.width() < 800)
+#ifdef Q_OS_WIN
+    const QString exeName = "xs_tesseract_worker.exe";
+#else
+    const QString exeName = "xs_tesseract_worker";
+#endif
+    // 1. 配置指定的路径 2. 程序目录 3. 系统 PATH
+    QString program = m_config.params.value("worker_path");
+    if (program.isEmpty())
     {
-        int scale = 800 / processed.width() + 1;
-        processed = processed.scaled(processed.width() * scale,
-                                     processed.height() * scale,
-                                     Qt::KeepAspectRatio,
-                                     Qt::SmoothTransformation);
+        const QString bundled = QDir(QCoreApplication::applicationDirPath()).filePath(exeName);
+        program = QFileInfo::exists(bundled) ? bundled : QStandardPaths::findExecutable(exeName);
+    }
+    if (program.isEmpty())
+    {
+        qWarning() << "TesseractAdapter: 未找到" << exeName << "，改为每张图片调用 tesseract 命令行";
+        return false;
+    }
+
+    QStringList args;
+    args << "-l" << m_language;
+    const QString tessdata = m_config.params.value("tessdata");
+    if (!tessdata.isEmpty())
+    {
+        args << "--tessdata" << tessdata;
+    }
+
+    std::unique_ptr<TesseractWorkerPool> workers(new TesseractWorkerPool(program, args, count, kProcessTimeoutMs));
+    if (!workers->start())
+    {
+        qWarning() << "TesseractAdapter: 工作进程启动失败，改为每张图片调用 tesseract 命令行";
+        return false;
     }
 
-    return processed;
+    m_workers = std::move(workers);
+    qDebug() << "TesseractAdapter: 常驻工作进程" << program << "上限:" << count << "语言:" << m_language;
+    return true;
 }
 
-QString TesseractAdapter::runTesseractCommand(const QString &imagePath, const QString &lang)
+ImagePreprocessor::Result TesseractAdapter::preprocessImage(const QImage &image)
 {
-    QProcess process;
+    // 灰度化、小图放大，以及参数 preprocess 选择的步骤 (默认 对比度归一化 + 纠偏)
+    const ImagePreprocessor::Result prepared = ImagePreprocessor::process(image, m_preprocess);
+    if (!qFuzzyIsNull(prepared.rotation) || prepared.crop.size() != image.size())
+    {
+        qDebug() << "TesseractAdapter: 预处理 裁剪" << prepared.crop << "旋转" << prepared.rotation << "度";
+    }
+    return prepared;
+}
 
-    // tesseract input.png stdout -l chi_sim+eng
-    QStringList args;
-    args << imagePath << "stdout" << "-l" << lang;
+QByteArray TesseractAdapter::runProcess(const QStringList &args, const QByteArray &input, QString &errorMsg)
+{
+    // 同时运行的进程数不超过 pool_size
+    m_processSlots->acquire();
+    QSemaphoreReleaser slot(m_processSlots.get());
+
+    QProcess process;
 
     qDebug() << "Running tesseract:" << m_tesseractPath << args.join(" ");
 
     process.start(m_tesseractPath, args);
+    if (!process.waitForStarted(5000))
+    {
+        errorMsg = QString("无法启动 tesseract: %1").arg(process.errorString());
+        qWarning() << "TesseractAdapter:" << errorMsg;
+        return QByteArray();
+    }
+    process.write(input);
+    process.closeWriteChannel();
 
-    if (!process.waitForFinished(30000))
-    { // 30秒超时
-        qWarning() << "Tesseract process timeout";
+    if (!process.waitForFinished(kProcessTimeoutMs))
+    {
+        errorMsg = "Tesseract process timeout";
+        qWarning() << errorMsg;
         process.kill();
-        return QString();
+        process.waitForFinished(1000);
+        return QByteArray();
     }
 
-    if (process.exitCode() != 0)
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
     {
         QString errorOutput = QString::fromUtf8(process.readAllStandardError());
         qWarning() << "Tesseract error (exit code" << process.exitCode() << "):" << errorOutput;
+        errorMsg = QString("Tesseract 识别失败: %1").arg(errorOutput.trimmed());
+        return QByteArray();
+    }
+
+    return process.readAllStandardOutput();
+}
+
+QString TesseractAdapter::runTesseractCommand(const QByteArray &encoded, const QString &lang,
+                                              const QSize &imageSize, QVector<TextBlock> &blocks, QString &errorMsg)
+{
+    // tesseract stdin stdout -l chi_sim+eng tsv
+    // 图片从标准输入读入、TSV 写到标准输出，不落盘；文本由 TSV 的行拼出，不需要再输出一份 txt
+    QStringList args;
+    args << "stdin" << "stdout" << "-l" << lang << "tsv";
+
+    const QByteArray tsv = runProcess(args, encoded, errorMsg);
+    if (!errorMsg.isEmpty())
+    {
         return QString();
     }
 
-    QString result = QString::fromUtf8(process.readAllStandardOutput());
-    qDebug() << "Tesseract output length:" << result.length();
+    QString result;
+    blocks = parseTsv(QString::fromUtf8(tsv), imageSize, &result);
+
+    qDebug() << "Tesseract output length:" << result.length() << "blocks:" << blocks.size();
 
     return result;
 }
 
-QString TesseractAdapter::runTesseractAPI(const QImage &image, const QString &lang)
+QString TesseractAdapter::runTesseractWorker(const QByteArray &encoded, const QString &lang,
+                                             const QSize &imageSize, QVector<TextBlock> &blocks, QString &errorMsg)
 {
-    // TODO: 如果链接了 libtesseract，在这里使用 API
-    // 这里暂时返回空，表示未实现
+    // 工作进程池内部排队，同时识别的图片数不超过 workers
+    const QByteArray tsv = m_workers->recognize(lang, encoded, errorMsg);
+    if (!errorMsg.isEmpty())
+    {
+        return QString();
+    }
+
+    QString result;
+    blocks = parseTsv(QString::fromUtf8(tsv), imageSize, &result);
+    return result;
+}
+
+QVector<TextBlock> TesseractAdapter::parseTsv(const QString &tsv, const QSize &imageSize, QString *text)
+{
+    // 列: level page_num block_num par_num line_num word_num left top width height conf text
+    // 行记录的 conf 为 -1，取其中各词置信度的平均值
+    QVector<TextBlock> blocks;
+    int lineIndex = -1;
+    float lineConfSum = 0.0f;
+    int lineWordCount = 0;
+    QStringList lineWords;
+    QString paragraph;          // 当前行所在段落 (块号 + 段号)
+    QString lastParagraph;
+    QStringList textLines;
+
+    auto finishLine = [&]() {
+        if (lineIndex < 0) return;
+        if (lineWords.isEmpty())
+        {
+            blocks.remove(lineIndex);
+        }
+        else
+        {
+            blocks[lineIndex].text = lineWords.join(' ');
+            blocks[lineIndex].confidence = lineWordCount > 0 ? lineConfSum / lineWordCount : 0.0f;
+            // 与 tesseract 的 txt 输出一致：段落之间空一行
+            if (!textLines.isEmpty() && paragraph != lastParagraph) textLines.append(QString());
+            textLines.append(blocks[lineIndex].text);
+            lastParagraph = paragraph;
+        }
+        lineIndex = -1;
+        lineConfSum = 0.0f;
+        lineWordCount = 0;
+        lineWords.clear();
+    };
+
+    const QStringList rows = tsv.split('\n');
+    for (int i = 1; i < rows.size(); ++i) // 跳过表头
+    {
+        const QStringList cols = rows.at(i).split('\t');
+        if (cols.size() < 11) continue;
+        const int level = cols.at(0).toInt();
+        if (level != kTsvLevelLine && level != kTsvLevelWord) continue;
+
+        TextBlock block;
+        block.boundingBox = normalizedBox(cols.at(6).toInt(), cols.at(7).toInt(),
+                                          cols.at(8).toInt(), cols.at(9).toInt(), imageSize);
+        if (level == kTsvLevelLine)
+        {
+            finishLine();
+            paragraph = cols.at(2) + QLatin1Char('.') + cols.at(3);
+            block.level = TextBlock::Line;
+            lineIndex = blocks.size();
+            blocks.append(block);
+            continue;
+        }
+
+        block.text = cols.size() > 11 ? cols.at(11).trimmed() : QString();
+        if (block.text.isEmpty()) continue;
+        block.level = TextBlock::Word;
+        block.confidence = qBound(0.0f, cols.at(10).toFloat() / 100.0f, 1.0f);
+        blocks.append(block);
+        if (lineIndex >= 0)
+        {
+            lineWords.append(block.text);
+            lineConfSum += block.confidence;
+            lineWordCount++;
+        }
+    }
+    finishLine();
+    if (text)
+    {
+        *text = textLines.join('\n');
+    }
+    return blocks;
+}
+
+QString TesseractAdapter::runTesseractAPI(const QImage &image, const QString &lang, QVector<TextBlock> &blocks, QString &errorMsg)
+{
+#ifdef XS_HAVE_LIBTESSERACT
+    if (!m_pool)
+    {
+        errorMsg = "libtesseract 未初始化";
+        return QString();
+    }
+
+    // 借一个空闲引擎，全部忙碌时等待；租约析构时归还
+    TesseractEnginePool::Lease lease = m_pool->acquire(lang);
+    if (!lease.isValid())
+    {
+        errorMsg = "Tesseract 引擎初始化失败";
+        return QString();
+    }
+    tesseract::TessBaseAPI* api = lease.api();
+
+    // 预处理后为 8 位灰度图，按扫描行直接交给 Tesseract，不做编码与落盘
+    const QImage gray = image.format() == QImage::Format_Grayscale8
+        ? image
+        : image.convertToFormat(QImage::Format_Grayscale8);
+    api->SetImage(gray.constBits(), gray.width(), gray.height(), 1, gray.bytesPerLine());
+    api->SetSourceResolution(300);
+
+    if (api->Recognize(nullptr) != 0)
+    {
+        errorMsg = "Tesseract 识别失败";
+        api->Clear();
+        return QString();
+    }
+    char* text = api->GetUTF8Text();
+    if (!text)
+    {
+        errorMsg = "Tesseract 识别失败";
+        api->Clear();
+        return QString();
+    }
+    const QString result = QString::fromUtf8(text);
+    delete[] text;
+
+    // 同一次识别的版面结果：先所有行，再所有词
+    collectBlocks(api, tesseract::RIL_TEXTLINE, TextBlock::Line, gray.size(), blocks);
+    collectBlocks(api, tesseract::RIL_WORD, TextBlock::Word, gray.size(), blocks);
+    api->Clear();
+    return result;
+#else
     Q_UNUSED(image);
     Q_UNUSED(lang);
+    Q_UNUSED(blocks);
+    errorMsg = "未编译 libtesseract 支持";
     return QString();
+#endif
+}
+
+QString TesseractAdapter::languagesForScript(const QString &configured, const QString &script)
+{
+    const QString family = normalizeScript(script);
+    if (family.isEmpty() || family == "Common")
+    {
+        return configured;
+    }
+
+    // 拉丁字母页只保留拉丁语言包；其它书写系统保留该系统的语言包，并带上拉丁语言包 (中日韩文档常夹杂英文)
+    const QStringList codes = configured.split('+', Qt::SkipEmptyParts);
+    QStringList matched;
+    QStringList latin;
+    for (const QString &code : codes)
+    {
+        const QString codeScript = scriptOfLanguage(code);
+        if (codeScript == "Latin")
+        {
+            latin << code;
+        }
+        // 汉字为主的日文页也可能被检测为 Han
+        if (codeScript == family || (family == "Han" && codeScript == "Japanese"))
+        {
+            matched << code;
+        }
+    }
+    if (family != "Latin" && !matched.isEmpty())
+    {
+        matched << latin;
+    }
+    return matched.isEmpty() ? configured : matched.join('+');
+}
+
+bool TesseractAdapter::detectScript(const QImage &image, QString &script, float &confidence)
+{
+    // 缩小后检测，字形仍足够清晰
+    QImage small = image;
+    if (qMax(image.width(), image.height()) > kOsdMaxSide)
+    {
+        small = image.scaled(kOsdMaxSide, kOsdMaxSide, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    if (small.format() != QImage::Format_Grayscale8)
+    {
+        small = small.convertToFormat(QImage::Format_Grayscale8);
+    }
+
+    if (m_useAPI)
+    {
+#ifdef XS_HAVE_LIBTESSERACT
+        if (!m_osdPool)
+        {
+            return false;
+        }
+        TesseractEnginePool::Lease lease = m_osdPool->acquire("osd");
+        if (!lease.isValid())
+        {
+            return false;
+        }
+        tesseract::TessBaseAPI *api = lease.api();
+        api->SetImage(small.constBits(), small.width(), small.height(), 1, small.bytesPerLine());
+        api->SetSourceResolution(300);
+        int orientation = 0;
+        float orientationConfidence = 0.0f;
+        const char *scriptName = nullptr;
+        const bool ok = api->DetectOrientationScript(&orientation, &orientationConfidence, &scriptName, &confidence);
+        api->Clear();
+        if (!ok || !scriptName)
+        {
+            return false;
+        }
+        script = QString::fromLatin1(scriptName);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const QByteArray encoded = encodeImage(small);
+    QString errorMsg;
+    const QByteArray output = m_workers
+        ? m_workers->recognize("osd", encoded, errorMsg)
+        : runProcess(QStringList() << "stdin" << "stdout" << "-l" << "osd" << "--psm" << "0", encoded, errorMsg);
+    if (!errorMsg.isEmpty())
+    {
+        return false;
+    }
+    return parseOsd(QString::fromUtf8(output), script, confidence);
+}
+
+QString TesseractAdapter::selectLanguage(const QImage &image)
+{
+    if (m_osdUnavailable.loadAcquire())
+    {
+        return m_language;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QString script;
+    float confidence = 0.0f;
+    if (!detectScript(image, script, confidence))
+    {
+        // 文字太少时 OSD 也会失败；从未成功过且连续失败才认为缺少 osd.traineddata 并停止检测
+        if (!m_osdWorked.loadAcquire() && m_osdFailures.fetchAndAddOrdered(1) + 1 >= kOsdMaxFailures
+            && m_osdUnavailable.testAndSetOrdered(0, 1))
+        {
+            qWarning() << "TesseractAdapter: 脚本检测不可用 (需要 osd.traineddata)，使用完整语言组合" << m_language;
+        }
+        return m_language;
+    }
+    m_osdWorked.storeRelease(1);
+
+    if (confidence < m_autoLanguageMinConfidence)
+    {
+        qDebug() << "TesseractAdapter: 脚本检测" << script << "置信度" << confidence << "过低，使用" << m_language;
+        return m_language;
+    }
+    const QString lang = languagesForScript(m_language, script);
+    qDebug() << "TesseractAdapter: 脚本检测" << script << "置信度" << confidence
+             << "语言:" << lang << "耗时" << timer.elapsed() << "ms";
+    return lang;
 }
 
 OCRResult TesseractAdapter::recognize(const QImage &image, const QString &prompt)
 {
     Q_UNUSED(prompt); // Tesseract 不支持 prompt
 
-    QMutexLocker locker(&m_mutex);
+    // 不再整体加锁：库模式各线程从引擎池借用独立引擎，进程模式各自启动进程
     QElapsedTimer timer;
     timer.start();
 
@@ -179,37 +686,48 @@ OCRResult TesseractAdapter::recognize(const QImage &image, const QString &prompt
     try
     {
         // 预处理图像
-        QImage processed = preprocessImage(image);
+        const ImagePreprocessor::Result prepared = preprocessImage(image);
+        const QImage &processed = prepared.image;
 
-        // 保存到临时文件
-        QTemporaryFile tempFile;
-        tempFile.setAutoRemove(true);
-        tempFile.setFileTemplate(QDir::temp().filePath("vlm_ocr_XXXXXX.png"));
+        // 多语言组合按脚本检测结果缩小 (如纯英文页只加载 eng)
+        const QString lang = m_autoLanguage ? selectLanguage(processed) : m_language;
 
-        if (!tempFile.open())
+        QString text;
+        QVector<TextBlock> blocks;
+        if (m_useAPI)
         {
-            result.success = false;
-            result.errorMessage = "Failed to create temp file";
-            qWarning() << "Failed to create temp file";
-            return result;
+            QString errorMsg;
+            text = runTesseractAPI(processed, lang, blocks, errorMsg);
+            if (!errorMsg.isEmpty())
+            {
+                result.success = false;
+                result.errorMessage = errorMsg;
+                return result;
+            }
         }
-
-        QString tempPath = tempFile.fileName();
-        tempFile.close(); // 关闭文件以便 tesseract 可以读取
-
-        if (!processed.save(tempPath, "PNG"))
+        else
         {
-            result.success = false;
-            result.errorMessage = "Failed to save temp image";
-            qWarning() << "Failed to save image to:" << tempPath;
-            return result;
+            // 编码一次，经管道交给常驻工作进程或 tesseract 命令行，不写临时文件
+            const QByteArray encoded = encodeImage(processed);
+            if (encoded.isEmpty())
+            {
+                result.success = false;
+                result.errorMessage = "Failed to encode image";
+                return result;
+            }
+
+            QString errorMsg;
+            text = m_workers
+                ? runTesseractWorker(encoded, lang, processed.size(), blocks, errorMsg)
+                : runTesseractCommand(encoded, lang, processed.size(), blocks, errorMsg);
+            if (!errorMsg.isEmpty())
+            {
+                result.success = false;
+                result.errorMessage = errorMsg;
+                return result;
+            }
         }
 
-        qDebug() << "Temp image saved to:" << tempPath;
-
-        // 调用 tesseract
-        QString text = runTesseractCommand(tempPath, m_language);
-
         // 即使结果为空也不应该报错（可能图片没有文字）
         if (text.isEmpty())
         {
@@ -220,13 +738,19 @@ OCRResult TesseractAdapter::recognize(const QImage &image, const QString &prompt
         result.success = true;
         result.fullText = text.trimmed();
 
-        // 如果有文本，创建文本块
-        if (!result.fullText.isEmpty())
+        // 行/词文本块：坐标从预处理后的图像 (裁剪、旋转、放大) 映射回原图
+        for (TextBlock &block : blocks)
+        {
+            block.boundingBox = prepared.mapToSource(block.boundingBox);
+        }
+        result.textBlocks = blocks;
+        if (result.textBlocks.isEmpty() && !result.fullText.isEmpty())
         {
+            // 未取得版面信息时退回整图一个文本块
             TextBlock block;
             block.text = result.fullText;
             block.boundingBox = QRectF(0, 0, 1, 1); // 整个图像
-            block.confidence = 0.8f;                // Tesseract 默认不返回置信度
+            block.confidence = 0.8f;
             result.textBlocks.append(block);
         }
 
@@ -1,10 +1,23 @@
 #pragma once
 #include "../core/ModelAdapter.h"
+#include "../core/ImagePreprocessor.h"
+#include "TesseractEnginePool.h"
+#include "TesseractWorkerPool.h"
+#include <QAtomicInt>
 #include <QMutex>
+#include <QSemaphore>
+#include <memory>
 
 // Tesseract OCR 适配器
-// 注意：这是一个简化版本，使用命令行调用
-// 生产环境建议使用 libtesseract C++ API
+// 两种运行方式：
+//   - 库模式 (编译选项 XS_WITH_LIBTESSERACT)：引擎池中常驻已初始化的 TessBaseAPI，语言数据只加载一次，
+//     像素直接从 QImage 传入，不经过临时文件；多个识别任务各借一个引擎并行执行
+//   - 进程模式 (未编译库模式、库初始化失败或 mode=process 时)：图片编码后经标准输入传给 tesseract，
+//     TSV 从标准输出读回，不写临时文件；默认每张图片启动一次 tesseract 命令行，
+//     参数 workers > 0 时改为交给常驻的 xs_tesseract_worker 进程 (语言数据只加载一次)，无法启动时退回命令行
+// 并行度由参数 pool_size 控制 (默认 CPU 核心数)，进程模式下同样限制同时运行的进程数
+// 参数 auto_lang 开启时，多语言组合 (如 chi_sim+eng) 按每张图片的脚本检测结果缩小，纯英文页不再加载中文模型；
+// 库模式下不同语言组合的引擎在引擎池中按语言键分别缓存
 class TesseractAdapter : public ModelAdapter {
     Q_OBJECT
     
@@ -17,17 +30,55 @@ public:
     bool isInitialized() const override { return m_initialized; }
     
 private:
-    // 预处理图像（增强OCR效果）
-    QImage preprocessImage(const QImage& image);
+    // 预处理图像（增强OCR效果），结果中记录了坐标变换
+    ImagePreprocessor::Result preprocessImage(const QImage& image);
     
-    // 通过命令行调用 tesseract
-    QString runTesseractCommand(const QString& imagePath, const QString& lang);
+    // 通过命令行调用 tesseract (tesseract stdin stdout tsv)，图片经管道传入，文本由 TSV 版面 (行/词框与置信度) 拼出
+    QString runTesseractCommand(const QByteArray& encoded, const QString& lang,
+                                const QSize& imageSize, QVector<TextBlock>& blocks, QString& errorMsg);
+
+    // 交给常驻工作进程识别，返回内容与命令行相同
+    QString runTesseractWorker(const QByteArray& encoded, const QString& lang,
+                               const QSize& imageSize, QVector<TextBlock>& blocks, QString& errorMsg);
+
+    // 启动常驻工作进程池 (参数 workers / worker_path)
+    bool initializeWorkers();
     
-    // 使用 libtesseract API（如果链接了库）
-    QString runTesseractAPI(const QImage& image, const QString& lang);
+    // 运行一次 tesseract 命令行，input 写入标准输入，返回标准输出；失败返回空并写入 errorMsg
+    QByteArray runProcess(const QStringList& args, const QByteArray& input, QString& errorMsg);
+
+    // 使用 libtesseract API（如果链接了库），失败返回空并写入 errorMsg；行/词文本块写入 blocks
+    QString runTesseractAPI(const QImage& image, const QString& lang, QVector<TextBlock>& blocks, QString& errorMsg);
+
+    // 自动语言：缩小后做脚本检测 (OSD)，从 m_language 中选出最小语言组合；检测失败或置信度过低时返回 m_language
+    QString selectLanguage(const QImage& image);
+
+    // 脚本检测，按当前运行方式走独立的 osd 引擎池、工作进程或命令行 --psm 0
+    bool detectScript(const QImage& image, QString& script, float& confidence);
+
+    // 按检测到的书写系统从语言组合中选出需要的语言包，无法对应时返回完整组合
+    static QString languagesForScript(const QString& configured, const QString& script);
+
+    // 解析 tesseract 的 TSV 输出，坐标按图像尺寸归一化；text 非空时写入按行拼接的全文 (段落之间空一行)
+    static QVector<TextBlock> parseTsv(const QString& tsv, const QSize& imageSize, QString* text = nullptr);
+
+    // 创建引擎池并预热一个引擎（库模式）
+    bool initializeAPI();
     
     bool m_initialized;
+    bool m_useAPI = false;    // 是否使用库模式
+    int m_poolSize;
+    ImagePreprocessor::Options m_preprocess;
+    std::unique_ptr<TesseractEnginePool> m_pool;   // 库模式的引擎池
+    std::unique_ptr<TesseractEnginePool> m_osdPool; // 库模式的脚本检测引擎，只放 "osd"，不参与识别引擎的淘汰
+    std::unique_ptr<QSemaphore> m_processSlots;    // 进程模式的并发名额
+    std::unique_ptr<TesseractWorkerPool> m_workers; // 进程模式的常驻工作进程 (workers > 0)
     QString m_tesseractPath;  // tesseract 可执行文件路径
     QString m_language;       // 语言代码（如 chi_sim, eng）
-    QMutex m_mutex;           // 线程安全
+    bool m_autoLanguage;      // 按脚本检测结果逐张选择语言组合 (参数 auto_lang)
+    float m_autoLanguageMinConfidence;  // 脚本置信度低于此值时使用完整组合 (参数 auto_lang_min_conf)
+    QAtomicInt m_osdWorked;   // 脚本检测是否成功过
+    QAtomicInt m_osdFailures; // 成功之前的失败次数
+    QAtomicInt m_osdUnavailable;  // 缺少 osd.traineddata 等原因，不再检测
+    QMutex m_mutex;           // 保护初始化
 };
\ No newline at end of file
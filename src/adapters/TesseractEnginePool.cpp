@@ -0,0 +1,159 @@
+#include "TesseractEnginePool.h"
+#include <QDebug>
+#include <QElapsedTimer>
+
+#ifdef XS_HAVE_LIBTESSERACT
+#include <tesseract/baseapi.h>
+#endif
+
+TesseractEnginePool::Lease::Lease(TesseractEnginePool* pool, tesseract::TessBaseAPI* api, const QString& lang)
+    : m_pool(pool), m_api(api), m_lang(lang)
+{
+}
+
+TesseractEnginePool::Lease::Lease(Lease&& other)
+    : m_pool(other.m_pool), m_api(other.m_api), m_lang(other.m_lang)
+{
+    other.m_pool = nullptr;
+    other.m_api = nullptr;
+}
+
+TesseractEnginePool::Lease& TesseractEnginePool::Lease::operator=(Lease&& other) {
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_api = other.m_api;
+        m_lang = other.m_lang;
+        other.m_pool = nullptr;
+        other.m_api = nullptr;
+    }
+    return *this;
+}
+
+TesseractEnginePool::Lease::~Lease() {
+    release();
+}
+
+void TesseractEnginePool::Lease::release() {
+    if (m_pool && m_api) {
+        m_pool->giveBack(m_api, m_lang);
+    }
+    m_pool = nullptr;
+    m_api = nullptr;
+}
+
+TesseractEnginePool::TesseractEnginePool(int maxSize, const QByteArray& dataPath)
+    : m_maxSize(qMax(1, maxSize)), m_dataPath(dataPath)
+{
+}
+
+TesseractEnginePool::~TesseractEnginePool() {
+    QMutexLocker locker(&m_mutex);
+    // 借出中的租约必须先于池销毁 (适配器析构前识别任务已结束)
+    if (m_idle.size() != m_total) {
+        qWarning() << "TesseractEnginePool: 销毁时仍有" << (m_total - m_idle.size()) << "个引擎未归还";
+    }
+    for (const Engine& engine : m_idle) {
+        destroyEngine(engine.api);
+    }
+    m_idle.clear();
+    m_total = 0;
+}
+
+bool TesseractEnginePool::available() {
+#ifdef XS_HAVE_LIBTESSERACT
+    return true;
+#else
+    return false;
+#endif
+}
+
+int TesseractEnginePool::engineCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_total;
+}
+
+TesseractEnginePool::Lease TesseractEnginePool::acquire(const QString& lang) {
+    if (!available()) {
+        return Lease();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        // 1. 同语言的空闲引擎 (优先最近归还的，缓存更热)
+        for (int i = m_idle.size() - 1; i >= 0; --i) {
+            if (m_idle.at(i).lang == lang) {
+                const Engine engine = m_idle.takeAt(i);
+                return Lease(this, engine.api, lang);
+            }
+        }
+
+        // 2. 未达上限：新建引擎，加载语言数据较慢，不持锁
+        if (m_total < m_maxSize) {
+            m_total++;
+            locker.unlock();
+            tesseract::TessBaseAPI* api = createEngine(lang);
+            locker.relock();
+            if (!api) {
+                m_total--;
+                m_available.wakeOne();
+                return Lease();
+            }
+            return Lease(this, api, lang);
+        }
+
+        // 3. 池满：淘汰最久未用的其它语言引擎，腾出名额后重试
+        if (!m_idle.isEmpty()) {
+            const Engine engine = m_idle.takeFirst();
+            m_total--;
+            locker.unlock();
+            destroyEngine(engine.api);
+            locker.relock();
+            continue;
+        }
+
+        // 4. 全部借出：等待归还
+        m_available.wait(&m_mutex);
+    }
+}
+
+void TesseractEnginePool::giveBack(tesseract::TessBaseAPI* api, const QString& lang) {
+    QMutexLocker locker(&m_mutex);
+    Engine engine;
+    engine.api = api;
+    engine.lang = lang;
+    m_idle.append(engine);
+    m_available.wakeOne();
+}
+
+tesseract::TessBaseAPI* TesseractEnginePool::createEngine(const QString& lang) const {
+#ifdef XS_HAVE_LIBTESSERACT
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray langBytes = lang.toUtf8();
+    tesseract::TessBaseAPI* api = new tesseract::TessBaseAPI();
+    if (api->Init(m_dataPath.isEmpty() ? nullptr : m_dataPath.constData(), langBytes.constData(), tesseract::OEM_DEFAULT) != 0) {
+        qWarning() << "TesseractEnginePool: 引擎初始化失败，语言:" << lang
+                   << "tessdata:" << (m_dataPath.isEmpty() ? QString("(默认)") : QString::fromLocal8Bit(m_dataPath));
+        delete api;
+        return nullptr;
+    }
+    api->SetPageSegMode(tesseract::PSM_AUTO);
+    qDebug() << "TesseractEnginePool: 新建引擎" << lang << "耗时" << timer.elapsed() << "ms";
+    return api;
+#else
+    Q_UNUSED(lang);
+    return nullptr;
+#endif
+}
+
+void TesseractEnginePool::destroyEngine(tesseract::TessBaseAPI* api) {
+#ifdef XS_HAVE_LIBTESSERACT
+    if (api) {
+        api->End();
+        delete api;
+    }
+#else
+    Q_UNUSED(api);
+#endif
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace tesseract { class TessBaseAPI; }
+
+// Tesseract 引擎池
+// 单个 TessBaseAPI 不是线程安全的，池中每个引擎同一时刻只借给一个线程：
+//   - 按需创建，最多 maxSize 个；初始化 (加载 traineddata) 在锁外进行
+//   - 以语言组合为键复用空闲引擎；池满且没有同语言的空闲引擎时，淘汰最久未用的其它语言引擎
+//   - 全部借出时 acquire() 阻塞等待归还
+// 未编译 libtesseract 支持 (XS_HAVE_LIBTESSERACT) 时 acquire() 总是返回无效租约
+class TesseractEnginePool {
+public:
+    // 借出的引擎，析构时自动归还
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other);
+        Lease& operator=(Lease&& other);
+        ~Lease();
+
+        bool isValid() const { return m_api != nullptr; }
+        tesseract::TessBaseAPI* api() const { return m_api; }
+
+    private:
+        friend class TesseractEnginePool;
+        Lease(TesseractEnginePool* pool, tesseract::TessBaseAPI* api, const QString& lang);
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        void release();
+
+        TesseractEnginePool* m_pool = nullptr;
+        tesseract::TessBaseAPI* m_api = nullptr;
+        QString m_lang;
+    };
+
+    // dataPath 为 tessdata 目录，为空时由 TESSDATA_PREFIX 或库的默认路径决定
+    TesseractEnginePool(int maxSize, const QByteArray& dataPath = QByteArray());
+    ~TesseractEnginePool();
+
+    // 借出指定语言组合的引擎，初始化失败返回无效租约
+    Lease acquire(const QString& lang);
+
+    int maxSize() const { return m_maxSize; }
+    int engineCount() const;
+
+    // 是否编译了 libtesseract 支持
+    static bool available();
+
+private:
+    struct Engine {
+        tesseract::TessBaseAPI* api;
+        QString lang;
+    };
+
+    tesseract::TessBaseAPI* createEngine(const QString& lang) const;
+    static void destroyEngine(tesseract::TessBaseAPI* api);
+    void giveBack(tesseract::TessBaseAPI* api, const QString& lang);
+
+    const int m_maxSize;
+    const QByteArray m_dataPath;
+    mutable QMutex m_mutex;
+    QWaitCondition m_available;
+    QList<Engine> m_idle;   // 空闲引擎，最近归还的在后
+    int m_total = 0;        // 已创建 (含借出中与初始化中) 的引擎数
+};
@@ -0,0 +1,255 @@
+#include "TesseractWorkerPool.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <QProcess>
+#include <QTimer>
+#include <QtEndian>
+
+namespace {
+// 工作进程启动 (不含语言数据加载) 的最长等待时间
+const int kStartTimeoutMs = 5000;
+
+QByteArray frame(const QByteArray& payload)
+{
+    uchar header[4];
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size()), header);
+    return QByteArray(reinterpret_cast<const char*>(header), 4) + payload;
+}
+}
+
+TesseractWorkerPool::TesseractWorkerPool(const QString& program, const QStringList& arguments, int size, int timeoutMs)
+    : m_program(program), m_arguments(arguments), m_size(qMax(1, size)), m_timeoutMs(timeoutMs),
+      m_context(new QObject())
+{
+    m_context->moveToThread(&m_thread);
+}
+
+TesseractWorkerPool::~TesseractWorkerPool()
+{
+    if (m_thread.isRunning())
+    {
+        QMetaObject::invokeMethod(m_context, [this]() { shutdown(); }, Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+    delete m_context;
+}
+
+bool TesseractWorkerPool::start()
+{
+    m_thread.start();
+
+    bool started = false;
+    QMetaObject::invokeMethod(m_context, [this, &started]() {
+        started = spawnWorker() != nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    if (started)
+    {
+        qDebug() << "TesseractWorkerPool: 工作进程已启动" << m_program << "上限:" << m_size;
+    }
+    return started;
+}
+
+QByteArray TesseractWorkerPool::recognize(const QString& lang, const QByteArray& image, QString& errorMsg)
+{
+    QSharedPointer<Job> job(new Job());
+    job->request = frame(lang.toUtf8() + '\n' + image);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping)
+    {
+        errorMsg = "Tesseract 工作进程池已关闭";
+        return QByteArray();
+    }
+    m_queue.enqueue(job);
+    QMetaObject::invokeMethod(m_context, [this]() { dispatch(); }, Qt::QueuedConnection);
+
+    while (!job->done)
+    {
+        m_finished.wait(&m_mutex);
+    }
+    errorMsg = job->error;
+    return job->response;
+}
+
+TesseractWorkerPool::Worker* TesseractWorkerPool::spawnWorker()
+{
+    Worker* worker = new Worker();
+    worker->process = new QProcess();
+    worker->timer = new QTimer();
+    worker->timer->setSingleShot(true);
+    // 诊断输出 (如分辨率估计提示) 直接转发，不在常驻进程中累积
+    worker->process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    QObject::connect(worker->process, &QProcess::readyReadStandardOutput, m_context, [this, worker]() {
+        readResponse(worker);
+    });
+    QObject::connect(worker->process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), m_context,
+                     [this, worker](int exitCode, QProcess::ExitStatus) {
+        dropWorker(worker, QString("Tesseract 工作进程退出 (exit code %1)").arg(exitCode));
+    });
+    QObject::connect(worker->timer, &QTimer::timeout, m_context, [this, worker]() {
+        dropWorker(worker, "Tesseract 工作进程超时");
+    });
+
+    worker->process->start(m_program, m_arguments);
+    if (!worker->process->waitForStarted(kStartTimeoutMs))
+    {
+        qWarning() << "TesseractWorkerPool: 无法启动工作进程" << m_program << worker->process->errorString();
+        worker->process->disconnect(m_context);
+        delete worker->timer;
+        delete worker->process;
+        delete worker;
+        return nullptr;
+    }
+
+    m_workers.append(worker);
+    return worker;
+}
+
+void TesseractWorkerPool::dispatch()
+{
+    forever
+    {
+        Worker* idle = nullptr;
+        for (Worker* worker : m_workers)
+        {
+            if (!worker->job)
+            {
+                idle = worker;
+                break;
+            }
+        }
+
+        QSharedPointer<Job> job;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.isEmpty())
+            {
+                return;
+            }
+            if (!idle && m_workers.size() >= m_size)
+            {
+                return;  // 全部忙碌，等当前请求完成后再派发
+            }
+            job = m_queue.dequeue();
+        }
+
+        if (!idle)
+        {
+            idle = spawnWorker();
+            if (!idle)
+            {
+                finishJob(job, QByteArray(), "无法启动 Tesseract 工作进程");
+                continue;
+            }
+        }
+
+        idle->job = job;
+        idle->process->write(job->request);
+        if (m_timeoutMs > 0)
+        {
+            idle->timer->start(m_timeoutMs);
+        }
+    }
+}
+
+void TesseractWorkerPool::readResponse(Worker* worker)
+{
+    worker->buffer += worker->process->readAllStandardOutput();
+    if (worker->buffer.size() < 4)
+    {
+        return;
+    }
+    const quint32 length = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(worker->buffer.constData()));
+    if (static_cast<quint32>(worker->buffer.size() - 4) < length)
+    {
+        return;
+    }
+
+    const QByteArray response = worker->buffer.mid(4, static_cast<int>(length));
+    worker->buffer.remove(0, 4 + static_cast<int>(length));
+    worker->timer->stop();
+
+    const QSharedPointer<Job> job = worker->job;
+    worker->job.clear();
+    if (!job)
+    {
+        qWarning() << "TesseractWorkerPool: 收到未预期的响应，丢弃";
+        return;
+    }
+    finishJob(job, response, response.isEmpty() ? QString("Tesseract 识别失败") : QString());
+    dispatch();
+}
+
+void TesseractWorkerPool::dropWorker(Worker* worker, const QString& reason)
+{
+    if (!m_workers.removeOne(worker))
+    {
+        return;  // 超时后 kill 又触发 finished
+    }
+    qWarning() << "TesseractWorkerPool:" << reason;
+
+    worker->timer->stop();
+    if (worker->job)
+    {
+        finishJob(worker->job, QByteArray(), reason);
+        worker->job.clear();
+    }
+
+    worker->process->disconnect(m_context);
+    worker->timer->disconnect(m_context);
+    worker->process->kill();
+    // 可能在该进程自身的信号中，延迟删除
+    worker->process->deleteLater();
+    worker->timer->deleteLater();
+    delete worker;
+
+    // 排队的请求由新进程接手
+    dispatch();
+}
+
+void TesseractWorkerPool::shutdown()
+{
+    QQueue<QSharedPointer<Job>> pending;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        pending.swap(m_queue);
+    }
+    for (const QSharedPointer<Job>& job : pending)
+    {
+        finishJob(job, QByteArray(), "Tesseract 工作进程池已关闭");
+    }
+
+    for (Worker* worker : m_workers)
+    {
+        worker->process->disconnect(m_context);
+        worker->timer->disconnect(m_context);
+        if (worker->job)
+        {
+            finishJob(worker->job, QByteArray(), "Tesseract 工作进程池已关闭");
+        }
+        // 关闭标准输入后工作进程自行退出
+        worker->process->closeWriteChannel();
+        if (!worker->process->waitForFinished(1000))
+        {
+            worker->process->kill();
+            worker->process->waitForFinished(1000);
+        }
+        delete worker->timer;
+        delete worker->process;
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+void TesseractWorkerPool::finishJob(const QSharedPointer<Job>& job, const QByteArray& response, const QString& error)
+{
+    QMutexLocker locker(&m_mutex);
+    job->response = response;
+    job->error = error;
+    job->done = true;
+    m_finished.wakeAll();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+class QProcess;
+class QTimer;
+
+// Tesseract 常驻工作进程池 (进程模式，参数 workers > 0)
+// 工作进程 xs_tesseract_worker 启动时加载一次 traineddata，之后通过标准输入/输出逐张识别：
+//   - 请求与响应都是 [4 字节大端长度][内容]；请求内容为 语言组合 '\n' 编码后的图片，响应为 TSV (长度 0 表示失败)
+//   - 语言组合为 "osd" 时只做脚本检测，响应与 tesseract --psm 0 的输出格式相同
+//   - 按需启动，最多 size 个；进程崩溃或超时后结束其当前请求，下次派发时重新启动
+// QProcess 只能在创建它的线程中使用，所有进程都归池内专用线程所有；recognize() 可在任意线程调用并阻塞等待
+class TesseractWorkerPool {
+public:
+    TesseractWorkerPool(const QString& program, const QStringList& arguments, int size, int timeoutMs = 30000);
+    ~TesseractWorkerPool();
+
+    // 启动专用线程与第一个工作进程 (预加载语言数据)，进程无法启动时返回 false
+    bool start();
+
+    // 识别一张编码后的图片，返回 TSV；失败返回空并写入 errorMsg
+    QByteArray recognize(const QString& lang, const QByteArray& image, QString& errorMsg);
+
+    int size() const { return m_size; }
+
+private:
+    struct Job {
+        QByteArray request;
+        QByteArray response;
+        QString error;
+        bool done = false;
+    };
+
+    struct Worker {
+        QProcess* process = nullptr;
+        QTimer* timer = nullptr;
+        QByteArray buffer;          // 尚未组成完整响应的输出
+        QSharedPointer<Job> job;    // 当前请求，空闲时为空
+    };
+
+    // 以下函数只在专用线程中调用
+    Worker* spawnWorker();
+    void dispatch();
+    void readResponse(Worker* worker);
+    void dropWorker(Worker* worker, const QString& reason);
+    void shutdown();
+
+    void finishJob(const QSharedPointer<Job>& job, const QByteArray& response, const QString& error);
+
+    const QString m_program;
+    const QStringList m_arguments;
+    const int m_size;
+    const int m_timeoutMs;
+
+    QThread m_thread;
+    QObject* m_context;                     // 专用线程中的信号接收者
+    QList<Worker*> m_workers;               // 仅专用线程访问
+
+    QMutex m_mutex;                         // 保护请求队列与请求状态
+    QWaitCondition m_finished;
+    QQueue<QSharedPointer<Job>> m_queue;
+    bool m_stopping = false;
+};
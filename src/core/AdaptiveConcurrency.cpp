@@ -0,0 +1,107 @@
+#include "AdaptiveConcurrency.h"
+#include <QDebug>
+#include <QtMath>
+
+AdaptiveConcurrency::Limits AdaptiveConcurrency::limitsFromParams(const QMap<QString, QString>& params) {
+    Limits limits;
+    limits.maximum = qBound(1, params.value("max_concurrency", "16").toInt(), 64);
+    limits.initial = qBound(limits.minimum, params.value("initial_concurrency", "4").toInt(), limits.maximum);
+    return limits;
+}
+
+bool AdaptiveConcurrency::isOverloadError(const QString& errorMessage) {
+    // 各适配器的错误文本为 "HTTP <状态码>: ..." 或 "请求超时"
+    static const char* const kMarkers[] = {
+        "HTTP 429", "HTTP 502", "HTTP 503", "HTTP 504", "请求超时",
+        "Too Many Requests", "rate limit", "timed out", "timeout"
+    };
+    for (const char* marker : kMarkers) {
+        if (errorMessage.contains(QLatin1String(marker), Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AdaptiveConcurrency::State& AdaptiveConcurrency::state(const QString& modelId) {
+    return m_states[modelId];
+}
+
+int AdaptiveConcurrency::limit(const QString& modelId, const Limits& limits) {
+    auto it = m_states.find(modelId);
+    if (it == m_states.end()) {
+        State s;
+        s.limits = limits;
+        s.limit = limits.initial;
+        it = m_states.insert(modelId, s);
+    } else if (it->limits.maximum != limits.maximum || it->limits.initial != limits.initial) {
+        // 配置修改后按新上限收紧
+        it->limits = limits;
+        it->limit = qBound<double>(limits.minimum, it->limit, limits.maximum);
+    }
+    return qMax(it->limits.minimum, static_cast<int>(it->limit));
+}
+
+void AdaptiveConcurrency::reset(const QString& modelId) {
+    m_states.remove(modelId);
+}
+
+void AdaptiveConcurrency::recordSuccess(const QString& modelId, qint64 latencyMs) {
+    State& s = state(modelId);
+    if (!s.windowTimer.isValid()) {
+        s.windowTimer.start();
+    }
+    s.windowCount++;
+    s.windowLatencySum += qMax<qint64>(1, latencyMs);
+
+    // 窗口大小随并发变化，保证每次评估都覆盖一轮完整的并发请求
+    if (s.windowCount >= qMax(4, static_cast<int>(s.limit))) {
+        evaluateWindow(s);
+    }
+}
+
+void AdaptiveConcurrency::recordOverload(const QString& modelId) {
+    State& s = state(modelId);
+    if (s.backedOff) {
+        return; // 同一轮并发中的多个 429 只算一次
+    }
+    const double previous = s.limit;
+    s.limit = qMax<double>(s.limits.minimum, qFloor(s.limit / 2.0));
+    s.backedOff = true;
+    s.lastThroughput = 0.0;
+    qDebug() << "AdaptiveConcurrency:" << modelId << "限流/超时，并发"
+             << static_cast<int>(previous) << "→" << static_cast<int>(s.limit);
+}
+
+void AdaptiveConcurrency::evaluateWindow(State& s) {
+    const qint64 elapsed = qMax<qint64>(1, s.windowTimer.elapsed());
+    const double throughput = s.windowCount * 1000.0 / elapsed;
+    s.latencyMs = static_cast<double>(s.windowLatencySum) / s.windowCount;
+
+    // 基线取观测到的最低延迟，并缓慢上浮，避免一次偶然的快速响应永久压低基线
+    if (s.baselineMs <= 0.0 || s.latencyMs < s.baselineMs) {
+        s.baselineMs = s.latencyMs;
+    } else {
+        s.baselineMs = s.baselineMs * 0.95 + s.latencyMs * 0.05;
+    }
+
+    const double previous = s.limit;
+    if (s.latencyMs > s.baselineMs * 2.0) {
+        // 乘性减：服务端开始排队
+        s.limit = qMax<double>(s.limits.minimum, s.limit * 0.75);
+    } else if (s.latencyMs <= s.baselineMs * 1.5 && throughput >= s.lastThroughput * 0.95) {
+        // 加性增：延迟平稳且吞吐仍在提升
+        s.limit = qMin<double>(s.limits.maximum, s.limit + 1.0);
+    }
+
+    if (static_cast<int>(previous) != static_cast<int>(s.limit)) {
+        qDebug() << "AdaptiveConcurrency: 并发" << static_cast<int>(previous) << "→" << static_cast<int>(s.limit)
+                 << "吞吐" << throughput << "/s 延迟" << s.latencyMs << "ms 基线" << s.baselineMs << "ms";
+    }
+
+    s.lastThroughput = throughput;
+    s.windowCount = 0;
+    s.windowLatencySum = 0;
+    s.backedOff = false;
+    s.windowTimer.restart();
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QElapsedTimer>
+
+// 按模型自适应的并发上限 (AIMD)
+// 本地 Paddle 服务 2 路就会排队，云端接口 32 路仍然线性，固定并发数无法兼顾：
+//   - 每完成一个窗口 (≈当前并发数个请求) 评估一次：吞吐没有下降且延迟接近基线时并发 +1
+//   - 延迟明显升高 (超过基线 2 倍) 时按 3/4 收缩
+//   - 遇到限流 (429) 或超时立即减半，并在一个窗口内不再重复惩罚
+// 仅在界面线程访问 (OCRPipeline 的结果回调中更新)
+class AdaptiveConcurrency {
+public:
+    struct Limits {
+        int initial = 4;
+        int minimum = 1;
+        int maximum = 16;
+    };
+
+    // 读取模型参数 max_concurrency (上限，默认 16) 与 initial_concurrency (起始值，默认 4)
+    static Limits limitsFromParams(const QMap<QString, QString>& params);
+
+    // 是否为过载类错误 (限流 / 超时 / 服务不可用)
+    static bool isOverloadError(const QString& errorMessage);
+
+    // 当前并发上限；首次访问按 limits 初始化
+    int limit(const QString& modelId, const Limits& limits = Limits());
+
+    void recordSuccess(const QString& modelId, qint64 latencyMs);
+    void recordOverload(const QString& modelId);
+
+    // 清除某个模型的学习结果 (模型配置变化后重新探测)
+    void reset(const QString& modelId);
+
+private:
+    struct State {
+        Limits limits;
+        double limit = 4.0;
+        double baselineMs = 0.0;     // 低并发时观测到的延迟下限 (缓慢上浮以适应服务变化)
+        double latencyMs = 0.0;      // 本窗口延迟均值
+        double lastThroughput = 0.0; // 上一窗口吞吐 (次/秒)
+        int windowCount = 0;
+        qint64 windowLatencySum = 0;
+        QElapsedTimer windowTimer;
+        bool backedOff = false;      // 本窗口已因过载收缩
+    };
+
+    State& state(const QString& modelId);
+    void evaluateWindow(State& s);
+
+    QHash<QString, State> m_states;
+};
@@ -0,0 +1,310 @@
+#include "BatchSource.h"
+#include <QImageReader>
+#include <QFileInfo>
+#include <QAtomicInt>
+#include <cstring>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+#ifdef XS_HAVE_QTPDF
+#include <QPdfDocument>
+#include <QThreadStorage>
+#endif
+
+namespace {
+const char* const kPageSeparator = "|page:";  // '|' 不能出现在 Windows 文件名中
+QAtomicInt s_renderDpi(150);
+
+// 只有 TIFF 的多帧是文档页；canRead() 之后 format() 才有值
+bool isMultiPageTiff(QImageReader& reader) {
+    return reader.format().toLower() == "tiff" && reader.imageCount() > 1;
+}
+
+bool isPdf(const QString& path) {
+    return QFileInfo(path).suffix().compare("pdf", Qt::CaseInsensitive) == 0;
+}
+
+#ifdef XS_HAVE_QTPDF
+// 每个解码线程保留最近打开的一份 PDF，逐页渲染时不必重复解析文档
+struct PdfHandle {
+    QString path;
+    QPdfDocument document;
+};
+QThreadStorage<PdfHandle*> s_pdfHandles;
+
+QPdfDocument* openPdf(const QString& path) {
+    if (!s_pdfHandles.hasLocalData()) {
+        s_pdfHandles.setLocalData(new PdfHandle());
+    }
+    PdfHandle* handle = s_pdfHandles.localData();
+    if (handle->path != path || handle->document.status() != QPdfDocument::Status::Ready) {
+        handle->document.close();
+        handle->document.load(path);
+        handle->path = path;
+    }
+    return handle->document.status() == QPdfDocument::Status::Ready ? &handle->document : nullptr;
+}
+
+QSize pdfPagePixelSize(QPdfDocument* document, int page) {
+    // 页面尺寸单位为点 (1/72 英寸)；Qt5 的 QtPdf 中对应接口为 pageSize()
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    const QSizeF points = document->pagePointSize(page);
+#else
+    const QSizeF points = document->pageSize(page);
+#endif
+    const qreal scale = BatchSource::renderDpi() / 72.0;
+    return QSize(qRound(points.width() * scale), qRound(points.height() * scale));
+}
+#endif
+}
+
+QString BatchSource::Entry::ref() const {
+    return page < 0 ? path : path + kPageSeparator + QString::number(page);
+}
+
+BatchSource::Entry BatchSource::Entry::fromRef(const QString& ref) {
+    Entry entry;
+    const int pos = ref.lastIndexOf(kPageSeparator);
+    bool ok = false;
+    const int page = pos > 0 ? ref.mid(pos + int(strlen(kPageSeparator))).toInt(&ok) : -1;
+    if (ok && page >= 0) {
+        entry.path = ref.left(pos);
+        entry.page = page;
+    } else {
+        entry.path = ref;
+    }
+    return entry;
+}
+
+void BatchSource::setRenderDpi(int dpi) {
+    s_renderDpi.storeRelaxed(qBound(72, dpi, 600));
+}
+
+int BatchSource::renderDpi() {
+    return s_renderDpi.loadRelaxed();
+}
+
+bool BatchSource::pdfSupported() {
+#ifdef XS_HAVE_QTPDF
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BatchSource::isDocument(const QString& path) {
+    if (isPdf(path)) return true;
+    QImageReader reader(path);
+    return reader.canRead() && isMultiPageTiff(reader);
+}
+
+BatchSource::BatchSource(const QVector<Entry>& entries, int prefetchWindow)
+    : m_entries(entries)
+    , m_prefetchWindow(qMax(0, prefetchWindow))
+{
+    // 解码以 CPU 为主，两个线程足以赶在网络请求之前准备好下一批
+    m_decodePool.setMaxThreadCount(2);
+}
+
+BatchSource::~BatchSource() {
+    cancel();
+    m_decodePool.waitForDone();
+}
+
+BatchSource::ScanResult BatchSource::scan(const QStringList& files) {
+    ScanResult result;
+    result.entries.reserve(files.size());
+    for (const QString& path : files) {
+        if (isPdf(path)) {
+#ifdef XS_HAVE_QTPDF
+            // 只解析页数与页面尺寸，页面在识别时再逐页渲染
+            QPdfDocument* document = openPdf(path);
+            const int pageCount = document ? document->pageCount() : 0;
+            if (pageCount <= 0) {
+                qWarning() << "BatchSource: Skipping unreadable PDF" << path;
+                result.rejected << path;
+                continue;
+            }
+            for (int page = 0; page < pageCount; ++page) {
+                Entry entry;
+                entry.path = path;
+                entry.page = page;
+                entry.pageCount = pageCount;
+                entry.size = pdfPagePixelSize(document, page);
+                result.entries.append(entry);
+            }
+#else
+            qWarning() << "BatchSource: PDF input requires the QtPdf module" << path;
+            result.rejected << path;
+#endif
+            continue;
+        }
+
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+        // canRead()/size() 只读取文件头，不会解码像素
+        QSize size = reader.canRead() ? reader.size() : QSize();
+        if (!reader.canRead() || (size.isValid() && size.isEmpty())) {
+            qWarning() << "BatchSource: Skipping unreadable image" << path << reader.errorString();
+            result.rejected << path;
+            continue;
+        }
+        // 多页 TIFF：逐页展开 (动图 GIF / WebP / APNG 的多帧不是页，只识别首帧)
+        const int imageCount = isMultiPageTiff(reader) ? reader.imageCount() : 1;
+        if (imageCount > 1) {
+            for (int page = 0; page < imageCount; ++page) {
+                Entry entry;
+                entry.path = path;
+                entry.page = page;
+                entry.pageCount = imageCount;
+                entry.size = size;
+                result.entries.append(entry);
+            }
+            continue;
+        }
+
+        Entry entry;
+        entry.path = path;
+        entry.size = size;
+        result.entries.append(entry);
+    }
+    return result;
+}
+
+QImage BatchSource::decode(const Entry& entry) {
+    if (entry.page < 0) {
+        return decode(entry.path);
+    }
+
+    if (isPdf(entry.path)) {
+#ifdef XS_HAVE_QTPDF
+        QPdfDocument* document = openPdf(entry.path);
+        if (!document || entry.page >= document->pageCount()) {
+            qWarning() << "BatchSource: Failed to open PDF page" << entry.path << entry.page;
+            return QImage();
+        }
+        QImage image = document->render(entry.page, pdfPagePixelSize(document, entry.page));
+        // 渲染结果带透明通道，转为不透明格式以便编码与哈希
+        return image.convertToFormat(QImage::Format_RGB32);
+#else
+        qWarning() << "BatchSource: PDF input requires the QtPdf module" << entry.path;
+        return QImage();
+#endif
+    }
+
+    QImageReader reader(entry.path);
+    reader.setAutoTransform(true);
+    if (!reader.jumpToImage(entry.page)) {
+        qWarning() << "BatchSource: Failed to seek to page" << entry.page << entry.path;
+        return QImage();
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "BatchSource: Failed to decode page" << entry.page << entry.path << reader.errorString();
+    }
+    return image;
+}
+
+QImage BatchSource::decode(const QString& path) {
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "BatchSource: Failed to decode" << path << reader.errorString();
+    }
+    return image;
+}
+
+QString BatchSource::path(int index) const {
+    return (index >= 0 && index < m_entries.size()) ? m_entries.at(index).path : QString();
+}
+
+BatchSource::Entry BatchSource::entry(int index) const {
+    return (index >= 0 && index < m_entries.size()) ? m_entries.at(index) : Entry();
+}
+
+void BatchSource::prefetch(int index) {
+    QMutexLocker locker(&m_mutex);
+    if (m_cancelled.loadAcquire()) return;
+
+    const int end = qMin(m_entries.size(), index + m_prefetchWindow);
+    for (int i = qMax(index, m_prefetchedUntil); i < end; ++i) {
+        if (m_pending.contains(i) || m_skipped.contains(i)) continue;
+        const Entry entry = m_entries.at(i);
+        m_pending.insert(i, QtConcurrent::run(&m_decodePool, [this, entry]() {
+            return decodeUnlessCancelled(entry);
+        }));
+    }
+    m_prefetchedUntil = qMax(m_prefetchedUntil, end);
+}
+
+QImage BatchSource::take(int index) {
+    QFuture<QImage> future;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_fanOut > 1) {
+            // 多个组合共用同一张图片：首个取用者负责调度解码，其余等待同一结果
+            // 所有组合都已取用过的项 (失败后重试) 在当前线程单独解码，不再放回 m_pending，
+            // 否则取用计数永远凑不满，解码结果会一直保留到批量结束
+            if (!m_consumed.contains(index)) {
+                future = m_pending.value(index);
+                if (future.isCanceled() && !m_cancelled.loadAcquire() && index >= 0 && index < m_entries.size()) {
+                    const Entry entry = m_entries.at(index);
+                    future = QtConcurrent::run(&m_decodePool, [this, entry]() {
+                        return decodeUnlessCancelled(entry);
+                    });
+                    m_pending.insert(index, future);
+                }
+                if (++m_taken[index] >= m_fanOut) {
+                    m_pending.remove(index);
+                    m_taken.remove(index);
+                    m_consumed.insert(index);
+                }
+            }
+        } else {
+            future = m_pending.take(index);
+        }
+    }
+
+    // 未预取 (窗口为 0、乱序请求或已取消)：直接在当前工作线程解码
+    if (future.isCanceled()) {
+        return decodeUnlessCancelled(entry(index));
+    }
+    return future.result();
+}
+
+QImage BatchSource::decodeUnlessCancelled(const Entry& entry) const {
+    // 取消后排队中的解码照常运行但立即返回空图，等待它的 take() 不会永远阻塞
+    if (m_cancelled.loadAcquire()) return QImage();
+    return decode(entry);
+}
+
+std::function<QImage()> BatchSource::loader(const std::shared_ptr<BatchSource>& source, int index) {
+    return [source, index]() {
+        return source->take(index);
+    };
+}
+
+void BatchSource::setFanOut(int consumers) {
+    QMutexLocker locker(&m_mutex);
+    m_fanOut = qMax(1, consumers);
+}
+
+void BatchSource::skip(int index) {
+    QMutexLocker locker(&m_mutex);
+    if (m_consumed.contains(index)) return;
+    if (m_fanOut > 1 && ++m_taken[index] < m_fanOut) {
+        return;
+    }
+    m_taken.remove(index);
+    m_pending.remove(index);
+    m_skipped.insert(index);
+    m_consumed.insert(index);
+}
+
+void BatchSource::cancel() {
+    QMutexLocker locker(&m_mutex);
+    m_cancelled.storeRelease(1);
+    // 不能 clear() 解码线程池：已被 take() 取走的 future 对应的任务若被移除将永远不会完成
+    m_pending.clear();
+    m_taken.clear();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <QAtomicInt>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QMutex>
+#include <QFuture>
+#include <QThreadPool>
+#include <functional>
+#include <memory>
+
+// 批量图片来源
+// 只保存文件路径，图片在工作线程中按需解码：
+//   - scan() 仅读取文件头校验格式与尺寸，不解码像素
+//   - prefetch() 在独立的小线程池中提前解码后续若干张（有界窗口）
+//   - take() 由识别任务调用，取走已解码的图片（未预取时直接解码），取走后窗口不再持有像素
+// 多页文档 (PDF、多页 TIFF) 在 scan() 时展开为逐页条目，页面同样按需渲染，不会整份载入内存
+// 线程安全，通过 std::shared_ptr 在界面与识别任务之间共享
+class BatchSource {
+public:
+    struct Entry {
+        QString path;
+        QSize size;         // 文件头中的图片尺寸 (PDF 为按渲染 DPI 换算的尺寸)
+        int page = -1;      // 多页文档的页码 (从 0 开始)，普通图片为 -1
+        int pageCount = 1;  // 所属文档的总页数
+
+        // 条目引用 (批量日志中保存)：普通图片为路径，文档页为 "路径|page:N"
+        QString ref() const;
+        static Entry fromRef(const QString& ref);
+    };
+
+    struct ScanResult {
+        QVector<Entry> entries;
+        QStringList rejected; // 无法识别格式或尺寸的文件
+    };
+
+    static const int kDefaultPrefetch = 4;
+
+    explicit BatchSource(const QVector<Entry>& entries, int prefetchWindow = kDefaultPrefetch);
+    ~BatchSource();
+
+    // 只读文件头校验图片 (可在工作线程调用)
+    static ScanResult scan(const QStringList& files);
+
+    // 解码单张图片 (应用 EXIF 方向)
+    static QImage decode(const QString& path);
+
+    // 解码条目：普通图片同 decode(path)，文档页按页渲染
+    static QImage decode(const Entry& entry);
+
+    // 是否为需要逐页处理的文档 (PDF 或多页 TIFF)
+    static bool isDocument(const QString& path);
+
+    // PDF 渲染分辨率 (默认 150 DPI)
+    static void setRenderDpi(int dpi);
+    static int renderDpi();
+
+    // 是否支持 PDF 输入 (编译时检测到 QtPdf 模块)
+    static bool pdfSupported();
+
+    int size() const { return m_entries.size(); }
+    QString path(int index) const;
+    Entry entry(int index) const;
+
+    // 预取 [index, index + 窗口) 范围内尚未解码的图片
+    void prefetch(int index);
+
+    // 取走第 index 张图片，预取中的会等待完成；可在工作线程调用
+    QImage take(int index);
+
+    // 生成供 OCRRequest 使用的延迟加载函数
+    static std::function<QImage()> loader(const std::shared_ptr<BatchSource>& source, int index);
+
+    // 每张图片的取用者数 (批量矩阵中的组合数，默认 1)：同一张图片只解码一次，最后一个取用者取走后释放
+    void setFanOut(int consumers);
+    int fanOut() const { return m_fanOut; }
+
+    // 标记某个取用者无需处理该项 (如恢复任务时已完成的)；所有取用者都跳过后预取不再解码
+    void skip(int index);
+
+    // 放弃尚未取走的预取结果
+    void cancel();
+
+private:
+    // 已取消时返回空图，否则解码 (解码线程池中的任务与 take() 使用)
+    QImage decodeUnlessCancelled(const Entry& entry) const;
+
+    QVector<Entry> m_entries;
+    int m_prefetchWindow;
+    QAtomicInt m_cancelled;                // 取消后解码任务直接返回空图 (先于线程池声明，线程池析构等待任务时仍有效)
+    QThreadPool m_decodePool;              // 独立解码线程，避免占满识别任务所在的全局线程池
+    mutable QMutex m_mutex;
+    QHash<int, QFuture<QImage>> m_pending; // 已调度、尚未取走的解码任务
+    QSet<int> m_skipped;
+    QHash<int, int> m_taken;               // 下标 → 已取用 / 跳过的次数 (fanOut > 1 时)
+    QSet<int> m_consumed;                  // 所有取用者都已取用或跳过的下标 (fanOut > 1 时)，再次取用不计数
+    int m_fanOut = 1;
+    int m_prefetchedUntil = 0;             // 已调度预取的下一个下标
+};
@@ -0,0 +1,108 @@
+#include "BatchStats.h"
+#include <QtMath>
+
+const QVector<qint64>& BatchStats::latencyBuckets() {
+    static const QVector<qint64> buckets = { 500, 1000, 2000, 5000, 10000, 30000 };
+    return buckets;
+}
+
+BatchStats::BatchStats(int windowMs)
+    : m_windowMs(qMax(1000, windowMs))
+{
+}
+
+void BatchStats::reset(int total, int restored) {
+    m_timer.start();
+    m_started.clear();
+    m_recentFinishes.clear();
+    m_histogram = QVector<int>(latencyBuckets().size() + 1, 0);
+    m_total = total;
+    m_restored = restored;
+    m_completed = 0;
+    m_failed = 0;
+    m_cacheHits = 0;
+    m_retries = 0;
+}
+
+void BatchStats::recordSubmitted(int index) {
+    if (!m_timer.isValid()) return;
+    m_started.insert(index, m_timer.elapsed());
+}
+
+void BatchStats::recordCompleted(int index, bool fromCache) {
+    if (!m_timer.isValid()) return;
+    m_completed++;
+    if (fromCache) m_cacheHits++;
+    recordFinished(index);
+}
+
+void BatchStats::recordFailed(int index) {
+    if (!m_timer.isValid()) return;
+    m_failed++;
+    recordFinished(index);
+}
+
+void BatchStats::recordRetry(int count) {
+    if (!m_timer.isValid()) return;
+    // 重试的项重新计入待处理
+    m_retries += count;
+    m_failed = qMax(0, m_failed - count);
+}
+
+void BatchStats::recordFinished(int index) {
+    const qint64 now = m_timer.elapsed();
+    m_recentFinishes.enqueue(now);
+    trimWindow(now);
+
+    auto it = m_started.find(index);
+    if (it == m_started.end()) return;
+    const qint64 latency = now - it.value();
+    m_started.erase(it);
+
+    const QVector<qint64>& buckets = latencyBuckets();
+    int bucket = 0;
+    while (bucket < buckets.size() && latency > buckets.at(bucket)) {
+        bucket++;
+    }
+    m_histogram[bucket]++;
+}
+
+void BatchStats::trimWindow(qint64 now) const {
+    while (!m_recentFinishes.isEmpty() && now - m_recentFinishes.head() > m_windowMs) {
+        m_recentFinishes.dequeue();
+    }
+}
+
+BatchStats::Snapshot BatchStats::snapshot() const {
+    Snapshot snap;
+    if (!m_timer.isValid()) return snap;
+
+    const qint64 now = m_timer.elapsed();
+    trimWindow(now);
+
+    snap.total = m_total;
+    snap.completed = m_completed;
+    snap.failed = m_failed;
+    snap.restored = m_restored;
+    snap.inFlight = m_started.size();
+    snap.concurrency = m_concurrency;
+    snap.queued = qMax(0, m_total - m_restored - m_completed - m_failed - snap.inFlight);
+    snap.cacheHits = m_cacheHits;
+    snap.retries = m_retries;
+    snap.elapsedMs = now;
+    snap.histogram = m_histogram;
+
+    // 批次刚开始时窗口未满，按实际经过时间计算，避免前几秒吞吐量偏低
+    const qint64 span = qMin<qint64>(now, m_windowMs);
+    if (span > 0 && !m_recentFinishes.isEmpty()) {
+        snap.throughput = m_recentFinishes.size() * 1000.0 / span;
+    }
+
+    const int remaining = snap.queued + snap.inFlight;
+    if (remaining == 0) {
+        snap.etaSeconds = 0;
+    } else if (snap.throughput > 0.0) {
+        snap.etaSeconds = qCeil(remaining / snap.throughput);
+    }
+    return snap;
+}
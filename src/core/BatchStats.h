@@ -0,0 +1,66 @@
+#pragma once
+#include <QHash>
+#include <QVector>
+#include <QQueue>
+#include <QElapsedTimer>
+
+// 批量任务统计
+// 由 MainWindow 在 OCRPipeline 的开始/完成/失败信号中更新（仅在界面线程访问），
+// 提供吞吐量（滑动窗口）、并发中/排队数、缓存命中率、失败/重试次数、单张耗时分布和剩余时间估计
+class BatchStats {
+public:
+    // 单张耗时分布的桶上限（毫秒），最后一个桶收纳更慢的请求
+    static const QVector<qint64>& latencyBuckets();
+
+    struct Snapshot {
+        int total = 0;
+        int completed = 0;      // 本次运行成功的张数
+        int failed = 0;
+        int restored = 0;       // 恢复任务时已完成的张数
+        int inFlight = 0;
+        int concurrency = 0;    // 自适应并发控制器当前给出的上限
+        int queued = 0;         // 尚未提交的张数
+        int cacheHits = 0;
+        int retries = 0;
+        double throughput = 0.0;   // 张/秒
+        int etaSeconds = -1;       // -1 表示暂无法估计
+        qint64 elapsedMs = 0;
+        QVector<int> histogram;    // 与 latencyBuckets() 对应，多出一个溢出桶
+
+        double cacheHitRatio() const {
+            const int finished = completed + failed;
+            return finished > 0 ? static_cast<double>(cacheHits) / finished : 0.0;
+        }
+    };
+
+    explicit BatchStats(int windowMs = 20000);
+
+    // 开始新批次；restored 为恢复任务时已完成的张数
+    void reset(int total, int restored = 0);
+
+    void recordSubmitted(int index);
+    void recordCompleted(int index, bool fromCache);
+    void recordFailed(int index);
+    void recordRetry(int count = 1);
+    void setConcurrency(int limit) { m_concurrency = limit; }
+
+    bool isActive() const { return m_timer.isValid(); }
+    Snapshot snapshot() const;
+
+private:
+    void recordFinished(int index);
+    void trimWindow(qint64 now) const;
+
+    int m_windowMs;
+    QElapsedTimer m_timer;
+    QHash<int, qint64> m_started;              // 下标 → 提交时刻
+    mutable QQueue<qint64> m_recentFinishes;   // 窗口内的完成时刻
+    QVector<int> m_histogram;
+    int m_total = 0;
+    int m_restored = 0;
+    int m_completed = 0;
+    int m_failed = 0;
+    int m_cacheHits = 0;
+    int m_retries = 0;
+    int m_concurrency = 0;
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include <QString>
+#include <QVector>
+
+// 批量矩阵中的一组 (提示词, 模型) 组合
+// 同一批图片按多个组合各识别一次，每张图片只解码、编码一次
+struct BatchVariant {
+    QString name;      // 显示名称 (提示词模板名 · 模型名)
+    QString prompt;
+    QString modelId;   // 为空表示使用当前模型
+};
+
+typedef QVector<BatchVariant> BatchVariantList;
@@ -0,0 +1,88 @@
+#include "ContentHash.h"
+#include "ImagePayload.h"
+#include <QBuffer>
+
+QString ContentHash::compute(const QImage& img, const QString& prompt, const QString& model, const QMap<QString, QString>& params) {
+    if (img.isNull()) return QString();
+    
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    
+    // Hash Image Data
+    // 使用 PNG 格式以确保无损和一致性；同一张图片配多个提示词时只编码一次
+    const QByteArray imgData = ImagePayload::encoded(img, "png", [&img]() {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        img.save(&buffer, "PNG");
+        return data;
+    });
+    hasher.addData(imgData);
+    
+    addRequestData(hasher, prompt, model, params);
+    
+    return hasher.result().toHex();
+}
+
+QString ContentHash::requestKey(const QString& prompt, const QString& model, const QMap<QString, QString>& params) {
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    addRequestData(hasher, prompt, model, params);
+    return hasher.result().toHex();
+}
+
+void ContentHash::addRequestData(QCryptographicHash& hasher, const QString& prompt, const QString& model, const QMap<QString, QString>& params) {
+    // Hash Prompt
+    hasher.addData(prompt.toUtf8());
+    
+    // Hash Model
+    hasher.addData(model.toUtf8());
+
+    // Hash Params (QMap 参数按key排序)
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        if (isSensitiveParam(it.key()) || isCachePolicyParam(it.key())) continue;
+        
+        hasher.addData(it.key().toUtf8());
+        hasher.addData(it.value().toUtf8());
+    }
+}
+
+quint64 ContentHash::perceptual(const QImage& img) {
+    if (img.isNull()) return 0;
+
+    // 先平滑缩放再转灰度，避免对原图做整幅格式转换；光标、选框等局部差异在 9x8 网格中被平均掉
+    QImage small = img.scaled(9, 8, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                      .convertToFormat(QImage::Format_Grayscale8);
+
+    quint64 hash = 0;
+    int bit = 0;
+    for (int y = 0; y < 8; ++y) {
+        const uchar* line = small.constScanLine(y);
+        for (int x = 0; x < 8; ++x, ++bit) {
+            if (line[x] < line[x + 1]) {
+                hash |= (Q_UINT64_C(1) << bit);
+            }
+        }
+    }
+    return hash;
+}
+
+int ContentHash::hammingDistance(quint64 a, quint64 b) {
+    quint64 diff = a ^ b;
+    int count = 0;
+    while (diff) {
+        diff &= diff - 1;
+        ++count;
+    }
+    return count;
+}
+
+bool ContentHash::isSensitiveParam(const QString& key) {
+    return key.compare("api_key", Qt::CaseInsensitive) == 0
+        || key.compare("secret_key", Qt::CaseInsensitive) == 0
+        || key.compare("access_token", Qt::CaseInsensitive) == 0;
+}
+
+bool ContentHash::isCachePolicyParam(const QString& key) {
+    return key.compare("phash_threshold", Qt::CaseInsensitive) == 0
+        || key.compare("max_concurrency", Qt::CaseInsensitive) == 0
+        || key.compare("initial_concurrency", Qt::CaseInsensitive) == 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <QImage>
+#include <QString>
+#include <QMap>
+#include <QCryptographicHash>
+
+// 内容哈希
+// 图片 + 提示词 + 模型 + 模型参数 → MD5，用于结果缓存去重（线程安全，可在工作线程调用）
+class ContentHash {
+public:
+    // 计算内容哈希，图片为空时返回空字符串（纯文本询问不参与缓存）
+    static QString compute(const QImage& img, const QString& prompt, const QString& model, const QMap<QString, QString>& params = QMap<QString, QString>());
+
+    // 请求键：提示词 + 模型 + 模型参数（不含图片），近似去重只在同一请求键内比较
+    static QString requestKey(const QString& prompt, const QString& model, const QMap<QString, QString>& params = QMap<QString, QString>());
+
+    // 感知哈希 (dHash)：缩放到 9x8 灰度后比较相邻像素，返回 64 位指纹；空图或纯色图返回 0
+    static quint64 perceptual(const QImage& img);
+
+    // 两个指纹的汉明距离
+    static int hammingDistance(quint64 a, quint64 b);
+
+    // 是否为不参与哈希的敏感参数 (API Key 等)，避免因 Key 变更导致缓存失效
+    static bool isSensitiveParam(const QString& key);
+
+    // 是否为仅影响缓存或调度策略、不影响识别输出的参数 (如近似去重阈值、并发上限)
+    static bool isCachePolicyParam(const QString& key);
+
+private:
+    static void addRequestData(QCryptographicHash& hasher, const QString& prompt, const QString& model, const QMap<QString, QString>& params);
+};
@@ -11,6 +11,9 @@ struct HistoryItem {
     SubmitSource source; // 提交源: 上传、粘贴、截图
     QDateTime timestamp;
     QString imagePath;   // 本地保存的图片路径，用于持久化
+    QString thumbnailPath; // 缩略图路径（入库时后台生成，列表与预览使用）
     QString contentHash; // 内容哈希 (image + prompt + model name + model params)，用于缓存去重
+    QString requestKey;  // 请求键 (prompt + model name + model params)，近似去重分组
+    quint64 perceptualHash = 0; // 感知哈希 (dHash)，0 表示未参与近似去重
     bool persisted = false; // 是否已持久化到数据库
 };
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "ImagePayload.h"
+#include <QMutexLocker>
+
+QMutex ImagePayload::s_mutex;
+QList<ImagePayload::Entry> ImagePayload::s_entries;
+int ImagePayload::s_bytes = 0;
+
+QByteArray ImagePayload::encoded(const QImage& image, const QString& variant, const Encoder& encoder) {
+    if (image.isNull()) {
+        return encoder();
+    }
+
+    const qint64 key = image.cacheKey();
+    {
+        QMutexLocker locker(&s_mutex);
+        for (int i = 0; i < s_entries.size(); ++i) {
+            if (s_entries.at(i).key == key && s_entries.at(i).variant == variant) {
+                s_entries.move(i, 0);
+                return s_entries.first().data;
+            }
+        }
+    }
+
+    // 编码不持锁：并发请求同一张图时可能重复编码一次，但不会互相阻塞
+    const QByteArray data = encoder();
+    if (data.isEmpty() || data.size() > kMaxBytes / 4) {
+        return data;
+    }
+
+    QMutexLocker locker(&s_mutex);
+    for (const Entry& entry : s_entries) {
+        if (entry.key == key && entry.variant == variant) {
+            return data;
+        }
+    }
+    Entry entry;
+    entry.key = key;
+    entry.variant = variant;
+    entry.data = data;
+    s_entries.prepend(entry);
+    s_bytes += data.size();
+    while (!s_entries.isEmpty() && (s_entries.size() > kMaxEntries || s_bytes > kMaxBytes)) {
+        s_bytes -= s_entries.last().data.size();
+        s_entries.removeLast();
+    }
+    return data;
+}
+
+QString ImagePayload::base64(const QImage& image, const QString& variant, const std::function<QString()>& encoder) {
+    return QString::fromLatin1(encoded(image, variant, [&encoder]() {
+        return encoder().toLatin1();
+    }));
+}
+
+void ImagePayload::clear() {
+    QMutexLocker locker(&s_mutex);
+    s_entries.clear();
+    s_bytes = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <QImage>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QList>
+#include <functional>
+
+// 图片编码结果缓存
+// 同一张解码后的图片被多个提示词 / 模型共用时 (批量矩阵)，PNG/JPEG 编码与 base64 只做一次：
+//   - 以 QImage::cacheKey() 标识图片 (隐式共享的副本 cacheKey 相同，修改像素后会变化)
+//   - variant 区分编码方式 (如 "png"、各适配器的 base64 载荷)
+//   - 容量按条目数与总字节数双重限制，最近使用的保留
+// 线程安全，识别任务在工作线程中调用
+class ImagePayload {
+public:
+    typedef std::function<QByteArray()> Encoder;
+
+    // 取缓存的编码结果，未命中时调用 encoder 并缓存
+    static QByteArray encoded(const QImage& image, const QString& variant, const Encoder& encoder);
+
+    // 适配器使用的 base64 载荷 (encoder 返回 base64 文本)
+    static QString base64(const QImage& image, const QString& variant, const std::function<QString()>& encoder);
+
+    static void clear();
+
+private:
+    struct Entry {
+        qint64 key = 0;
+        QString variant;
+        QByteArray data;
+    };
+
+    static const int kMaxEntries = 16;
+    static const int kMaxBytes = 64 * 1024 * 1024;
+
+    static QMutex s_mutex;
+    static QList<Entry> s_entries;   // 最近使用的在前
+    static int s_bytes;
+};
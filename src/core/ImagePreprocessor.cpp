@@ -0,0 +1,448 @@
+#include "ImagePreprocessor.h"
+#include <QDebug>
+#include <QStringList>
+#include <QVector>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+const int kDarkThreshold = 128;          // 低于此灰度视为深色 (对比度归一化之后)
+const double kBorderFraction = 0.6;      // 深色占比超过此值的边缘行/列视为扫描黑边
+const double kEmptyFraction = 0.002;     // 深色占比不超过此值的边缘行/列视为空白边距
+const double kMinRotation = 0.2;         // 小于此角度 (度) 不做旋转，避免无谓的重采样
+const int kSkewSampleSide = 1000;        // 倾斜估计时的采样网格：长边约 1000 个采样点
+
+// 统计 rect 内每行、每列的深色像素数
+void darkProfiles(const QImage& gray, const QRect& rect, QVector<int>& rows, QVector<int>& cols)
+{
+    rows.fill(0, rect.height());
+    cols.fill(0, rect.width());
+    int* colData = cols.data();
+    for (int y = 0; y < rect.height(); ++y) {
+        const uchar* line = gray.constScanLine(rect.top() + y) + rect.left();
+        int count = 0;
+        for (int x = 0; x < rect.width(); ++x) {
+            const int dark = line[x] < kDarkThreshold ? 1 : 0;
+            count += dark;
+            colData[x] += dark;
+        }
+        rows[y] = count;
+    }
+}
+
+// 交换使 a <= b (中值排序网络的比较单元，无分支)
+inline void sortPair(uchar& a, uchar& b)
+{
+    const uchar lo = qMin(a, b);
+    b = qMax(a, b);
+    a = lo;
+}
+
+// 从两端收缩 [begin, end)，跳过满足 skip 的位置
+template <typename Predicate>
+void trimRange(const QVector<int>& profile, int& begin, int& end, Predicate skip)
+{
+    while (begin < end && skip(profile.at(begin))) ++begin;
+    while (end > begin && skip(profile.at(end - 1))) --end;
+}
+}
+
+QRectF ImagePreprocessor::Result::mapToSource(const QRectF& box) const {
+    if (image.isNull() || sourceSize.isEmpty()) return box;
+
+    // 归一化 → 处理后像素 → 放大前像素 (裁剪、旋转后的坐标系)
+    const qreal w = image.width();
+    const qreal h = image.height();
+    QRectF px(box.x() * w / scale, box.y() * h / scale, box.width() * w / scale, box.height() * h / scale);
+
+    // 撤销旋转：取四个角反向旋转后的外接矩形
+    if (!qFuzzyIsNull(rotation)) {
+        const double rad = qDegreesToRadians(rotation);
+        const double c = std::cos(rad);
+        const double s = std::sin(rad);
+        const double cx = (crop.width() - 1) / 2.0;
+        const double cy = (crop.height() - 1) / 2.0;
+        const QPointF corners[4] = { px.topLeft(), px.topRight(), px.bottomLeft(), px.bottomRight() };
+        double minX = 1e9, minY = 1e9, maxX = -1e9, maxY = -1e9;
+        for (const QPointF& p : corners) {
+            const double dx = p.x() - cx;
+            const double dy = p.y() - cy;
+            const double sx = cx + c * dx + s * dy;
+            const double sy = cy - s * dx + c * dy;
+            minX = qMin(minX, sx);
+            minY = qMin(minY, sy);
+            maxX = qMax(maxX, sx);
+            maxY = qMax(maxY, sy);
+        }
+        px = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+    }
+
+    px.translate(crop.topLeft());
+    const qreal sw = sourceSize.width();
+    const qreal sh = sourceSize.height();
+    return QRectF(px.x() / sw, px.y() / sh, px.width() / sw, px.height() / sh) & QRectF(0, 0, 1, 1);
+}
+
+ImagePreprocessor::Options ImagePreprocessor::fromParams(const QMap<QString, QString>& params, const Options& defaults) {
+    Options options = defaults;
+    if (params.contains("preprocess")) {
+        options.denoise = false;
+        options.contrast = false;
+        options.crop = false;
+        options.deskew = false;
+        options.binarize = false;
+        const QStringList steps = params.value("preprocess").toLower().split(',', Qt::SkipEmptyParts);
+        for (const QString& rawStep : steps) {
+            const QString step = rawStep.trimmed();
+            if (step == "denoise" || step == "median") options.denoise = true;
+            else if (step == "contrast") options.contrast = true;
+            else if (step == "crop") options.crop = true;
+            else if (step == "deskew") options.deskew = true;
+            else if (step == "binarize" || step == "sauvola") options.binarize = true;
+            else if (step != "none") qWarning() << "ImagePreprocessor: 未知的预处理步骤" << step;
+        }
+    }
+
+    const int window = params.value("sauvola_window").toInt();
+    if (window >= 3) options.sauvolaWindow = window;
+    bool ok = false;
+    const double k = params.value("sauvola_k").toDouble(&ok);
+    if (ok && k > 0) options.sauvolaK = k;
+    return options;
+}
+
+ImagePreprocessor::Result ImagePreprocessor::process(const QImage& image, const Options& options) {
+    Result result;
+    result.sourceSize = image.size();
+    result.crop = QRect(QPoint(0, 0), image.size());
+
+    QImage gray = toGray(image);
+    if (gray.isNull()) {
+        result.image = gray;
+        return result;
+    }
+
+    // 去噪放在对比度之前：孤立噪点不再影响分位统计
+    if (options.denoise) {
+        gray = median3(gray);
+    }
+
+    if (options.contrast) {
+        normalizeContrast(gray);
+    }
+
+    if (options.crop) {
+        const QRect bounds = contentBounds(gray);
+        if (bounds != gray.rect()) {
+            gray = gray.copy(bounds);
+            result.crop = bounds;
+        }
+    }
+
+    if (options.deskew) {
+        const double skew = estimateSkew(gray, options.maxSkewDegrees);
+        if (qAbs(skew) >= kMinRotation) {
+            result.rotation = -skew;
+            gray = rotate(gray, result.rotation);
+        }
+    }
+
+    gray = upscale(gray, options.minWidth, &result.scale);
+
+    if (options.binarize) {
+        gray = sauvola(gray, options.sauvolaWindow, options.sauvolaK);
+    }
+
+    result.image = gray;
+    return result;
+}
+
+QImage ImagePreprocessor::toGray(const QImage& image) {
+    if (image.isNull() || image.format() == QImage::Format_Grayscale8) return image;
+    return image.convertToFormat(QImage::Format_Grayscale8);
+}
+
+void ImagePreprocessor::normalizeContrast(QImage& gray, double lowFraction, double highFraction) {
+    if (gray.isNull()) return;
+    const int w = gray.width();
+    const int h = gray.height();
+
+    qint64 histogram[256] = { 0 };
+    for (int y = 0; y < h; ++y) {
+        const uchar* line = gray.constScanLine(y);
+        for (int x = 0; x < w; ++x) {
+            histogram[line[x]]++;
+        }
+    }
+
+    // 两端各去掉少量极值像素 (噪点、黑边)，其余线性拉伸到 0-255
+    const qint64 total = qint64(w) * h;
+    const qint64 lowCount = qint64(total * lowFraction);
+    const qint64 highCount = qint64(total * (1.0 - highFraction));
+    int low = 0;
+    qint64 acc = 0;
+    for (; low < 255; ++low) {
+        acc += histogram[low];
+        if (acc > lowCount) break;
+    }
+    int high = 255;
+    acc = 0;
+    for (; high > 0; --high) {
+        acc += histogram[high];
+        if (acc > highCount) break;
+    }
+    // 已经铺满或几乎是单一灰度 (空白页) 时不处理
+    if (high - low < 16 || (low == 0 && high == 255)) return;
+
+    uchar lut[256];
+    for (int i = 0; i < 256; ++i) {
+        lut[i] = uchar(qBound(0, (i - low) * 255 / (high - low), 255));
+    }
+    for (int y = 0; y < h; ++y) {
+        uchar* line = gray.scanLine(y);
+        for (int x = 0; x < w; ++x) {
+            line[x] = lut[line[x]];
+        }
+    }
+}
+
+QRect ImagePreprocessor::contentBounds(const QImage& gray) {
+    const QRect full = gray.rect();
+    if (full.width() < 16 || full.height() < 16) return full;
+
+    // 1. 扫描黑边：深色占比很高的边缘行/列
+    QVector<int> rows;
+    QVector<int> cols;
+    darkProfiles(gray, full, rows, cols);
+    int top = 0, bottom = full.height(), left = 0, right = full.width();
+    const int rowBorder = int(full.width() * kBorderFraction);
+    const int colBorder = int(full.height() * kBorderFraction);
+    trimRange(rows, top, bottom, [rowBorder](int n) { return n > rowBorder; });
+    trimRange(cols, left, right, [colBorder](int n) { return n > colBorder; });
+    if (bottom - top < 16 || right - left < 16) return full;
+    const QRect inner(left, top, right - left, bottom - top);
+
+    // 2. 空白边距：黑边会抬高每行/列的计数，在去掉黑边的区域内重新统计
+    darkProfiles(gray, inner, rows, cols);
+    int contentTop = 0, contentBottom = inner.height(), contentLeft = 0, contentRight = inner.width();
+    const int rowEmpty = int(inner.width() * kEmptyFraction);
+    const int colEmpty = int(inner.height() * kEmptyFraction);
+    trimRange(rows, contentTop, contentBottom, [rowEmpty](int n) { return n <= rowEmpty; });
+    trimRange(cols, contentLeft, contentRight, [colEmpty](int n) { return n <= colEmpty; });
+    if (contentBottom <= contentTop || contentRight <= contentLeft) return full; // 空白页
+
+    // 保留少量留白，Tesseract 对紧贴边缘的文字识别较差
+    const QRect content(inner.left() + contentLeft, inner.top() + contentTop,
+                        contentRight - contentLeft, contentBottom - contentTop);
+    const int pad = qMax(8, qMin(full.width(), full.height()) / 50);
+    return content.adjusted(-pad, -pad, pad, pad) & inner;
+}
+
+double ImagePreprocessor::estimateSkew(const QImage& gray, double maxDegrees) {
+    if (gray.isNull()) return 0.0;
+    const int w = gray.width();
+    const int h = gray.height();
+
+    // 在稀疏网格上收集深色点，投影只对这些点做
+    const int step = qMax(1, qMax(w, h) / kSkewSampleSide);
+    QVector<int> xs;
+    QVector<int> ys;
+    for (int y = 0; y < h; y += step) {
+        const uchar* line = gray.constScanLine(y);
+        for (int x = 0; x < w; x += step) {
+            if (line[x] < kDarkThreshold) {
+                xs.append(x);
+                ys.append(y);
+            }
+        }
+    }
+    const int count = xs.size();
+    if (count < 64) return 0.0;
+
+    // 按角度 a 剪切投影到行：文本行方向与 a 一致时轮廓最尖锐，平方和最大
+    const int* px = xs.constData();
+    const int* py = ys.constData();
+    QVector<int> bins;
+    auto score = [&](double degrees) -> double {
+        const double t = std::tan(qDegreesToRadians(degrees));
+        const int offset = int(std::ceil(w * std::abs(t) / step)) + 1;
+        bins.fill(0, h / step + 2 * offset + 2);
+        int* b = bins.data();
+        const double inv = 1.0 / step;
+        for (int i = 0; i < count; ++i) {
+            b[int(std::floor((py[i] - px[i] * t) * inv)) + offset]++;
+        }
+        double sum = 0.0;
+        for (int v : bins) sum += double(v) * v;
+        return sum;
+    };
+
+    // 先 0.5° 粗搜，再在最优附近 0.1° 细搜；同分时偏向 0°
+    const double limit = qBound(0.0, maxDegrees, 45.0);
+    double best = 0.0;
+    double bestScore = score(0.0);
+    for (double a = -limit; a <= limit + 1e-9; a += 0.5) {
+        const double s = score(a);
+        if (s > bestScore) {
+            bestScore = s;
+            best = a;
+        }
+    }
+    const double center = best;
+    for (double a = center - 0.5; a <= center + 0.5 + 1e-9; a += 0.1) {
+        if (qAbs(a) > limit) continue;
+        const double s = score(a);
+        if (s > bestScore) {
+            bestScore = s;
+            best = a;
+        }
+    }
+    return best;
+}
+
+QImage ImagePreprocessor::rotate(const QImage& gray, double degrees) {
+    if (gray.isNull() || qFuzzyIsNull(degrees)) return gray;
+    const int w = gray.width();
+    const int h = gray.height();
+    QImage dst(w, h, QImage::Format_Grayscale8);
+
+    const double rad = qDegreesToRadians(degrees);
+    const double c = std::cos(rad);
+    const double s = std::sin(rad);
+    const double cx = (w - 1) / 2.0;
+    const double cy = (h - 1) / 2.0;
+    const uchar* src = gray.constBits();
+    const int bpl = gray.bytesPerLine();
+
+    // 反向映射 + 双线性插值；同一行内源坐标随 x 线性变化，逐像素只做加法
+    for (int y = 0; y < h; ++y) {
+        uchar* out = dst.scanLine(y);
+        const double dy = y - cy;
+        double sx = cx - c * cx + s * dy;
+        double sy = cy + s * cx + c * dy;
+        for (int x = 0; x < w; ++x, sx += c, sy -= s) {
+            const int x0 = int(std::floor(sx));
+            const int y0 = int(std::floor(sy));
+            if (x0 < 0 || y0 < 0 || x0 >= w - 1 || y0 >= h - 1) {
+                out[x] = 255;
+                continue;
+            }
+            const double fx = sx - x0;
+            const double fy = sy - y0;
+            const uchar* r0 = src + y0 * bpl + x0;
+            const uchar* r1 = r0 + bpl;
+            const double top = r0[0] + fx * (r0[1] - r0[0]);
+            const double bottom = r1[0] + fx * (r1[1] - r1[0]);
+            out[x] = uchar(top + fy * (bottom - top) + 0.5);
+        }
+    }
+    return dst;
+}
+
+QImage ImagePreprocessor::sauvola(const QImage& gray, int window, double k) {
+    if (gray.isNull()) return gray;
+    const int w = gray.width();
+    const int h = gray.height();
+    // 半径上限 127：列平方和 (2r+1) * 255² 不超过 32 位
+    const int r = qBound(1, window / 2, 127);
+    QImage dst(w, h, QImage::Format_Grayscale8);
+
+    // 列方向维护窗口内各列的和与平方和，行方向再滑动求和：每像素常数次加减
+    QVector<quint32> colSum(w, 0);
+    QVector<quint32> colSq(w, 0);
+    quint32* sumData = colSum.data();
+    quint32* sqData = colSq.data();
+    auto addRow = [&](int y) {
+        const uchar* line = gray.constScanLine(y);
+        for (int x = 0; x < w; ++x) {
+            sumData[x] += line[x];
+            sqData[x] += quint32(line[x]) * line[x];
+        }
+    };
+    auto removeRow = [&](int y) {
+        const uchar* line = gray.constScanLine(y);
+        for (int x = 0; x < w; ++x) {
+            sumData[x] -= line[x];
+            sqData[x] -= quint32(line[x]) * line[x];
+        }
+    };
+
+    for (int y = 0; y <= qMin(r, h - 1); ++y) addRow(y);
+    for (int y = 0; y < h; ++y) {
+        if (y > 0) {
+            if (y + r < h) addRow(y + r);
+            if (y - r - 1 >= 0) removeRow(y - r - 1);
+        }
+        const int rowCount = qMin(h - 1, y + r) - qMax(0, y - r) + 1;
+
+        quint64 sum = 0;
+        quint64 sq = 0;
+        for (int x = 0; x <= qMin(r, w - 1); ++x) {
+            sum += sumData[x];
+            sq += sqData[x];
+        }
+        const uchar* in = gray.constScanLine(y);
+        uchar* out = dst.scanLine(y);
+        for (int x = 0; x < w; ++x) {
+            if (x > 0) {
+                if (x + r < w) {
+                    sum += sumData[x + r];
+                    sq += sqData[x + r];
+                }
+                if (x - r - 1 >= 0) {
+                    sum -= sumData[x - r - 1];
+                    sq -= sqData[x - r - 1];
+                }
+            }
+            const double n = double(rowCount) * (qMin(w - 1, x + r) - qMax(0, x - r) + 1);
+            const double mean = sum / n;
+            const double variance = qMax(0.0, sq / n - mean * mean);
+            // T = m * (1 + k * (s / R - 1))，R 为 8 位灰度标准差的动态范围 128
+            const double threshold = mean * (1.0 + k * (std::sqrt(variance) / 128.0 - 1.0));
+            out[x] = in[x] > threshold ? 255 : 0;
+        }
+    }
+    return dst;
+}
+
+QImage ImagePreprocessor::upscale(const QImage& gray, int minWidth, int* scale) {
+    int factor = 1;
+    if (!gray.isNull() && minWidth > 0 && gray.width() < minWidth) {
+        factor = minWidth / gray.width() + 1;
+    }
+    if (scale) *scale = factor;
+    if (factor == 1) return gray;
+
+    // 平滑缩放可能输出 32 位格式，统一转回灰度
+    return toGray(gray.scaled(gray.width() * factor, gray.height() * factor,
+                              Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+
+QImage ImagePreprocessor::median3(const QImage& gray) {
+    if (gray.isNull() || gray.width() < 3 || gray.height() < 3) return gray;
+
+    const int w = gray.width();
+    const int h = gray.height();
+    QImage out(w, h, QImage::Format_Grayscale8);
+    for (int y = 0; y < h; ++y) {
+        const uchar* above = gray.constScanLine(qMax(0, y - 1));
+        const uchar* line = gray.constScanLine(y);
+        const uchar* below = gray.constScanLine(qMin(h - 1, y + 1));
+        uchar* dst = out.scanLine(y);
+        for (int x = 0; x < w; ++x) {
+            const int l = qMax(0, x - 1);
+            const int r = qMin(w - 1, x + 1);
+            uchar p[9] = { above[l], above[x], above[r], line[l], line[x], line[r], below[l], below[x], below[r] };
+            // 9 元素中值的 19 次比较排序网络 (Paeth)
+            sortPair(p[1], p[2]); sortPair(p[4], p[5]); sortPair(p[7], p[8]);
+            sortPair(p[0], p[1]); sortPair(p[3], p[4]); sortPair(p[6], p[7]);
+            sortPair(p[1], p[2]); sortPair(p[4], p[5]); sortPair(p[7], p[8]);
+            sortPair(p[0], p[3]); sortPair(p[5], p[8]); sortPair(p[4], p[7]);
+            sortPair(p[3], p[6]); sortPair(p[1], p[4]); sortPair(p[2], p[5]);
+            sortPair(p[4], p[7]); sortPair(p[4], p[2]); sortPair(p[6], p[4]);
+            sortPair(p[4], p[2]);
+            dst[x] = p[4];
+        }
+    }
+    return out;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <QImage>
+#include <QMap>
+#include <QRect>
+#include <QRectF>
+#include <QString>
+
+// 识别前的图像预处理
+// 本地引擎与 (可选) 上传 VLM 前共用。所有内核都直接在 8 位灰度扫描行上做整数/浮点循环，
+// 不逐像素调用 QImage::pixel，便于编译器自动向量化：
+//   - denoise   3×3 中值滤波，去掉扫描与 JPEG 压缩带来的椒盐噪点，保留笔画边缘
+//   - contrast  对比度归一化：按 1% / 99% 分位线性拉伸
+//   - crop      裁掉扫描黑边与空白页边距
+//   - deskew    投影轮廓法估计倾斜角并旋转校正
+//   - binarize  Sauvola 自适应阈值 (滑动窗口累加和，每像素 O(1)，只需 O(宽度) 额外内存)
+// 裁剪、旋转、放大会改变坐标，识别结果中的文本框用 Result::mapToSource 映射回原图
+class ImagePreprocessor {
+public:
+    struct Options {
+        bool denoise = false;
+        bool contrast = false;
+        bool crop = false;
+        bool deskew = false;
+        bool binarize = false;
+        int minWidth = 0;               // 宽度小于此值时按整数倍放大，0 表示不放大
+        int sauvolaWindow = 31;         // Sauvola 窗口边长 (像素)
+        double sauvolaK = 0.34;
+        double maxSkewDegrees = 5.0;    // 倾斜角搜索范围 ±
+
+        bool isEnabled() const { return denoise || contrast || crop || deskew || binarize || minWidth > 0; }
+    };
+
+    struct Result {
+        QImage image;               // 处理后的灰度图 (Grayscale8)
+        QSize sourceSize;           // 原图尺寸
+        QRect crop;                 // 原图中保留的区域
+        double rotation = 0.0;      // 校正时旋转的角度 (度，顺时针为正)
+        int scale = 1;              // 整数倍放大系数
+
+        // 处理后图像上的归一化框 → 原图归一化框
+        QRectF mapToSource(const QRectF& box) const;
+    };
+
+    // 从模型参数读取：preprocess 为逗号分隔的步骤 (denoise,contrast,crop,deskew,binarize)，"none" 表示全部关闭；
+    // sauvola_window / sauvola_k 调整二值化。未配置 preprocess 时使用 defaults
+    static Options fromParams(const QMap<QString, QString>& params, const Options& defaults = Options());
+
+    // 依次执行：灰度 → 去噪 → 对比度 → 裁边 → 纠偏 → 放大 → 二值化
+    static Result process(const QImage& image, const Options& options);
+
+    // ---- 单个内核 (输入输出均为 Grayscale8) ----
+    static QImage toGray(const QImage& image);
+    // 3×3 中值滤波，边缘按最近像素延拓
+    static QImage median3(const QImage& gray);
+    static void normalizeContrast(QImage& gray, double lowFraction = 0.01, double highFraction = 0.99);
+    // 内容区域 (去掉黑边与空白边距后加少量留白)，找不到内容时返回整图
+    static QRect contentBounds(const QImage& gray);
+    // 文本行相对水平方向的倾斜角 (度，顺时针为正)
+    static double estimateSkew(const QImage& gray, double maxDegrees = 5.0);
+    // 绕中心旋转 (度，顺时针为正)，尺寸不变，超出部分填白
+    static QImage rotate(const QImage& gray, double degrees);
+    static QImage sauvola(const QImage& gray, int window = 31, double k = 0.34);
+    static QImage upscale(const QImage& gray, int minWidth, int* scale = nullptr);
+};
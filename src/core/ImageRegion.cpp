@@ -0,0 +1,104 @@
+#include "ImageRegion.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+
+namespace {
+// 父文本块与区域的重叠面积超过自身面积的该比例时视为被区域结果替换
+const qreal kReplaceOverlap = 0.5;
+
+void releaseSource(void* info) {
+    delete static_cast<QImage*>(info);
+}
+}
+
+QImage ImageRegion::view(const QImage& image, const QRect& rect) {
+    if (image.isNull() || rect.isEmpty() || !image.rect().contains(rect)) {
+        return QImage();
+    }
+    if (rect == image.rect()) {
+        return image;
+    }
+    // 行内偏移必须按整字节计算
+    if (image.depth() < 8) {
+        return image.copy(rect);
+    }
+
+    // 原图的浅拷贝随视图一起释放，保证像素缓冲在视图 (及其未修改的副本) 存活期间有效
+    QImage* source = new QImage(image);
+    const uchar* bits = source->constBits() + rect.y() * source->bytesPerLine() + rect.x() * (source->depth() / 8);
+    QImage region(bits, rect.width(), rect.height(), source->bytesPerLine(), source->format(),
+                  releaseSource, source);
+    if (source->format() == QImage::Format_Indexed8) {
+        region.setColorTable(source->colorTable());
+    }
+    region.setDotsPerMeterX(source->dotsPerMeterX());
+    region.setDotsPerMeterY(source->dotsPerMeterY());
+    return region;
+}
+
+OCRResult ImageRegion::merge(const OCRResult& parent, const QSize& imageSize,
+                             const QRect& region, const OCRResult& regionResult) {
+    OCRResult merged = parent;
+    merged.success = true;
+    merged.errorMessage.clear();
+    merged.processingTimeMs = regionResult.processingTimeMs;
+    merged.fromCache = regionResult.fromCache;
+    merged.timestamp = QDateTime::currentDateTime();
+    if (imageSize.isEmpty()) {
+        return merged;
+    }
+
+    const qreal fullW = imageSize.width();
+    const qreal fullH = imageSize.height();
+    const QRectF area(region.x() / fullW, region.y() / fullH, region.width() / fullW, region.height() / fullH);
+
+    // 区域内的文本块映射回整图归一化坐标；区域结果没有版面信息时整段作为一个块
+    QVector<TextBlock> blocks;
+    for (const TextBlock& block : regionResult.textBlocks) {
+        TextBlock mapped = block;
+        const QRectF& b = block.boundingBox;
+        mapped.boundingBox = QRectF(area.x() + b.x() * area.width(), area.y() + b.y() * area.height(),
+                                    b.width() * area.width(), b.height() * area.height());
+        blocks.append(mapped);
+    }
+    if (blocks.isEmpty() && !regionResult.fullText.trimmed().isEmpty()) {
+        TextBlock block;
+        block.text = regionResult.fullText.trimmed();
+        block.boundingBox = area;
+        block.confidence = 1.0f;
+        blocks.append(block);
+    }
+
+    int insertAt = -1;
+    for (int i = merged.textBlocks.size() - 1; i >= 0; --i) {
+        const QRectF& box = merged.textBlocks.at(i).boundingBox;
+        const QRectF overlap = box & area;
+        const qreal boxArea = box.width() * box.height();
+        if (boxArea > 0 && overlap.width() * overlap.height() >= boxArea * kReplaceOverlap) {
+            merged.textBlocks.remove(i);
+            insertAt = i;
+        }
+    }
+
+    if (insertAt < 0) {
+        merged.textBlocks += blocks;
+        return merged;
+    }
+    for (int i = 0; i < blocks.size(); ++i) {
+        merged.textBlocks.insert(insertAt + i, blocks.at(i));
+    }
+    merged.mergeFullText();
+    return merged;
+}
+
+QString ImageRegion::mergedHash(const QString& parentHash, const QRect& region, const QString& regionHash) {
+    if (regionHash.isEmpty()) {
+        return QString();
+    }
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    hasher.addData(parentHash.toUtf8());
+    hasher.addData(QString("|region:%1,%2,%3x%4|").arg(region.x()).arg(region.y())
+                       .arg(region.width()).arg(region.height()).toUtf8());
+    hasher.addData(regionHash.toUtf8());
+    return QString::fromLatin1(hasher.result().toHex());
+}
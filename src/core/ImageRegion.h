@@ -0,0 +1,24 @@
+#pragma once
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include "OCRResult.h"
+
+// 区域重识别
+// 整图识别后对其中一块 (表格、段落) 换提示词或模型重新识别，不需要重新截图：
+//   - view() 返回子区域的只读视图，与原图共享像素，不复制整图
+//   - merge() 把区域结果的文本块映射回整图坐标，替换父结果中落在区域内的文本块
+class ImageRegion {
+public:
+    // 子区域视图 (rect 为原图像素坐标，需已裁剪到图片范围内)
+    // 视图持有原图的一份引用，原图被修改或释放后视图仍然有效；位深不足 8 的格式退回 copy()
+    static QImage view(const QImage& image, const QRect& rect);
+
+    // 合并区域结果：与区域重叠过半的父文本块被移除，区域文本块按阅读顺序插入到原位置
+    // 父结果有文本块被替换时重新生成 fullText；否则 (如 VLM 整页只有一个块) 保留原 fullText，只追加区域文本块
+    static OCRResult merge(const OCRResult& parent, const QSize& imageSize,
+                           const QRect& region, const OCRResult& regionResult);
+
+    // 合并结果的内容哈希：由整图哈希、区域矩形与区域请求哈希派生，与整图请求的缓存键不冲突
+    static QString mergedHash(const QString& parentHash, const QRect& region, const QString& regionHash);
+};
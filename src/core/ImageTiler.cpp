@@ -0,0 +1,153 @@
+#include "ImageTiler.h"
+#include <QStringList>
+#include <QtMath>
+
+namespace {
+// 接缝处最多比较的行数
+const int kMaxSeamLines = 5;
+}
+
+const int ImageTiler::kMinMaxSide;
+
+ImageTiler::Options ImageTiler::fromParams(const QMap<QString, QString>& params) {
+    Options options;
+    options.maxSide = qMax(0, params.value("tile_max_side", "0").toInt());
+    // 手工编辑的配置可能写入过小的值，抬到下限而不是切出大量分块
+    if (options.maxSide > 0 && options.maxSide < kMinMaxSide) {
+        options.maxSide = kMinMaxSide;
+    }
+    options.overlap = qMax(0, params.value("tile_overlap", "128").toInt());
+    // 重叠不能超过分块的一半，否则步长过小
+    if (options.maxSide > 0) {
+        options.overlap = qMin(options.overlap, options.maxSide / 2);
+    }
+    return options;
+}
+
+bool ImageTiler::needsTiling(const QSize& imageSize, const Options& options) {
+    return options.maxSide > 0
+        && (imageSize.width() > options.maxSide || imageSize.height() > options.maxSide);
+}
+
+QVector<QRect> ImageTiler::plan(const QSize& imageSize, const Options& options) {
+    QVector<QRect> tiles;
+    if (!needsTiling(imageSize, options)) {
+        tiles.append(QRect(QPoint(0, 0), imageSize));
+        return tiles;
+    }
+
+    // 每个方向均分为 n 块，使分块尺寸接近且不超过 maxSide
+    const int step = options.maxSide - options.overlap;
+    auto count = [&](int length) {
+        if (length <= options.maxSide) return 1;
+        return qCeil(static_cast<qreal>(length - options.overlap) / step);
+    };
+    const int cols = count(imageSize.width());
+    const int rows = count(imageSize.height());
+    const int tileW = cols == 1 ? imageSize.width() : qCeil(static_cast<qreal>(imageSize.width() + (cols - 1) * options.overlap) / cols);
+    const int tileH = rows == 1 ? imageSize.height() : qCeil(static_cast<qreal>(imageSize.height() + (rows - 1) * options.overlap) / rows);
+
+    tiles.reserve(rows * cols);
+    for (int r = 0; r < rows; ++r) {
+        const int y = qMin(r * (tileH - options.overlap), imageSize.height() - tileH);
+        for (int c = 0; c < cols; ++c) {
+            const int x = qMin(c * (tileW - options.overlap), imageSize.width() - tileW);
+            tiles.append(QRect(qMax(0, x), qMax(0, y), tileW, tileH).intersected(QRect(QPoint(0, 0), imageSize)));
+        }
+    }
+    return tiles;
+}
+
+QRectF ImageTiler::coreRegion(const QRect& tile, const QSize& imageSize, int overlap) {
+    // 有相邻分块的一侧各让出一半重叠区
+    const qreal half = overlap / 2.0;
+    qreal left = tile.left() > 0 ? tile.left() + half : 0;
+    qreal top = tile.top() > 0 ? tile.top() + half : 0;
+    qreal right = tile.right() + 1 < imageSize.width() ? tile.right() + 1 - half : imageSize.width();
+    qreal bottom = tile.bottom() + 1 < imageSize.height() ? tile.bottom() + 1 - half : imageSize.height();
+    return QRectF(QPointF(left, top), QPointF(right, bottom));
+}
+
+QString ImageTiler::joinWithoutSeamDuplicates(const QString& accumulated, const QString& next) {
+    if (accumulated.isEmpty()) return next;
+    if (next.isEmpty()) return accumulated;
+
+    const QStringList prevLines = accumulated.split('\n');
+    QStringList nextLines = next.split('\n');
+
+    // 前一块的末尾几行与后一块的开头几行相同，说明来自重叠区
+    int dup = 0;
+    for (int k = qMin(kMaxSeamLines, qMin(prevLines.size(), nextLines.size())); k > 0; --k) {
+        bool same = true;
+        for (int i = 0; i < k && same; ++i) {
+            const QString a = prevLines.at(prevLines.size() - k + i).trimmed();
+            const QString b = nextLines.at(i).trimmed();
+            same = !a.isEmpty() && a == b;
+        }
+        if (same) {
+            dup = k;
+            break;
+        }
+    }
+    for (int i = 0; i < dup; ++i) nextLines.removeFirst();
+    return nextLines.isEmpty() ? accumulated : accumulated + "\n" + nextLines.join('\n');
+}
+
+OCRResult ImageTiler::merge(const QSize& imageSize, const QVector<QRect>& tiles,
+                            const QVector<OCRResult>& results, const Options& options) {
+    OCRResult merged;
+    merged.success = true;
+    merged.timestamp = QDateTime::currentDateTime();
+
+    const qreal fullW = imageSize.width();
+    const qreal fullH = imageSize.height();
+    QStringList errors;
+    QString text;
+    int row = -1;
+    QString rowText;
+
+    for (int i = 0; i < tiles.size() && i < results.size(); ++i) {
+        const QRect& tile = tiles.at(i);
+        const OCRResult& result = results.at(i);
+        if (merged.modelName.isEmpty()) merged.modelName = result.modelName;
+        // 分块并发执行，取最慢一块作为整体耗时 (调用方可用实际墙钟时间覆盖)
+        merged.processingTimeMs = qMax(merged.processingTimeMs, result.processingTimeMs);
+
+        if (!result.success) {
+            errors << QString("分块 %1: %2").arg(i + 1).arg(result.errorMessage);
+            continue;
+        }
+
+        // 同一行的分块按列拼接，行之间换行
+        if (tile.top() != row) {
+            text = joinWithoutSeamDuplicates(text, rowText);
+            rowText.clear();
+            row = tile.top();
+        }
+        rowText = joinWithoutSeamDuplicates(rowText, result.fullText.trimmed());
+
+        const QRectF core = coreRegion(tile, imageSize, options.overlap);
+        for (const TextBlock& block : result.textBlocks) {
+            TextBlock mapped = block;
+            const QRectF& b = block.boundingBox;
+            mapped.boundingBox = QRectF((tile.x() + b.x() * tile.width()) / fullW,
+                                        (tile.y() + b.y() * tile.height()) / fullH,
+                                        b.width() * tile.width() / fullW,
+                                        b.height() * tile.height() / fullH);
+            const QPointF center(mapped.boundingBox.center().x() * fullW,
+                                 mapped.boundingBox.center().y() * fullH);
+            if (core.contains(center)) {
+                merged.textBlocks.append(mapped);
+            }
+        }
+    }
+    text = joinWithoutSeamDuplicates(text, rowText);
+
+    merged.fullText = text;
+    if (!errors.isEmpty()) {
+        // 部分分块失败时保留已识别内容，整体仍标记失败以便重试
+        merged.success = false;
+        merged.errorMessage = errors.join("; ");
+    }
+    return merged;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <QMap>
+#include <QSize>
+#include <QRect>
+#include <QVector>
+#include "OCRResult.h"
+
+// 超大图片分块
+// 长边超过阈值的图片切成带重叠的分块分别识别，再把结果合并回整图：
+//   - 文本块边界框从分块内的归一化坐标映射回整图归一化坐标
+//   - 重叠区域内的文本块只保留中心落在本块"核心区"的那一份
+//   - 按行拼接 fullText，相邻分块接缝处重复的行去掉
+class ImageTiler {
+public:
+    struct Options {
+        int maxSide = 0;    // 分块最长边 (像素)，0 表示不分块
+        int overlap = 128;  // 相邻分块重叠像素
+    };
+
+    // 分块最长边的下限：过小的值会切出成百上千个分块，每块都是一次模型请求
+    static const int kMinMaxSide = 512;
+
+    // 从模型参数读取 (tile_max_side / tile_overlap)，tile_max_side 介于 0 与 kMinMaxSide 之间时按 kMinMaxSide 处理
+    static Options fromParams(const QMap<QString, QString>& params);
+
+    static bool needsTiling(const QSize& imageSize, const Options& options);
+
+    // 按行优先顺序返回分块矩形
+    static QVector<QRect> plan(const QSize& imageSize, const Options& options);
+
+    // 合并各分块结果 (与 plan() 返回的顺序一一对应)
+    static OCRResult merge(const QSize& imageSize, const QVector<QRect>& tiles,
+                           const QVector<OCRResult>& results, const Options& options);
+
+private:
+    static QRectF coreRegion(const QRect& tile, const QSize& imageSize, int overlap);
+    static QString joinWithoutSeamDuplicates(const QString& accumulated, const QString& next);
+};
@@ -0,0 +1,88 @@
+#include "MicroBatcher.h"
+#include <QDebug>
+#include <QElapsedTimer>
+
+MicroBatcher::Options MicroBatcher::optionsFor(const ModelAdapter* adapter) {
+    Options options;
+    if (!adapter) return options;
+    options.maxBatch = qMax(1, adapter->preferredBatchSize());
+    const int waitMs = adapter->config().params.value("batch_wait_ms").toInt();
+    if (waitMs > 0) options.maxWaitMs = waitMs;
+    return options;
+}
+
+OCRResult MicroBatcher::recognize(ModelAdapter* adapter, const QString& modelId, const QImage& image,
+                                  const QString& prompt, const Options& options) {
+    if (options.maxBatch <= 1) {
+        return adapter->recognize(image, prompt);
+    }
+
+    const QString key = modelId + QLatin1Char('\n') + prompt;
+    QMutexLocker locker(&m_mutex);
+
+    // 跟随者：加入已在等待的批
+    QSharedPointer<Batch> batch = m_open.value(key);
+    if (batch) {
+        const int index = batch->images.size();
+        batch->images.append(image);
+        if (batch->images.size() >= options.maxBatch) {
+            m_open.remove(key);
+            batch->filled.wakeAll();
+        }
+        while (!batch->done) {
+            batch->finished.wait(&m_mutex);
+        }
+        return batch->results.at(index);
+    }
+
+    // 执行者：发起新批，等待凑满或超时
+    batch.reset(new Batch());
+    batch->images.append(image);
+    m_open.insert(key, batch);
+    QElapsedTimer timer;
+    timer.start();
+    while (batch->images.size() < options.maxBatch) {
+        const qint64 remaining = options.maxWaitMs - timer.elapsed();
+        if (remaining <= 0) break;
+        batch->filled.wait(&m_mutex, static_cast<unsigned long>(remaining));
+    }
+    if (m_open.value(key) == batch) {
+        m_open.remove(key);
+    }
+    const QVector<QImage> images = batch->images;
+    locker.unlock();
+
+    QVector<OCRResult> results;
+    try {
+        results = adapter->recognizeBatch(images, prompt);
+    } catch (const std::exception& e) {
+        results.clear();
+        OCRResult failed;
+        failed.errorMessage = QString("异常: %1").arg(e.what());
+        results.fill(failed, images.size());
+    } catch (...) {
+        // 跟随者在等待本批结果，任何异常都不能跳过下面的唤醒
+        results.clear();
+        OCRResult failed;
+        failed.errorMessage = "未知异常";
+        results.fill(failed, images.size());
+    }
+    if (results.size() != images.size()) {
+        qWarning() << "MicroBatcher: 批量识别返回" << results.size() << "个结果，期望" << images.size();
+        OCRResult failed;
+        failed.errorMessage = "批量识别结果数量不符";
+        results.resize(images.size());
+        for (int i = 0; i < results.size(); ++i) {
+            if (!results.at(i).success && results.at(i).errorMessage.isEmpty()) results[i] = failed;
+        }
+    }
+    if (images.size() > 1) {
+        qDebug() << "MicroBatcher:" << modelId << "合并" << images.size() << "个请求";
+    }
+
+    locker.relock();
+    batch->results = results;
+    batch->done = true;
+    batch->finished.wakeAll();
+    return results.first();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include "ModelAdapter.h"
+
+// 识别请求攒批
+// 适配器声明 preferredBatchSize() > 1 时，同一模型、同一提示词的并发请求合并为一次 recognizeBatch()：
+//   - 第一个到达的任务线程成为本批的执行者，最多等待 batch_wait_ms (默认 20ms) 或凑满批大小
+//   - 之后到达的任务加入该批并阻塞，执行者识别完成后按下标取回各自的结果
+// 不额外占用线程或定时器；跟随者等待的时间就是攒批省下的模型调用
+// 所有接口线程安全，在流水线工作线程中调用
+class MicroBatcher {
+public:
+    struct Options {
+        int maxBatch = 1;       // 每批最多请求数，1 表示不攒批
+        int maxWaitMs = 20;     // 执行者最多等待的时间
+    };
+
+    // 批大小取适配器的 preferredBatchSize()，等待时间读取模型参数 batch_wait_ms (在提交线程调用)
+    static Options optionsFor(const ModelAdapter* adapter);
+
+    // 加入 (或发起) 一批识别，阻塞直到本项结果可用；modelId 与 prompt 相同的请求才会合并
+    OCRResult recognize(ModelAdapter* adapter, const QString& modelId, const QImage& image,
+                        const QString& prompt, const Options& options);
+
+private:
+    struct Batch {
+        QVector<QImage> images;
+        QVector<OCRResult> results;
+        bool done = false;
+        QWaitCondition filled;      // 批已凑满
+        QWaitCondition finished;    // 结果已就绪
+    };
+
+    QMutex m_mutex;
+    QHash<QString, QSharedPointer<Batch>> m_open;   // 仍可加入的批：模型 ID + 提示词
+};
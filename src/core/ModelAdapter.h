@@ -34,6 +34,20 @@ public:
     // 识别图像
     virtual OCRResult recognize(const QImage& image, const QString& prompt = QString()) = 0;
     
+    // 批量识别（同一提示词），结果与 images 一一对应
+    // 默认逐张调用 recognize()；能在一次调用中摊薄开销的引擎（本地批量推理、多图消息）可重写
+    virtual QVector<OCRResult> recognizeBatch(const QVector<QImage>& images, const QString& prompt = QString()) {
+        QVector<OCRResult> results;
+        results.reserve(images.size());
+        for (const QImage& image : images) {
+            results.append(recognize(image, prompt));
+        }
+        return results;
+    }
+
+    // 建议的批大小，大于 1 时流水线会把并发请求攒成一批调用 recognizeBatch()
+    virtual int preferredBatchSize() const { return 1; }
+    
     // 是否已初始化
     virtual bool isInitialized() const = 0;
     
@@ -1,19 +1,35 @@
 #include "OCRPipeline.h"
+#include "ContentHash.h"
+#include "ImageTiler.h"
+#include "ImagePreprocessor.h"
+#include "ImageRegion.h"
+#include <QtConcurrent>
 #include <QDebug>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QMetaObject>
+#include <QThread>
+
+namespace {
+// 识别线程池的线程数上限 (各模型自适应并发之和可能很大)
+const int kMaxPoolThreads = 128;
+}
 
 OCRPipeline::OCRPipeline(QObject *parent)
     : QObject(parent), m_currentAdapter(nullptr), 
-    m_threadPool(QThreadPool::globalInstance())   // 默认用的是全局线程池的默认并发（≈CPU 核心数）
+    m_threadPool(new QThreadPool(this)),   // 独立线程池：线程数跟随各模型的自适应并发上限，不受 CPU 核心数限制
+    m_tilePool(new QThreadPool(this))
 {
-    // 配置线程池
-    // m_threadPool->setMaxThreadCount(4);
+    // 配置线程池：起始为 CPU 核心数，模型的并发上限确定或变化后由 updatePoolSize() 调整
+    m_threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    m_tilePool->setMaxThreadCount(4);
 }
 
 OCRPipeline::~OCRPipeline()
 {
     // 等待所有任务完成
     m_threadPool->waitForDone();
+    m_tilePool->waitForDone();
 }
 
 void OCRPipeline::setCurrentAdapter(ModelAdapter *adapter)
@@ -22,88 +38,396 @@ void OCRPipeline::setCurrentAdapter(ModelAdapter *adapter)
     if (m_currentAdapter)
     {
         qDebug() << "OCRPipeline: 当前适配器设置为" << m_currentAdapter->config().displayName;
+        concurrencyLimit(m_currentAdapter);   // 按该模型的并发上限调整线程池
     }
 }
 
+void OCRPipeline::setCacheLookup(const CacheLookup &lookup)
+{
+    m_cacheLookup = lookup;
+}
+
+void OCRPipeline::setNearDuplicateLookup(const NearDuplicateLookup &lookup)
+{
+    m_nearDuplicateLookup = lookup;
+}
+
+void OCRPipeline::setCacheStore(const CacheStore &store)
+{
+    m_cacheStore = store;
+}
+
 void OCRPipeline::submitImage(const QImage &image, SubmitSource source, const QString &prompt, const QString &contextId)
 {
-    if (!m_currentAdapter)
+    OCRRequest request;
+    request.image = image;
+    request.source = source;
+    request.prompt = prompt;
+    request.contextId = contextId;
+    submit(request);
+}
+
+void OCRPipeline::submitRegion(const OCRResult &parent, const QImage &image, const QRect &region,
+                               const QString &prompt, ModelAdapter *adapter, const QString &contextId)
+{
+    OCRRequest request;
+    request.image = image;
+    request.region = region;
+    request.parent = parent;
+    request.prompt = prompt;
+    request.adapter = adapter;
+    request.contextId = contextId.isEmpty() ? parent.contextId : contextId;
+    submit(request);
+}
+
+void OCRPipeline::submit(const OCRRequest &request)
+{
+    ModelAdapter *adapter = request.adapter ? request.adapter.data() : m_currentAdapter;
+    if (!adapter)
     {
-        emit recognitionFailed("未选择模型适配器", image, source, contextId);
+        emit recognitionFailed("未选择模型适配器", request.image, request.source, request.contextId);
         return;
     }
 
     // 允许空图片（用于纯文本AI询问）
-    if (image.isNull())
+    if (request.image.isNull() && request.imageLoader)
+    {
+        qDebug() << "OCRPipeline: 提交文件（工作线程解码）" << request.filePath
+                 << "来源:" << static_cast<int>(request.source);
+    }
+    else if (request.image.isNull())
     {
         qDebug() << "OCRPipeline: 无图片，将进行纯文本AI询问";
     }
+    else if (!request.region.isNull())
+    {
+        qDebug() << "OCRPipeline: 提交区域重识别" << request.region
+                 << "原图:" << request.image.width() << "x" << request.image.height();
+    }
     else
     {
         qDebug() << "OCRPipeline: 提交图片"
-                 << image.width() << "x" << image.height()
-                 << "来源:" << static_cast<int>(source);
+                 << request.image.width() << "x" << request.image.height()
+                 << "来源:" << static_cast<int>(request.source);
     }
 
-    emit recognitionStarted(image, source, contextId);
+    emit recognitionStarted(request.image, request.source, request.contextId);
 
-    // 创建异步任务
-    OCRTask *task = new OCRTask(m_currentAdapter, image, source, prompt, contextId, this);
+    // 创建异步任务（哈希与缓存探测都在工作线程中完成，不阻塞界面）
+    OCRTask *task = new OCRTask(adapter, request,
+                                request.useCache ? m_cacheLookup : CacheLookup(),
+                                request.useCache ? m_nearDuplicateLookup : NearDuplicateLookup(),
+                                m_cacheStore, m_tilePool, concurrencyLimit(adapter), &m_batcher, this);
 
     // 连接信号（使用 Qt::QueuedConnection 确保跨线程安全）
+    // 先把模型调用的延迟与过载错误反馈给并发控制器，再转发给界面
+    const QString modelId = adapter->config().id;
+    connect(task, &OCRTask::finished, this, [this, modelId](const OCRResult &result) {
+        if (!result.fromCache)
+        {
+            m_concurrency.recordSuccess(modelId, result.processingTimeMs);
+            updatePoolSize(modelId, m_concurrency.limit(modelId));
+        }
+    }, Qt::QueuedConnection);
+    connect(task, &OCRTask::error, this, [this, modelId](const QString &errorMsg) {
+        if (AdaptiveConcurrency::isOverloadError(errorMsg))
+        {
+            m_concurrency.recordOverload(modelId);
+            updatePoolSize(modelId, m_concurrency.limit(modelId));
+        }
+    }, Qt::QueuedConnection);
     connect(task, &OCRTask::finished, this, &OCRPipeline::recognitionCompleted, Qt::QueuedConnection);
     connect(task, &OCRTask::error, this, &OCRPipeline::recognitionFailed, Qt::QueuedConnection);
 
-    // 提交到线程池
-    m_threadPool->start(task);
+    // 提交到线程池（排队时按优先级出队）
+    m_threadPool->start(task, request.priority);
+}
+
+int OCRPipeline::concurrencyLimit(ModelAdapter *adapter)
+{
+    if (!adapter)
+    {
+        adapter = m_currentAdapter;
+    }
+    if (!adapter)
+    {
+        return AdaptiveConcurrency::Limits().initial;
+    }
+    const ModelConfig config = adapter->config();
+    const int limit = m_concurrency.limit(config.id, AdaptiveConcurrency::limitsFromParams(config.params));
+    updatePoolSize(config.id, limit);
+    return limit;
+}
+
+void OCRPipeline::updatePoolSize(const QString &modelId, int limit)
+{
+    if (m_modelLimits.value(modelId) == limit)
+    {
+        return;
+    }
+    m_modelLimits.insert(modelId, limit);
+
+    // 批量矩阵中多个模型同时运行，线程数取各模型上限之和；空闲线程会自动回收，上限偏大没有额外开销
+    int total = 0;
+    for (int value : m_modelLimits)
+    {
+        total += value;
+    }
+    const int threads = qBound(qMax(1, QThread::idealThreadCount()), total, kMaxPoolThreads);
+    if (threads != m_threadPool->maxThreadCount())
+    {
+        m_threadPool->setMaxThreadCount(threads);
+        qDebug() << "OCRPipeline: 线程池上限调整为" << threads << "(" << modelId << "并发" << limit << ")";
+    }
 }
 
 // OCRTask 实现
 OCRTask::OCRTask(ModelAdapter *adapter,
-                 const QImage &image,
-                 SubmitSource source,
-                 const QString &prompt,
-                 const QString &contextId,
+                 const OCRRequest &request,
+                 const OCRPipeline::CacheLookup &cacheLookup,
+                 const OCRPipeline::NearDuplicateLookup &nearDuplicateLookup,
+                 const OCRPipeline::CacheStore &cacheStore,
+                 QThreadPool *tilePool,
+                 int tileConcurrency,
+                 MicroBatcher *batcher,
                  QObject *receiver)
-    : m_adapter(adapter), m_image(image), m_source(source), m_prompt(prompt), m_contextId(contextId), m_receiver(receiver)
+    : m_adapter(adapter), m_request(request), m_cacheLookup(cacheLookup),
+      m_nearDuplicateLookup(nearDuplicateLookup), m_cacheStore(cacheStore),
+      m_tilePool(tilePool), m_tileConcurrency(qMax(1, tileConcurrency)), m_batcher(batcher), m_receiver(receiver)
 {
+    // 在提交线程复制配置快照，避免工作线程读取可能被修改的适配器配置
+    if (adapter)
+    {
+        m_config = adapter->config();
+        m_batchOptions = MicroBatcher::optionsFor(adapter);
+    }
     setAutoDelete(true); // 任务完成后自动删除
 }
 
+bool OCRTask::probeCache(const QImage &image, OCRResult &result)
+{
+    // 阶段一：内容哈希（PNG 编码 + MD5，大图耗时明显，放在工作线程）
+    m_contentHash = ContentHash::compute(image, m_request.prompt, m_config.id, m_config.params);
+    if (m_contentHash.isEmpty())
+    {
+        return false;
+    }
+
+    // 近似去重按模型开启：phash_threshold 为允许的最大汉明距离（0 表示关闭）
+    const int threshold = m_config.params.value("phash_threshold", "0").toInt();
+    if (threshold > 0)
+    {
+        m_requestKey = ContentHash::requestKey(m_request.prompt, m_config.id, m_config.params);
+        m_perceptualHash = ContentHash::perceptual(image);
+    }
+
+    // 阶段二：精确缓存探测（内存 LRU → 布隆过滤器 → 数据库）
+    bool hit = m_cacheLookup && m_cacheLookup(m_contentHash, result) && result.success;
+
+    // 阶段三：近似缓存探测（同一请求键下感知哈希相近的截图）
+    if (!hit && threshold > 0 && m_perceptualHash != 0 && m_nearDuplicateLookup)
+    {
+        hit = m_nearDuplicateLookup(m_requestKey, m_perceptualHash, threshold, result) && result.success;
+    }
+
+    if (!hit)
+    {
+        return false;
+    }
+
+    result.fromCache = true;
+    result.processingTimeMs = 0;
+    result.timestamp = QDateTime::currentDateTime();
+    return true;
+}
+
+void OCRTask::stampHashes(OCRResult &result) const
+{
+    result.contentHash = m_contentHash;
+    result.requestKey = m_requestKey;
+    result.perceptualHash = m_perceptualHash;
+}
+
+OCRResult OCRTask::mergeRegion(const QSize &imageSize, const OCRResult &regionResult) const
+{
+    const QRect region = m_request.region & QRect(QPoint(0, 0), imageSize);
+    OCRResult merged = ImageRegion::merge(m_request.parent, imageSize, region, regionResult);
+
+    // 合并结果不能沿用整图哈希：历史记录会以 contentHash 写入结果缓存，覆盖整图请求的缓存结果
+    // 改用 整图哈希 + 区域矩形 + 区域请求哈希 (图片、提示词、模型与参数) 派生的键，也不参与近似去重
+    merged.contentHash = ImageRegion::mergedHash(m_request.parent.contentHash, region, m_contentHash);
+    merged.requestKey.clear();
+    merged.perceptualHash = 0;
+    return merged;
+}
+
+OCRResult OCRTask::recognize(const QImage &image)
+{
+    // 参数 preprocess 指定的预处理在上传前执行 (Tesseract 在适配器内自行预处理)
+    const ImagePreprocessor::Options preprocess = ImagePreprocessor::fromParams(m_config.params);
+    if (m_config.engine == "tesseract" || !preprocess.isEnabled() || image.isNull())
+    {
+        return recognizeTiles(image);
+    }
+
+    const ImagePreprocessor::Result prepared = ImagePreprocessor::process(image, preprocess);
+    OCRResult result = recognizeTiles(prepared.image);
+    for (TextBlock &block : result.textBlocks)
+    {
+        block.boundingBox = prepared.mapToSource(block.boundingBox);
+    }
+    return result;
+}
+
+OCRResult OCRTask::recognizeTiles(const QImage &image)
+{
+    const ImageTiler::Options options = ImageTiler::fromParams(m_config.params);
+    if (!m_tilePool || image.isNull() || !ImageTiler::needsTiling(image.size(), options))
+    {
+        // 纯文本询问不攒批；分块识别的各块已经并发执行，也不再攒批
+        if (m_batcher && !image.isNull())
+        {
+            return m_batcher->recognize(m_adapter.data(), m_config.id, image, m_request.prompt, m_batchOptions);
+        }
+        return m_adapter->recognize(image, m_request.prompt);
+    }
+
+    const QVector<QRect> tiles = ImageTiler::plan(image.size(), options);
+    qDebug() << "OCRTask: 超大图片分块识别" << image.width() << "x" << image.height()
+             << "分块数:" << tiles.size();
+
+    // 各分块在独立线程池并发识别；适配器在任务线程已被并发调用，本身是可重入的
+    // 同时在识别的分块数不超过该模型的自适应并发上限，限流或超时后收缩的上限对分块同样生效
+    ModelAdapter *adapter = m_adapter.data();
+    const QString prompt = m_request.prompt;
+    QElapsedTimer timer;
+    timer.start();
+    // 各分块的结果写入各自的槽位；下面等待全部分块完成后才返回，分块任务可以直接引用局部变量
+    const int lanes = qMin(m_tileConcurrency, tiles.size());
+    QVector<OCRResult> results(tiles.size());
+    OCRResult *slots = results.data();
+    QAtomicInt next(0);
+    QAtomicInt *cursor = &next;
+    QVector<QFuture<void>> futures;
+    futures.reserve(lanes);
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        futures.append(QtConcurrent::run(m_tilePool, [adapter, image, tiles, prompt, slots, cursor]() {
+            for (int i = cursor->fetchAndAddOrdered(1); i < tiles.size(); i = cursor->fetchAndAddOrdered(1))
+            {
+                // 分块是与整图共享像素的视图，在分块任务中才创建，超大图不会在识别前整体复制一份
+                try
+                {
+                    slots[i] = adapter->recognize(ImageRegion::view(image, tiles.at(i)), prompt);
+                }
+                catch (const std::exception &e)
+                {
+                    OCRResult failed;
+                    failed.errorMessage = QString("异常: %1").arg(e.what());
+                    slots[i] = failed;
+                }
+            }
+        }));
+    }
+    for (QFuture<void> &future : futures)
+    {
+        future.waitForFinished();
+    }
+    OCRResult merged = ImageTiler::merge(image.size(), tiles, results, options);
+    merged.processingTimeMs = timer.elapsed();
+    return merged;
+}
+
 void OCRTask::run()
 {
+    // 延迟解码：在工作线程中读取文件，界面线程与批量列表不持有像素数据
+    if (m_request.image.isNull() && m_request.imageLoader)
+    {
+        m_request.image = m_request.imageLoader();
+        m_request.imageLoader = nullptr;
+        if (m_request.image.isNull())
+        {
+            emit error(QString("无法解码图片: %1").arg(m_request.filePath), QImage(), m_request.source, m_request.contextId);
+            return;
+        }
+    }
+
+    const QImage &image = m_request.image;
+    const SubmitSource source = m_request.source;
+    const QString &contextId = m_request.contextId;
+
     if (!m_adapter)
     {
         // 直接发送信号（会自动使用队列连接）
-        emit error("适配器为空", m_image, m_source, m_contextId);
+        emit error("适配器为空", image, source, contextId);
         return;
     }
 
+    // 区域重识别：只识别子区域视图，哈希、缓存与模型调用都针对区域像素
+    const bool isRegion = !m_request.region.isNull();
+    QImage input = image;
+    if (isRegion)
+    {
+        input = ImageRegion::view(image, m_request.region & image.rect());
+        if (input.isNull())
+        {
+            emit error("识别区域超出图片范围", image, source, contextId);
+            return;
+        }
+    }
+
     qDebug() << "OCRTask: 在线程中运行" << QThread::currentThreadId();
 
     try
     {
-        // 执行识别
-        OCRResult result = m_adapter->recognize(m_image, m_prompt);
-        result.contextId = m_contextId;
+        OCRResult cached;
+        if (probeCache(input, cached))
+        {
+            qDebug() << "OCRTask: 命中缓存，跳过模型调用" << m_contentHash;
+            cached.contextId = contextId;
+            stampHashes(cached);
+            if (isRegion)
+            {
+                cached = mergeRegion(image.size(), cached);
+                cached.contextId = contextId;
+            }
+            emit finished(cached, image, source, contextId);
+            return;
+        }
+
+        // 阶段四：执行识别
+        OCRResult result = recognize(input);
+        result.contextId = contextId;
+        stampHashes(result);
 
         // 发送结果信号
         if (result.success)
         {
-            emit finished(result, m_image, m_source, m_contextId);
+            // 阶段五：写回持久化结果缓存（独立于历史记录保留策略）
+            if (m_cacheStore && !m_contentHash.isEmpty())
+            {
+                m_cacheStore(m_contentHash, result);
+            }
+            // 区域结果按区域哈希缓存，返回给界面的是合并后的整图结果（换上 mergeRegion 派生的合并哈希）
+            if (isRegion)
+            {
+                result = mergeRegion(image.size(), result);
+                result.contextId = contextId;
+            }
+            emit finished(result, image, source, contextId);
         }
         else
         {
-            emit error(result.errorMessage, m_image, m_source, m_contextId);
+            emit error(result.errorMessage, image, source, contextId);
         }
     }
     catch (const std::exception &e)
     {
         QString errorMsg = QString("异常: %1").arg(e.what());
-        emit error(errorMsg, m_image, m_source, m_contextId);
+        emit error(errorMsg, image, source, contextId);
     }
     catch (...)
     {
-        emit error("未知异常", m_image, m_source, m_contextId);
+        emit error("未知异常", image, source, contextId);
     }
-}
\ No newline at end of file
+}
@@ -1,17 +1,50 @@
 #pragma once
 #include <QObject>
+#include <QHash>
 #include <QImage>
 #include <QPointer>
+#include <QRect>
 #include <QThreadPool>
+#include <functional>
 #include "ModelAdapter.h"
 #include "OCRResult.h"
+#include "AdaptiveConcurrency.h"
+#include "MicroBatcher.h"
+
+// 识别请求
+struct OCRRequest {
+    // 线程池排队优先级：交互式请求（单张识别）优先于批量与监视文件夹
+    enum Priority { PriorityBatch = 0, PriorityInteractive = 1 };
+
+    QImage image;
+    std::function<QImage()> imageLoader; // image 为空时在工作线程中调用以延迟解码（批量文件）
+    QString filePath;                    // 图片来源文件（日志与错误提示用）
+    SubmitSource source = SubmitSource::Upload;
+    QString prompt;
+    QString contextId;
+    bool useCache = true;    // 是否在调用模型前探测结果缓存
+    int priority = PriorityInteractive;
+    QPointer<ModelAdapter> adapter;   // 指定模型（批量矩阵），为空使用当前模型
+    QRect region;                     // 非空时只识别 image 中的该区域（像素坐标），结果合并回 parent
+    OCRResult parent;                 // 区域重识别时的整图结果
+};
 
 // OCR 处理流水线
 // 负责调度模型、异步执行、结果回调
+// 每个任务在工作线程中依次执行：内容哈希 → 缓存探测 → 模型识别
 class OCRPipeline : public QObject {
     Q_OBJECT
     
 public:
+    // 缓存探测回调：在工作线程中调用（需线程安全），命中时填充 result 并返回 true
+    typedef std::function<bool(const QString& hash, OCRResult& result)> CacheLookup;
+
+    // 近似去重探测回调：在工作线程中调用（需线程安全），仅对配置了 phash_threshold 的模型启用
+    typedef std::function<bool(const QString& requestKey, quint64 phash, int maxDistance, OCRResult& result)> NearDuplicateLookup;
+
+    // 结果写回回调：模型识别成功后在工作线程中调用（需线程安全）
+    typedef std::function<void(const QString& hash, const OCRResult& result)> CacheStore;
+
     explicit OCRPipeline(QObject* parent = nullptr);
     ~OCRPipeline() override;
     
@@ -20,12 +53,38 @@ public:
     
     // 获取当前模型
     ModelAdapter* currentAdapter() const { return m_currentAdapter; }
+
+    // 设置缓存探测回调（为空则不探测）
+    void setCacheLookup(const CacheLookup& lookup);
+
+    // 设置近似去重探测回调（为空则只做精确命中）
+    void setNearDuplicateLookup(const NearDuplicateLookup& lookup);
+
+    // 设置结果写回回调（为空则不写回）
+    void setCacheStore(const CacheStore& store);
     
     // 提交图像进行识别（异步）
     void submitImage(const QImage& image, 
                     SubmitSource source = SubmitSource::Upload,
                     const QString& prompt = QString(),
                     const QString& contextId = QString());
+
+    // 提交识别请求（异步）
+    void submit(const OCRRequest& request);
+
+    // 区域重识别（异步）：对已识别图片的子区域（像素坐标）换提示词 / 模型重新识别
+    // image 为整图识别时的同一张图片（隐式共享，不复制像素）；区域按自身像素内容计算哈希并缓存
+    // 合并后的整图结果通过 recognitionCompleted 返回，contextId 为空时沿用 parent.contextId
+    void submitRegion(const OCRResult& parent,
+                      const QImage& image,
+                      const QRect& region,
+                      const QString& prompt = QString(),
+                      ModelAdapter* adapter = nullptr,
+                      const QString& contextId = QString());
+
+    // 模型建议的并发数（AIMD：按观测到的延迟与限流/超时自适应），批量调度据此控制在途请求数
+    // adapter 为空时使用当前模型
+    int concurrencyLimit(ModelAdapter* adapter = nullptr);
     
 signals:
     // 识别开始
@@ -41,9 +100,19 @@ signals:
     void progressUpdated(int percentage);
     
 private:
+    // 记录模型的并发上限并据此调整识别线程池的线程数
+    void updatePoolSize(const QString& modelId, int limit);
+
     ModelAdapter* m_currentAdapter;
-    QThreadPool* m_threadPool;
+    QThreadPool* m_threadPool;   // 识别任务专用线程池
+    QHash<QString, int> m_modelLimits;   // 各模型最近一次的并发上限
+    QThreadPool* m_tilePool;     // 超大图分块识别专用，任务线程阻塞等待分块时不会占满主线程池
     QString m_currentPrompt;
+    CacheLookup m_cacheLookup;
+    NearDuplicateLookup m_nearDuplicateLookup;
+    CacheStore m_cacheStore;
+    AdaptiveConcurrency m_concurrency;
+    MicroBatcher m_batcher;      // 支持批量识别的模型把并发请求合并为一次调用
 };
 // OCR 异步任务
 class OCRTask : public QObject, public QRunnable {
@@ -51,10 +120,13 @@ class OCRTask : public QObject, public QRunnable {
     
 public:
     OCRTask(ModelAdapter* adapter, 
-           const QImage& image,
-           SubmitSource source,
-           const QString& prompt,
-           const QString& contextId,
+           const OCRRequest& request,
+           const OCRPipeline::CacheLookup& cacheLookup,
+           const OCRPipeline::NearDuplicateLookup& nearDuplicateLookup,
+           const OCRPipeline::CacheStore& cacheStore,
+           QThreadPool* tilePool,
+           int tileConcurrency,
+           MicroBatcher* batcher,
            QObject* receiver);
     
     void run() override;
@@ -64,10 +136,33 @@ signals:
     void error(const QString& errorMsg, const QImage& image, SubmitSource source, const QString& contextId);
     
 private:
+    // 缓存阶段：计算内容哈希（及感知哈希）并探测缓存，命中返回 true
+    bool probeCache(const QImage& image, OCRResult& result);
+
+    // 将本次请求的各类哈希写入结果
+    void stampHashes(OCRResult& result) const;
+
+    // 区域重识别：把区域结果合并回整图结果，并换上区域请求派生的哈希
+    OCRResult mergeRegion(const QSize& imageSize, const OCRResult& regionResult) const;
+
+    // 识别阶段：按参数 preprocess 预处理后识别，文本框映射回原图坐标
+    OCRResult recognize(const QImage& image);
+
+    // 超过 tile_max_side 的图片分块并发识别后合并，否则整图识别 (可与其它请求攒批)
+    OCRResult recognizeTiles(const QImage& image);
+
     QPointer<ModelAdapter> m_adapter;
-    QImage m_image;
-    SubmitSource m_source;
-    QString m_prompt;
-    QString m_contextId;
+    ModelConfig m_config;    // 提交时的模型配置快照，哈希计算不再访问适配器
+    OCRRequest m_request;
+    OCRPipeline::CacheLookup m_cacheLookup;
+    OCRPipeline::NearDuplicateLookup m_nearDuplicateLookup;
+    OCRPipeline::CacheStore m_cacheStore;
+    QThreadPool* m_tilePool;
+    int m_tileConcurrency;   // 同时识别的分块数，取提交时该模型的自适应并发上限
+    MicroBatcher* m_batcher;
+    MicroBatcher::Options m_batchOptions;
+    QString m_contentHash;
+    QString m_requestKey;
+    quint64 m_perceptualHash = 0;
     QObject* m_receiver;
-};
\ No newline at end of file
+};
@@ -7,11 +7,19 @@
 
 // OCR识别结果中的单个文本块
 struct TextBlock {
+    // 文本块粒度：整段 / 行 / 词。支持版面分析的引擎同时给出行与词，词级块的文本已包含在所在行中
+    enum Level : quint8 {
+        Block = 0,
+        Line = 1,
+        Word = 2
+    };
+
     QString text;           // 识别出的文本
     QRectF boundingBox;     // 边界框（归一化坐标 0-1）
     float confidence;       // 置信度 0-1-
+    Level level;            // 粒度
     
-    TextBlock() : confidence(0.0f) {}
+    TextBlock() : confidence(0.0f), level(Block) {}
 };
 
 // 完整的OCR识别结果
@@ -22,10 +30,14 @@ struct OCRResult {
     QString fullText;                // 合并后的完整文本
     QString modelName;               // 使用的模型名称
     QString contextId;               // 自定义上下文ID（用于批量/并发追踪）
+    QString contentHash;             // 内容哈希（由流水线在工作线程中计算，用于缓存与历史去重）
+    QString requestKey;              // 请求键（提示词 + 模型 + 参数），近似去重的分组依据
+    quint64 perceptualHash;          // 感知哈希 (dHash)，模型未开启近似去重时为 0
     QDateTime timestamp;             // 识别时间戳
     qint64 processingTimeMs;         // 处理耗时（毫秒）
+    bool fromCache;                  // 是否为缓存命中（未调用模型）
     
-    OCRResult() : success(false), processingTimeMs(0) {
+    OCRResult() : success(false), perceptualHash(0), processingTimeMs(0), fromCache(false) {
         timestamp = QDateTime::currentDateTime();
     }
     
@@ -33,6 +45,7 @@ struct OCRResult {
     void mergeFullText() {
         QStringList lines;
         for (const auto& block : textBlocks) {
+            if (block.level == TextBlock::Word) continue;  // 已包含在行中
             if (!block.text.trimmed().isEmpty()) {
                 lines.append(block.text);
             }
@@ -46,7 +59,8 @@ enum class SubmitSource {
     Upload,      // 手动上传
     Paste,       // 剪贴板粘贴
     Shortcut,    // 快捷键截图
-    DragDrop     // 拖拽
+    DragDrop,    // 拖拽
+    HotFolder    // 监视文件夹自动导入
 };
 
 // 注册元类型，以便在信号槽中使用
@@ -0,0 +1,220 @@
+#include "ResultCache.h"
+#include "ContentHash.h"
+#include <QDebug>
+
+// ---------------- BloomFilter ----------------
+
+BloomFilter::BloomFilter(int bitCount, int hashCount)
+    : m_bits(qMax(64, bitCount)), m_hashCount(qMax(1, hashCount))
+{
+}
+
+void BloomFilter::hashPair(const QString& key, uint& h1, uint& h2) const {
+    // 双重哈希：h(i) = h1 + i * h2，只需计算两次哈希
+    h1 = qHash(key, 0x9e3779b9u);
+    h2 = qHash(key, 0x85ebca6bu) | 1u;
+}
+
+void BloomFilter::add(const QString& key) {
+    if (key.isEmpty()) return;
+    uint h1, h2;
+    hashPair(key, h1, h2);
+    const uint size = static_cast<uint>(m_bits.size());
+    for (int i = 0; i < m_hashCount; ++i) {
+        m_bits.setBit(static_cast<int>((h1 + static_cast<uint>(i) * h2) % size));
+    }
+}
+
+bool BloomFilter::mightContain(const QString& key) const {
+    if (key.isEmpty()) return false;
+    uint h1, h2;
+    hashPair(key, h1, h2);
+    const uint size = static_cast<uint>(m_bits.size());
+    for (int i = 0; i < m_hashCount; ++i) {
+        if (!m_bits.testBit(static_cast<int>((h1 + static_cast<uint>(i) * h2) % size))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::clear() {
+    m_bits.fill(false);
+}
+
+// ---------------- PerceptualIndex ----------------
+
+PerceptualIndex::PerceptualIndex(int maxPerKey)
+    : m_maxPerKey(qMax(1, maxPerKey))
+{
+}
+
+void PerceptualIndex::add(const QString& requestKey, quint64 phash, const QString& contentHash) {
+    if (requestKey.isEmpty() || phash == 0 || contentHash.isEmpty()) return;
+    QMutexLocker locker(&m_mutex);
+
+    QVector<Entry>& list = m_entries[requestKey];
+    for (const Entry& entry : list) {
+        if (entry.contentHash == contentHash) return;
+    }
+    Entry entry;
+    entry.phash = phash;
+    entry.contentHash = contentHash;
+    list.append(entry);
+    if (list.size() > m_maxPerKey) {
+        list.remove(0, list.size() - m_maxPerKey);
+    }
+}
+
+bool PerceptualIndex::findNearest(const QString& requestKey, quint64 phash, int maxDistance, QString& contentHash, int* distance) const {
+    if (requestKey.isEmpty() || phash == 0 || maxDistance < 0) return false;
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_entries.constFind(requestKey);
+    if (it == m_entries.constEnd()) return false;
+
+    // 每个请求键下条目有限，线性扫描即可；从最新的开始，距离相同时优先返回最近的结果
+    int best = maxDistance + 1;
+    const QVector<Entry>& list = it.value();
+    for (int i = list.size() - 1; i >= 0; --i) {
+        int d = ContentHash::hammingDistance(list.at(i).phash, phash);
+        if (d < best) {
+            best = d;
+            contentHash = list.at(i).contentHash;
+            if (d == 0) break;
+        }
+    }
+    if (best > maxDistance) return false;
+    if (distance) *distance = best;
+    return true;
+}
+
+void PerceptualIndex::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+// ---------------- ResultCache ----------------
+
+ResultCache::ResultCache(qint64 maxBytes)
+    : m_maxBytes(maxBytes)
+{
+}
+
+qint64 ResultCache::estimateBytes(const QString& hash, const OCRResult& result) {
+    // QString 按 UTF-16 计，外加结构体与容器的固定开销
+    qint64 bytes = sizeof(Entry) + 64;
+    bytes += (hash.size() + result.fullText.size() + result.errorMessage.size() + result.modelName.size()) * 2;
+    for (const TextBlock& block : result.textBlocks) {
+        bytes += sizeof(TextBlock) + block.text.size() * 2;
+    }
+    return bytes;
+}
+
+bool ResultCache::lookup(const QString& hash, OCRResult& result) {
+    if (hash.isEmpty()) return false;
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+        m_stats.misses++;
+        return false;
+    }
+
+    // 移动到 LRU 头部
+    m_lru.splice(m_lru.begin(), m_lru, it->lruPos);
+    it->lruPos = m_lru.begin();
+    m_stats.hits++;
+    result = it->result;
+    return true;
+}
+
+void ResultCache::insert(const QString& hash, const OCRResult& result) {
+    if (hash.isEmpty() || !result.success) return;
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        m_stats.bytes -= it->bytes;
+        m_lru.erase(it->lruPos);
+        m_entries.erase(it);
+    }
+
+    Entry entry;
+    entry.result = result;
+    entry.result.contextId.clear(); // 上下文与具体请求绑定，不进入缓存
+    entry.bytes = estimateBytes(hash, entry.result);
+    m_lru.push_front(hash);
+    entry.lruPos = m_lru.begin();
+    m_stats.bytes += entry.bytes;
+    m_entries.insert(hash, entry);
+
+    evictToBudget();
+}
+
+void ResultCache::evictToBudget() {
+    // 调用方已持有锁；至少保留最新写入的一条
+    while (m_stats.bytes > m_maxBytes && m_lru.size() > 1) {
+        const QString victim = m_lru.back();
+        m_lru.pop_back();
+        auto it = m_entries.find(victim);
+        if (it != m_entries.end()) {
+            m_stats.bytes -= it->bytes;
+            m_entries.erase(it);
+        }
+        m_stats.evictions++;
+    }
+    m_stats.entries = m_entries.size();
+}
+
+void ResultCache::remove(const QString& hash) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) return;
+    m_stats.bytes -= it->bytes;
+    m_lru.erase(it->lruPos);
+    m_entries.erase(it);
+    m_stats.entries = m_entries.size();
+}
+
+void ResultCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_stats.bytes = 0;
+    m_stats.entries = 0;
+}
+
+void ResultCache::setMaxBytes(qint64 maxBytes) {
+    if (maxBytes <= 0) return;
+    QMutexLocker locker(&m_mutex);
+    m_maxBytes = maxBytes;
+    evictToBudget();
+}
+
+qint64 ResultCache::maxBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_maxBytes;
+}
+
+void ResultCache::addPersistedKey(const QString& hash) {
+    QMutexLocker locker(&m_mutex);
+    m_persisted.add(hash);
+}
+
+bool ResultCache::mightBePersisted(const QString& hash) {
+    QMutexLocker locker(&m_mutex);
+    if (m_persisted.mightContain(hash)) return true;
+    m_stats.bloomRejects++;
+    return false;
+}
+
+void ResultCache::clearPersistedKeys() {
+    QMutexLocker locker(&m_mutex);
+    m_persisted.clear();
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <QString>
+#include <QHash>
+#include <QBitArray>
+#include <QVector>
+#include <QMutex>
+#include <list>
+#include "OCRResult.h"
+
+// 布隆过滤器
+// 用于在查询持久层 (SQLite) 前快速排除一定不存在的键，存在一定误判率但不会漏判
+class BloomFilter {
+public:
+    explicit BloomFilter(int bitCount = 1 << 20, int hashCount = 4);
+
+    void add(const QString& key);
+    bool mightContain(const QString& key) const;
+    void clear();
+
+private:
+    void hashPair(const QString& key, uint& h1, uint& h2) const;
+
+    QBitArray m_bits;
+    int m_hashCount;
+};
+
+// 感知哈希索引
+// 请求键 (提示词 + 模型 + 参数) → 若干 (dHash, 内容哈希)，用于查找像素级略有差异的重复截图；线程安全
+class PerceptualIndex {
+public:
+    explicit PerceptualIndex(int maxPerKey = 256);
+
+    void add(const QString& requestKey, quint64 phash, const QString& contentHash);
+
+    // 在同一请求键下查找汉明距离不超过 maxDistance 的最近条目，命中时返回内容哈希与距离
+    bool findNearest(const QString& requestKey, quint64 phash, int maxDistance, QString& contentHash, int* distance = nullptr) const;
+
+    void clear();
+
+private:
+    struct Entry {
+        quint64 phash = 0;
+        QString contentHash;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, QVector<Entry>> m_entries; // 每个请求键按写入顺序保存，超出上限丢弃最旧的
+    int m_maxPerKey;
+};
+
+// 识别结果缓存
+// 内容哈希 → 识别结果 (不持有图片)，按字节预算做 LRU 淘汰；线程安全
+class ResultCache {
+public:
+    struct Stats {
+        quint64 hits = 0;         // 内存命中
+        quint64 misses = 0;       // 内存未命中
+        quint64 evictions = 0;    // 因预算淘汰的条目
+        quint64 bloomRejects = 0; // 布隆过滤器直接排除的持久层查询
+        qint64 bytes = 0;         // 当前占用字节（估算）
+        int entries = 0;          // 当前条目数
+
+        double hitRatio() const {
+            quint64 total = hits + misses;
+            return total > 0 ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+
+    explicit ResultCache(qint64 maxBytes = 32 * 1024 * 1024);
+
+    // 查找结果，命中时移动到 LRU 头部
+    bool lookup(const QString& hash, OCRResult& result);
+
+    // 写入结果（仅缓存成功结果），超出预算时从 LRU 尾部淘汰
+    void insert(const QString& hash, const OCRResult& result);
+
+    void remove(const QString& hash);
+    void clear();
+
+    void setMaxBytes(qint64 maxBytes);
+    qint64 maxBytes() const;
+
+    // 持久层存在性索引：记录已落库的哈希，查询前判断是否值得访问数据库
+    void addPersistedKey(const QString& hash);
+    bool mightBePersisted(const QString& hash);
+    void clearPersistedKeys();
+
+    Stats stats() const;
+
+    // 估算单条结果的内存占用
+    static qint64 estimateBytes(const QString& hash, const OCRResult& result);
+
+private:
+    struct Entry {
+        OCRResult result;
+        qint64 bytes = 0;
+        std::list<QString>::iterator lruPos;
+    };
+
+    void evictToBudget();
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    std::list<QString> m_lru; // 头部为最近使用
+    BloomFilter m_persisted;
+    qint64 m_maxBytes;
+    Stats m_stats;
+};
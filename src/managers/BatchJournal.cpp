@@ -0,0 +1,194 @@
+#include "BatchJournal.h"
+#include <QDir>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QUuid>
+
+int BatchJournal::Job::doneCount() const {
+    int count = 0;
+    for (const ItemRecord& item : items) {
+        if (item.state == ItemState::Done) count++;
+    }
+    return count;
+}
+
+int BatchJournal::Job::failedCount() const {
+    int count = 0;
+    for (const ItemRecord& item : items) {
+        if (item.state == ItemState::Failed) count++;
+    }
+    return count;
+}
+
+BatchJournal::BatchJournal(const QString& dirPath)
+    : m_dirPath(dirPath.isEmpty() ? QDir::currentPath() + "/batch" : dirPath)
+{
+}
+
+BatchJournal::~BatchJournal() {
+    // 未完成的任务保留日志，下次启动时提示恢复
+    if (m_file.isOpen()) m_file.close();
+}
+
+QString BatchJournal::journalPath() const {
+    return m_dirPath + "/current.jsonl";
+}
+
+bool BatchJournal::openForAppend() {
+    QDir().mkpath(m_dirPath);
+    if (m_file.isOpen()) m_file.close();
+    m_file.setFileName(journalPath());
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "BatchJournal: Failed to open journal:" << m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void BatchJournal::append(const QByteArray& line) {
+    if (!m_file.isOpen()) return;
+    m_file.write(line);
+    m_file.write("\n");
+    m_file.flush();
+}
+
+bool BatchJournal::begin(const QStringList& files, const QString& prompt, const QString& modelId, SubmitSource source,
+                         const BatchVariantList& variants) {
+    discard();
+    if (!openForAppend()) return false;
+
+    QJsonObject header;
+    header["type"] = "job";
+    header["id"] = QUuid::createUuid().toString();
+    header["files"] = QJsonArray::fromStringList(files);
+    header["prompt"] = prompt;
+    header["model"] = modelId;
+    header["source"] = static_cast<int>(source);
+    if (!variants.isEmpty()) {
+        QJsonArray variantArray;
+        for (const BatchVariant& variant : variants) {
+            QJsonObject v;
+            v["name"] = variant.name;
+            v["prompt"] = variant.prompt;
+            v["model"] = variant.modelId;
+            variantArray.append(v);
+        }
+        header["variants"] = variantArray;
+    }
+    header["created"] = QDateTime::currentMSecsSinceEpoch();
+    append(QJsonDocument(header).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+bool BatchJournal::resume(const Job& job) {
+    if (!job.isValid()) return false;
+    return openForAppend();
+}
+
+bool BatchJournal::reopen() {
+    if (!QFile::exists(journalPath())) return false;
+    return openForAppend();
+}
+
+void BatchJournal::recordDone(int index, const OCRResult& result) {
+    QJsonObject item;
+    item["type"] = "item";
+    item["index"] = index;
+    item["state"] = "done";
+    item["text"] = result.fullText;
+    item["model_name"] = result.modelName;
+    item["time_ms"] = static_cast<double>(result.processingTimeMs);
+    item["hash"] = result.contentHash;
+    append(QJsonDocument(item).toJson(QJsonDocument::Compact));
+}
+
+void BatchJournal::recordFailed(int index, const QString& error) {
+    QJsonObject item;
+    item["type"] = "item";
+    item["index"] = index;
+    item["state"] = "failed";
+    item["error"] = error;
+    append(QJsonDocument(item).toJson(QJsonDocument::Compact));
+}
+
+void BatchJournal::finish() {
+    QJsonObject done;
+    done["type"] = "finished";
+    append(QJsonDocument(done).toJson(QJsonDocument::Compact));
+    discard();
+}
+
+void BatchJournal::discard() {
+    if (m_file.isOpen()) m_file.close();
+    QFile::remove(journalPath());
+}
+
+void BatchJournal::close() {
+    if (m_file.isOpen()) m_file.close();
+}
+
+BatchJournal::Job BatchJournal::loadPending() const {
+    Job job;
+    QFile file(journalPath());
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) return job;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            // 崩溃时写了一半的行
+            qWarning() << "BatchJournal: Skipping malformed line:" << parseError.errorString();
+            continue;
+        }
+
+        QJsonObject obj = doc.object();
+        const QString type = obj["type"].toString();
+        if (type == "job") {
+            job.id = obj["id"].toString();
+            for (const QJsonValue& value : obj["files"].toArray()) {
+                job.files << value.toString();
+            }
+            job.prompt = obj["prompt"].toString();
+            job.modelId = obj["model"].toString();
+            job.source = static_cast<SubmitSource>(obj["source"].toInt());
+            for (const QJsonValue& value : obj["variants"].toArray()) {
+                const QJsonObject v = value.toObject();
+                BatchVariant variant;
+                variant.name = v["name"].toString();
+                variant.prompt = v["prompt"].toString();
+                variant.modelId = v["model"].toString();
+                job.variants.append(variant);
+            }
+            job.created = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(obj["created"].toDouble()));
+        } else if (type == "item") {
+            const int index = obj["index"].toInt(-1);
+            if (index < 0 || index >= job.itemCount()) continue;
+
+            ItemRecord record;
+            if (obj["state"].toString() == "done") {
+                record.state = ItemState::Done;
+                record.result.success = true;
+                record.result.fullText = obj["text"].toString();
+                record.result.modelName = obj["model_name"].toString();
+                record.result.processingTimeMs = static_cast<qint64>(obj["time_ms"].toDouble());
+                record.result.contentHash = obj["hash"].toString();
+            } else {
+                record.state = ItemState::Failed;
+                record.error = obj["error"].toString();
+                record.result.errorMessage = record.error;
+            }
+            // 同一项重试后以最后一次记录为准
+            job.items.insert(index, record);
+        } else if (type == "finished") {
+            job.finished = true;
+        }
+    }
+
+    if (job.finished) return Job();
+    return job;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QMap>
+#include <QDateTime>
+#include "../core/OCRResult.h"
+#include "../core/BatchVariant.h"
+
+// 批量任务日志
+// 以 JSON Lines 追加写入 batch/current.jsonl，异常退出或关闭程序后可恢复：
+//   {"type":"job", ...}    首行：文件列表、提示词、模型、来源 (批量矩阵另含各组合)
+//   {"type":"item", ...}   每完成一张追加一行：下标、状态、结果
+//   {"type":"finished"}    正常结束 (随后删除日志)
+// 每次追加立即 flush，崩溃时最多丢失最后一行，残缺行在加载时忽略
+class BatchJournal {
+public:
+    enum class ItemState { Pending, Done, Failed };
+
+    struct ItemRecord {
+        ItemState state = ItemState::Pending;
+        OCRResult result;
+        QString error;
+    };
+
+    struct Job {
+        QString id;
+        QStringList files;
+        QString prompt;
+        QString modelId;
+        SubmitSource source = SubmitSource::Upload;
+        BatchVariantList variants;   // 批量矩阵的组合，为空表示单提示词批量
+        QDateTime created;
+        QMap<int, ItemRecord> items; // 仅包含已记录的项，其余为 Pending
+        bool finished = false;
+
+        bool isValid() const { return !id.isEmpty() && !files.isEmpty(); }
+        // 批量项总数：矩阵模式下第 i 个文件的第 v 个组合下标为 i * 组合数 + v
+        int itemCount() const { return files.size() * qMax(1, variants.size()); }
+        int doneCount() const;
+        int failedCount() const;
+    };
+
+    explicit BatchJournal(const QString& dirPath = QString());
+    ~BatchJournal();
+
+    // 开始新任务 (覆盖旧日志)
+    bool begin(const QStringList& files, const QString& prompt, const QString& modelId, SubmitSource source,
+               const BatchVariantList& variants = BatchVariantList());
+
+    // 继续已加载的任务，后续记录追加到原日志
+    bool resume(const Job& job);
+
+    // 重新打开当前日志继续追加 (批次结束后重试失败项)
+    bool reopen();
+
+    // 记录单项结果
+    void recordDone(int index, const OCRResult& result);
+    void recordFailed(int index, const QString& error);
+
+    // 标记任务完成并删除日志
+    void finish();
+
+    // 丢弃日志 (用户放弃恢复)
+    void discard();
+
+    // 停止记录但保留日志 (任务被中断，下次启动时可恢复)
+    void close();
+
+    bool isActive() const { return m_file.isOpen(); }
+
+    // 读取未完成的任务，不存在或已完成时返回无效 Job
+    Job loadPending() const;
+
+private:
+    bool openForAppend();
+    void append(const QByteArray& line);
+    QString journalPath() const;
+
+    QString m_dirPath;
+    QFile m_file;
+};
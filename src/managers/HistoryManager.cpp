@@ -6,12 +6,25 @@
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QDateTime>
-#include <QCryptographicHash>
-#include <QBuffer>
+#include <QThread>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include "../utils/ThumbnailCache.h"
+#include "../core/ContentHash.h"
+
+namespace {
+// 后台落盘的结果
+struct SavedImages {
+    QImage thumbnail;
+    bool imageSaved = false;
+    bool thumbSaved = false;
+};
+}
 
 HistoryManager::HistoryManager(QObject* parent) : QObject(parent) {
     m_historyDir = QDir::currentPath() + "/history";
     m_imagesDir = m_historyDir + "/images";
+    m_thumbsDir = m_historyDir + "/thumbs";
     ensureDirectories();
 }
 
@@ -32,15 +45,30 @@ void HistoryManager::ensureDirectories() {
     if (!dir.exists()) dir.mkpath(".");
     QDir imgDir(m_imagesDir);
     if (!imgDir.exists()) imgDir.mkpath(".");
+    QDir thumbDir(m_thumbsDir);
+    if (!thumbDir.exists()) thumbDir.mkpath(".");
 }
 
 QSqlDatabase HistoryManager::getDatabase() {
+    // QSqlDatabase 连接不能跨线程使用：界面线程使用默认连接，工作线程 (缓存探测) 各自建立只读连接
+    QThread* current = QThread::currentThread();
+    QString connectionName = QLatin1String(QSqlDatabase::defaultConnection);
+    if (current != thread()) {
+        connectionName = QString("history_worker_%1").arg(reinterpret_cast<quintptr>(current));
+    }
+
     QSqlDatabase db;
-    if (QSqlDatabase::contains("qt_sql_default_connection")) {
-        db = QSqlDatabase::database("qt_sql_default_connection");
+    if (QSqlDatabase::contains(connectionName)) {
+        db = QSqlDatabase::database(connectionName);
     } else {
-        db = QSqlDatabase::addDatabase("QSQLITE");
+        db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
         db.setDatabaseName(m_historyDir + "/history.db");
+        if (current != thread()) {
+            // 线程池线程退出时释放其连接
+            QObject::connect(current, &QThread::finished, [connectionName]() {
+                QSqlDatabase::removeDatabase(connectionName);
+            });
+        }
     }
     
     if (!db.isOpen()) {
@@ -60,7 +88,10 @@ QSqlDatabase HistoryManager::getDatabase() {
                 "model_name TEXT, "
                 "processing_time_ms INTEGER, "
                 "error_message TEXT, "
-                "content_hash TEXT"
+                "content_hash TEXT, "
+                "thumb_path TEXT, "
+                "request_key TEXT, "
+                "phash INTEGER"
                 ")"
             );
             if (!success) {
@@ -72,6 +103,17 @@ QSqlDatabase HistoryManager::getDatabase() {
                     query.exec("ALTER TABLE history ADD COLUMN content_hash TEXT");
                     query.exec("CREATE INDEX IF NOT EXISTS idx_content_hash ON history(content_hash)");
                 }
+                // 缩略图列 (旧版本升级，旧记录在首次展示时从原图补生成)
+                if (!db.record("history").contains("thumb_path")) {
+                    qDebug() << "HistoryManager: Upgrading database schema (adding thumb_path)";
+                    query.exec("ALTER TABLE history ADD COLUMN thumb_path TEXT");
+                }
+                // 近似去重列 (旧记录没有感知哈希，只参与精确命中)
+                if (!db.record("history").contains("phash")) {
+                    qDebug() << "HistoryManager: Upgrading database schema (adding request_key, phash)";
+                    query.exec("ALTER TABLE history ADD COLUMN request_key TEXT");
+                    query.exec("ALTER TABLE history ADD COLUMN phash INTEGER");
+                }
 
                 query.exec("CREATE INDEX IF NOT EXISTS idx_timestamp ON history(timestamp DESC)");
                 query.exec("CREATE INDEX IF NOT EXISTS idx_content_hash ON history(content_hash)");
@@ -93,21 +135,13 @@ void HistoryManager::loadHistory() {
             query.bindValue(":limit", m_maxHistory > 0 ? m_maxHistory : 50);
             if (query.exec()) {
                 while (query.next()) {
-                    HistoryItem item;
-                    item.id = query.value("id").toLongLong();
-                    item.timestamp = QDateTime::fromMSecsSinceEpoch(query.value("timestamp").toLongLong());
-                    item.imagePath = query.value("image_path").toString();
-                    item.source = static_cast<SubmitSource>(query.value("source").toInt());
-                    item.result.success = query.value("success").toBool();
-                    item.result.fullText = query.value("full_text").toString();
-                    item.result.modelName = query.value("model_name").toString();
-                    item.result.processingTimeMs = query.value("processing_time_ms").toLongLong();
-                    item.result.errorMessage = query.value("error_message").toString();
-                    item.contentHash = query.value("content_hash").toString();
                     // 内存缓存暂不加载图片数据以节省内存
+                    HistoryItem item = readItem(query);
+                    m_resultCache.insert(item.contentHash, item.result);
                     m_memoryHistory.append(item);
                 }
             }
+            loadPersistedKeys();
         }
     }
     
@@ -202,25 +236,8 @@ QVector<HistoryItem> HistoryManager::getHistoryList(int page, int pageSize, cons
 
     if (query.exec()) {
         while (query.next()) {
-            HistoryItem item;
-            item.id = query.value("id").toLongLong();
-            item.timestamp = QDateTime::fromMSecsSinceEpoch(query.value("timestamp").toLongLong());
-            item.imagePath = query.value("image_path").toString();
-            item.source = static_cast<SubmitSource>(query.value("source").toInt());
-            
-            item.result.success = query.value("success").toBool();
-            // 列表模式只读取前100个字符作为预览，避免大量内存占用
-            QString fullText = query.value("full_text").toString();
-            item.result.fullText = fullText; 
-            item.result.modelName = query.value("model_name").toString();
-            item.result.processingTimeMs = query.value("processing_time_ms").toLongLong();
-            item.result.errorMessage = query.value("error_message").toString();
-            item.contentHash = query.value("content_hash").toString();
-            
-            // 注意：列表模式不加载图片 QImage，只保留路径
-            // item.image.load(item.imagePath); 
-            
-            list.append(item);
+            // 注意：列表模式不加载图片 QImage，只保留路径，缩略图通过 requestThumbnail 异步获取
+            list.append(readItem(query));
         }
     } else {
         qWarning() << "HistoryManager: List query failed:" << query.lastError().text();
@@ -228,13 +245,13 @@ QVector<HistoryItem> HistoryManager::getHistoryList(int page, int pageSize, cons
     return list;
 }
 
-HistoryItem HistoryManager::getHistoryDetail(long long id) {
+HistoryItem HistoryManager::getHistoryDetail(long long id, bool loadImage) {
     if (!m_persistenceEnabled) {
         // 未开启持久化时从内存查找 (使用时间戳作为临时ID)
         for (auto& item : m_memoryHistory) {
             if (item.id == id) {
                  // 确保图片已加载
-                 if (item.image.isNull() && !item.imagePath.isEmpty() && QFile::exists(item.imagePath)) {
+                 if (loadImage && item.image.isNull() && !item.imagePath.isEmpty() && QFile::exists(item.imagePath)) {
                      item.image.load(item.imagePath);
                  }
                  return item;
@@ -252,26 +269,87 @@ HistoryItem HistoryManager::getHistoryDetail(long long id) {
     query.bindValue(":id", id);
 
     if (query.exec() && query.next()) {
-        item.id = query.value("id").toLongLong();
-        item.timestamp = QDateTime::fromMSecsSinceEpoch(query.value("timestamp").toLongLong());
-        item.imagePath = query.value("image_path").toString();
-        item.source = static_cast<SubmitSource>(query.value("source").toInt());
+        item = readItem(query);
         
-        item.result.success = query.value("success").toBool();
-        item.result.fullText = query.value("full_text").toString();
-        item.result.modelName = query.value("model_name").toString();
-        item.result.processingTimeMs = query.value("processing_time_ms").toLongLong();
-        item.result.errorMessage = query.value("error_message").toString();
-        item.contentHash = query.value("content_hash").toString();
-        
-        // 详情模式加载图片
-        if (!item.imagePath.isEmpty() && QFile::exists(item.imagePath)) {
+        // 详情模式加载图片；原图尚未写完时使用内存中的副本
+        if (loadImage && m_pendingImages.contains(id)) {
+            item.image = m_pendingImages.value(id);
+        } else if (loadImage && !item.imagePath.isEmpty() && QFile::exists(item.imagePath)) {
             item.image.load(item.imagePath);
         }
     }
     return item;
 }
 
+QImage HistoryManager::cachedThumbnail(const HistoryItem& item) const {
+    return ThumbnailCache::instance().get(thumbnailKey(item));
+}
+
+void HistoryManager::requestThumbnail(const HistoryItem& item) {
+    const long long id = item.id;
+    QFuture<QImage> future;
+    if (m_pendingImages.contains(id)) {
+        // 刚加入的记录仍在落盘，完成后会发出 thumbnailReady
+        return;
+    } else if (!item.thumbnailPath.isEmpty()) {
+        future = ThumbnailCache::instance().loadAsync(item.thumbnailPath, item.imagePath);
+    } else if (!item.imagePath.isEmpty()) {
+        // 旧记录没有缩略图：按约定路径从原图补生成并落盘，同时以原图路径为键缓存
+        const QString thumbPath = m_thumbsDir + "/" + QFileInfo(item.imagePath).completeBaseName() + ".jpg";
+        const QString imagePath = item.imagePath;
+        future = QtConcurrent::run([thumbPath, imagePath]() -> QImage {
+            QImage thumb = ThumbnailCache::instance().load(thumbPath, imagePath);
+            ThumbnailCache::instance().insert(imagePath, thumb);
+            return thumb;
+        });
+    } else if (!item.image.isNull()) {
+        // 非持久化模式：从内存中的原图生成
+        const QImage image = item.image;
+        const QString key = thumbnailKey(item);
+        future = QtConcurrent::run([image, key]() -> QImage {
+            QImage thumb = ThumbnailCache::makeThumbnail(image);
+            ThumbnailCache::instance().insert(key, thumb);
+            return thumb;
+        });
+    } else {
+        return;
+    }
+
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, id]() {
+        QImage thumb = watcher->result();
+        watcher->deleteLater();
+        if (!thumb.isNull()) emit thumbnailReady(id, thumb);
+    });
+    watcher->setFuture(future);
+}
+
+void HistoryManager::requestFullImage(const HistoryItem& item) {
+    const long long id = item.id;
+    if (!item.image.isNull()) {
+        emit fullImageReady(id, item.image);
+        return;
+    }
+    if (m_pendingImages.contains(id)) {
+        emit fullImageReady(id, m_pendingImages.value(id));
+        return;
+    }
+    if (item.imagePath.isEmpty()) return;
+
+    const QString path = item.imagePath;
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, id]() {
+        QImage image = watcher->result();
+        watcher->deleteLater();
+        if (!image.isNull()) emit fullImageReady(id, image);
+    });
+    watcher->setFuture(QtConcurrent::run([path]() -> QImage {
+        QImage image;
+        if (QFile::exists(path)) image.load(path);
+        return image;
+    }));
+}
+
 void HistoryManager::addHistoryItem(const HistoryItem& item) {
     HistoryItem newItem = item;
 
@@ -280,28 +358,33 @@ void HistoryManager::addHistoryItem(const HistoryItem& item) {
         newItem.id = newItem.timestamp.toMSecsSinceEpoch(); 
     }
 
-    // 1. 保存图片到磁盘 (仅在启用持久化时)
-    if (m_persistenceEnabled && newItem.imagePath.isEmpty()) {
-        QString fileName = QString("%1.png").arg(newItem.timestamp.toString("yyyyMMdd_HHmmss_zzz"));
-        QString filePath = m_imagesDir + "/" + fileName;
-        
-        if (newItem.image.save(filePath)) {
-            newItem.imagePath = filePath;
-        } else {
-            qWarning() << "HistoryManager: Failed to save image:" << filePath;
-        }
+    // 1. 保存图片与缩略图到磁盘 (仅在启用持久化时)
+    //    路径先行确定并入库，PNG 编码与缩略图生成放到后台线程，不阻塞界面；
+    //    写完之前原图保留在 m_pendingImages 中，写失败时从记录中清除对应路径
+    bool saveImage = false;
+    if (m_persistenceEnabled && newItem.imagePath.isEmpty() && !newItem.image.isNull()) {
+        QString baseName = newItem.timestamp.toString("yyyyMMdd_HHmmss_zzz");
+        newItem.imagePath = m_imagesDir + "/" + baseName + ".png";
+        newItem.thumbnailPath = m_thumbsDir + "/" + baseName + ".jpg";
+        saveImage = true;
     }
     
     // 2. 更新内存缓存以支持快速检索与展示 (通过 enforceMaxHistory 控制内存占用)
+    //    已落盘的记录不在内存中保留原图，详情通过 requestFullImage 从文件解码
     m_memoryHistory.prepend(newItem);
+    if (saveImage) m_memoryHistory.first().image = QImage();
+    m_resultCache.insert(newItem.contentHash, newItem.result);
+    if (newItem.result.success) {
+        m_perceptualIndex.add(newItem.requestKey, newItem.perceptualHash, newItem.contentHash);
+    }
     
     // 3. 写入数据库 (仅在启用持久化时)
     if (m_persistenceEnabled) {
         QSqlDatabase db = getDatabase();
         if (db.isOpen()) {
             QSqlQuery query(db);
-            query.prepare("INSERT INTO history (timestamp, image_path, source, success, full_text, model_name, processing_time_ms, error_message, content_hash) "
-                          "VALUES (:ts, :path, :src, :success, :txt, :model, :time, :err, :hash)");
+            query.prepare("INSERT INTO history (timestamp, image_path, source, success, full_text, model_name, processing_time_ms, error_message, content_hash, thumb_path, request_key, phash) "
+                          "VALUES (:ts, :path, :src, :success, :txt, :model, :time, :err, :hash, :thumb, :reqkey, :phash)");
             
             query.bindValue(":ts", newItem.timestamp.toMSecsSinceEpoch());
             query.bindValue(":path", newItem.imagePath);
@@ -312,15 +395,66 @@ void HistoryManager::addHistoryItem(const HistoryItem& item) {
             query.bindValue(":time", newItem.result.processingTimeMs);
             query.bindValue(":err", newItem.result.errorMessage);
             query.bindValue(":hash", newItem.contentHash);
+            query.bindValue(":thumb", newItem.thumbnailPath);
+            query.bindValue(":reqkey", newItem.requestKey);
+            // SQLite 整数为有符号 64 位，按位保存
+            query.bindValue(":phash", newItem.perceptualHash ? QVariant(static_cast<qint64>(newItem.perceptualHash)) : QVariant());
             
             if (!query.exec()) {
                  qWarning() << "HistoryManager: Insert failed:" << query.lastError().text();
             } else {
                 newItem.id = query.lastInsertId().toLongLong();
+                m_memoryHistory.first().id = newItem.id;
+                if (newItem.result.success) m_resultCache.addPersistedKey(newItem.contentHash);
             }
         }
     }
 
+    // 后台生成缩略图 (持久化时同时落盘原图)，完成后通知列表刷新图标
+    if (!newItem.image.isNull()) {
+        const QImage image = newItem.image;
+        const QString imagePath = saveImage ? newItem.imagePath : QString();
+        const QString thumbPath = saveImage ? newItem.thumbnailPath : QString();
+        const QString key = thumbnailKey(newItem);
+        const long long id = newItem.id;
+        if (saveImage) m_pendingImages.insert(id, image);
+        // 写入期间历史被清空时，后台任务不再落盘，已写出的文件在完成回调中删除
+        const std::shared_ptr<QAtomicInt> generation = m_clearGeneration;
+        const int submittedGeneration = generation->loadAcquire();
+
+        QFutureWatcher<SavedImages>* watcher = new QFutureWatcher<SavedImages>(this);
+        connect(watcher, &QFutureWatcher<SavedImages>::finished, this,
+                [this, watcher, id, saveImage, imagePath, thumbPath, submittedGeneration]() {
+            const SavedImages saved = watcher->result();
+            watcher->deleteLater();
+            if (m_clearGeneration->loadAcquire() != submittedGeneration) {
+                removeImageFiles(saved.imageSaved ? imagePath : QString(), saved.thumbSaved ? thumbPath : QString());
+                return;
+            }
+            if (saveImage) finishImageSave(id, saved.imageSaved, saved.thumbSaved);
+            if (!saved.thumbnail.isNull()) emit thumbnailReady(id, saved.thumbnail);
+        });
+        watcher->setFuture(QtConcurrent::run([image, imagePath, thumbPath, key, generation, submittedGeneration]() -> SavedImages {
+            SavedImages saved;
+            if (generation->loadAcquire() != submittedGeneration) {
+                return saved;
+            }
+            saved.imageSaved = !imagePath.isEmpty() && image.save(imagePath);
+            if (!imagePath.isEmpty() && !saved.imageSaved) {
+                qWarning() << "HistoryManager: Failed to save image:" << imagePath;
+            }
+            saved.thumbnail = ThumbnailCache::makeThumbnail(image);
+            saved.thumbSaved = !thumbPath.isEmpty() && saved.thumbnail.save(thumbPath, "JPG", 85);
+            if (!thumbPath.isEmpty() && !saved.thumbSaved) {
+                qWarning() << "HistoryManager: Failed to save thumbnail:" << thumbPath;
+            }
+            if (generation->loadAcquire() == submittedGeneration) {
+                ThumbnailCache::instance().insert(key, saved.thumbnail);
+            }
+            return saved;
+        }));
+    }
+
     // 4. 检查数量限制
     enforceMaxHistory();
     
@@ -332,6 +466,9 @@ void HistoryManager::enforceMaxHistory() {
     
     // 内存清理
     if (m_memoryHistory.size() > m_maxHistory) {
+        for (int i = m_maxHistory; i < m_memoryHistory.size(); ++i) {
+            ThumbnailCache::instance().remove(thumbnailKey(m_memoryHistory.at(i)));
+        }
         m_memoryHistory.resize(m_maxHistory);
     }
     
@@ -342,16 +479,13 @@ void HistoryManager::enforceMaxHistory() {
 
     // 数据库清理：保留最新的 N 条，删除其余的
     QSqlQuery query(db);
-    query.prepare("SELECT image_path FROM history ORDER BY timestamp DESC LIMIT -1 OFFSET :offset");
+    query.prepare("SELECT image_path, thumb_path FROM history ORDER BY timestamp DESC LIMIT -1 OFFSET :offset");
     query.bindValue(":offset", m_maxHistory);
     
     // 先获取要删除的图片路径，以便清理磁盘文件
     if (query.exec()) {
         while (query.next()) {
-            QString path = query.value(0).toString();
-            if (!path.isEmpty() && QFile::exists(path)) {
-                QFile::remove(path);
-            }
+            removeImageFiles(query.value(0).toString(), query.value(1).toString());
         }
     }
     
@@ -375,17 +509,20 @@ void HistoryManager::clearHistory() {
     // 1. 清理磁盘图片
     if (db.isOpen()) {
         QSqlQuery query(db);
-        query.exec("SELECT image_path FROM history");
+        query.exec("SELECT image_path, thumb_path FROM history");
         while (query.next()) {
-            QString path = query.value(0).toString();
-            if (!path.isEmpty() && QFile::exists(path)) {
-                QFile::remove(path);
-            }
+            removeImageFiles(query.value(0).toString(), query.value(1).toString());
         }
     } 
     
     // 2. 清空内存
     m_memoryHistory.clear();
+    m_pendingImages.clear();
+    m_clearGeneration->ref();   // 尚在后台落盘的图片随之作废
+    m_resultCache.clear();
+    m_resultCache.clearPersistedKeys();
+    m_perceptualIndex.clear();
+    ThumbnailCache::instance().clear();
 
     // 3. 清空数据库
     if (db.isOpen()) {
@@ -399,21 +536,24 @@ void HistoryManager::clearHistory() {
 
 void HistoryManager::setPersistenceEnabled(bool enabled) {
     qDebug() << "HistoryManager: Setting persistence to" << enabled;
-    if (m_persistenceEnabled == enabled) return;
-    m_persistenceEnabled = enabled;
-    
-    if (enabled) {
-        // 获取数据库连接
-        QSqlDatabase db = getDatabase();
-        
-        if (!db.isOpen()) {
-            qCritical() << "HistoryManager: Failed to open database, cannot enable persistence.";
-            m_persistenceEnabled = false; // 回滚状态
-            return;
-        }
+    if (m_persistenceEnabled.load(std::memory_order_acquire) == enabled) return;
 
-        qDebug() << "HistoryManager: Persistence enabled.";
+    if (!enabled) {
+        m_persistenceEnabled.store(false, std::memory_order_release);
+        return;
     }
+
+    // 先打开数据库并载入已持久化的键，成功后才发布开关：
+    // 工作线程 (lookupResult / findItemByHash) 看到 true 时数据库与布隆过滤器已就绪，也不会读到中途回滚的状态
+    QSqlDatabase db = getDatabase();
+    if (!db.isOpen()) {
+        qCritical() << "HistoryManager: Failed to open database, cannot enable persistence.";
+        return;
+    }
+
+    loadPersistedKeys();
+    m_persistenceEnabled.store(true, std::memory_order_release);
+    qDebug() << "HistoryManager: Persistence enabled.";
 }
 
 bool HistoryManager::isPersistenceEnabled() const {
@@ -431,50 +571,41 @@ int HistoryManager::getMaxHistory() const {
 }
 
 QString HistoryManager::computeContentHash(const QImage& img, const QString& prompt, const QString& model, const QMap<QString, QString>& params) {
-    if (img.isNull()) return QString();
-    
-    QCryptographicHash hasher(QCryptographicHash::Md5);
-    
-    // Hash Image Data
-    QByteArray imgData;
-    QBuffer buffer(&imgData);
-    buffer.open(QIODevice::WriteOnly);
-    // 使用 PNG 格式以确保无损和一致性
-    img.save(&buffer, "PNG"); 
-    hasher.addData(imgData);
-    
-    // Hash Prompt
-    hasher.addData(prompt.toUtf8());
-    
-    // Hash Model
-    hasher.addData(model.toUtf8());
-
-    // Hash Params (QMap 参数按key排序)
-    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
-        // 跳过敏感信息 (API Key等) 避免因 Key 变更导致缓存失效
-        if (it.key().compare("api_key", Qt::CaseInsensitive) == 0) continue;
-        if (it.key().compare("secret_key", Qt::CaseInsensitive) == 0) continue;
-        if (it.key().compare("access_token", Qt::CaseInsensitive) == 0) continue;
-        
-        hasher.addData(it.key().toUtf8());
-        hasher.addData(it.value().toUtf8());
+    return ContentHash::compute(img, prompt, model, params);
+}
+
+bool HistoryManager::lookupResult(const QString& hash, OCRResult& result) {
+    HistoryItem item = findItemByHash(hash);
+    if (!item.result.success) return false;
+    result = item.result;
+    return true;
+}
+
+bool HistoryManager::lookupNearDuplicate(const QString& requestKey, quint64 phash, int maxDistance, OCRResult& result) {
+    QString contentHash;
+    int distance = 0;
+    if (!m_perceptualIndex.findNearest(requestKey, phash, maxDistance, contentHash, &distance)) {
+        return false;
     }
-    
-    return hasher.result().toHex();
+    // 索引只保存内容哈希，结果仍走结果缓存 / 数据库；记录已被清理时视为未命中
+    if (!lookupResult(contentHash, result)) return false;
+    qDebug() << "HistoryManager: Near-duplicate hit, distance" << distance << "hash" << contentHash;
+    return true;
 }
 
 HistoryItem HistoryManager::findItemByHash(const QString& hash) {
     if (hash.isEmpty()) return HistoryItem();
     
-    // 1. 缓存命中: 在内存中搜索 (如果启用持久化)
-    // 优先返回最近的记录 (因为 m_memoryHistory 是按时间倒序排列的)
-    for (const auto& item : m_memoryHistory) {
-        if (item.contentHash == hash && item.result.success) 
-            return item;
+    // 1. 缓存命中: 哈希表直接查找 (不持有图片，O(1))
+    HistoryItem item;
+    if (m_resultCache.lookup(hash, item.result)) {
+        item.contentHash = hash;
+        return item;
     }
     
     // 2. 缓存命中: 在 SQLite 数据库中搜索 (如果启用持久化)
-    if (m_persistenceEnabled) {
+    //    布隆过滤器判定不存在时直接跳过查询
+    if (m_persistenceEnabled.load(std::memory_order_acquire) && m_resultCache.mightBePersisted(hash)) {
         QSqlDatabase db = getDatabase();
         if (db.isOpen()) {
             QSqlQuery query(db);
@@ -482,27 +613,103 @@ HistoryItem HistoryManager::findItemByHash(const QString& hash) {
             query.prepare("SELECT * FROM history WHERE content_hash = :hash AND success = 1 ORDER BY timestamp DESC LIMIT 1");
             query.bindValue(":hash", hash);
             if (query.exec() && query.next()) {
-                HistoryItem item;
-                item.id = query.value("id").toLongLong(); // Add ID
-                item.timestamp = QDateTime::fromMSecsSinceEpoch(query.value("timestamp").toLongLong());
-                item.imagePath = query.value("image_path").toString();
-                item.source = static_cast<SubmitSource>(query.value("source").toInt());
+                item = readItem(query);
                 item.result.success = true; // We queried for success=1
-                item.result.fullText = query.value("full_text").toString();
-                item.result.modelName = query.value("model_name").toString();
-                item.result.processingTimeMs = query.value("processing_time_ms").toLongLong();
-                item.result.errorMessage = query.value("error_message").toString();
-                item.contentHash = hash;
-                
-                // 加载图片
-                if (!item.imagePath.isEmpty() && QFile::exists(item.imagePath)) {
-                    item.image.load(item.imagePath);
-                }
                 
+                // 回填内存缓存，图片按需由调用方加载
+                m_resultCache.insert(hash, item.result);
                 return item;
             }
         }
     }
     
     return HistoryItem(); // 未找到
-}
\ No newline at end of file
+}
+
+void HistoryManager::setResultCacheBudget(qint64 bytes) {
+    m_resultCache.setMaxBytes(bytes);
+}
+
+ResultCache::Stats HistoryManager::resultCacheStats() const {
+    return m_resultCache.stats();
+}
+
+void HistoryManager::loadPersistedKeys() {
+    QSqlDatabase db = getDatabase();
+    if (!db.isOpen()) return;
+
+    m_resultCache.clearPersistedKeys();
+    m_perceptualIndex.clear();
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    // 按时间正序载入，使感知哈希索引中较新的记录排在后面
+    if (query.exec("SELECT content_hash, request_key, phash FROM history "
+                   "WHERE success = 1 AND content_hash IS NOT NULL ORDER BY timestamp ASC")) {
+        while (query.next()) {
+            const QString hash = query.value(0).toString();
+            m_resultCache.addPersistedKey(hash);
+            if (!query.value(2).isNull()) {
+                m_perceptualIndex.add(query.value(1).toString(), static_cast<quint64>(query.value(2).toLongLong()), hash);
+            }
+        }
+    }
+}
+
+HistoryItem HistoryManager::readItem(const QSqlQuery& query) {
+    HistoryItem item;
+    item.id = query.value("id").toLongLong();
+    item.timestamp = QDateTime::fromMSecsSinceEpoch(query.value("timestamp").toLongLong());
+    item.imagePath = query.value("image_path").toString();
+    item.thumbnailPath = query.value("thumb_path").toString();
+    item.source = static_cast<SubmitSource>(query.value("source").toInt());
+    item.result.success = query.value("success").toBool();
+    item.result.fullText = query.value("full_text").toString();
+    item.result.modelName = query.value("model_name").toString();
+    item.result.processingTimeMs = query.value("processing_time_ms").toLongLong();
+    item.result.errorMessage = query.value("error_message").toString();
+    item.contentHash = query.value("content_hash").toString();
+    item.requestKey = query.value("request_key").toString();
+    item.perceptualHash = static_cast<quint64>(query.value("phash").toLongLong());
+    return item;
+}
+
+QString HistoryManager::thumbnailKey(const HistoryItem& item) {
+    if (!item.thumbnailPath.isEmpty()) return item.thumbnailPath;
+    if (!item.imagePath.isEmpty()) return item.imagePath;
+    return QString("mem:%1").arg(item.id);
+}
+
+void HistoryManager::finishImageSave(long long id, bool imageSaved, bool thumbSaved) {
+    m_pendingImages.remove(id);
+    if (imageSaved && thumbSaved) return;
+
+    // 写失败的路径不能留在记录里，否则详情与缩略图会去读一个不存在的文件
+    for (HistoryItem& item : m_memoryHistory) {
+        if (item.id == id) {
+            if (!imageSaved) item.imagePath.clear();
+            if (!thumbSaved) item.thumbnailPath.clear();
+            break;
+        }
+    }
+    if (!m_persistenceEnabled) return;
+    QSqlDatabase db = getDatabase();
+    if (!db.isOpen()) return;
+    QSqlQuery query(db);
+    query.prepare(QString("UPDATE history SET %1 WHERE id = :id")
+                      .arg(!imageSaved && !thumbSaved ? "image_path = NULL, thumb_path = NULL"
+                           : !imageSaved ? "image_path = NULL" : "thumb_path = NULL"));
+    query.bindValue(":id", id);
+    if (!query.exec()) {
+        qWarning() << "HistoryManager: Failed to clear unsaved image path:" << query.lastError().text();
+    }
+}
+
+void HistoryManager::removeImageFiles(const QString& imagePath, const QString& thumbPath) {
+    if (!imagePath.isEmpty() && QFile::exists(imagePath)) {
+        QFile::remove(imagePath);
+    }
+    if (!thumbPath.isEmpty()) {
+        ThumbnailCache::instance().remove(thumbPath);
+        if (QFile::exists(thumbPath)) QFile::remove(thumbPath);
+    }
+}
@@ -3,7 +3,15 @@
 #include <QVector>
 #include <QSqlDatabase>
 #include <QMap>
+#include <QHash>
+#include <QImage>
+#include <atomic>
+#include <memory>
+#include <QAtomicInt>
 #include "../core/HistoryItem.h"
+#include "../core/ResultCache.h"
+
+class QSqlQuery;
 
 // 历史记录管理器
 class HistoryManager: public QObject {
@@ -46,27 +54,60 @@ public:
     // 分页获取历史记录
     QVector<HistoryItem> getHistoryList(int page, int pageSize, const HistoryFilter& filter = HistoryFilter());
 
-    // 根据ID获取单条详情 (包含加载图片)
-    HistoryItem getHistoryDetail(long long id);
+    // 根据ID获取单条详情 (loadImage 为 false 时不解码原图，配合 requestFullImage 异步加载)
+    HistoryItem getHistoryDetail(long long id, bool loadImage = true);
+
+    // 缩略图：内存命中直接返回，否则返回空图
+    QImage cachedThumbnail(const HistoryItem& item) const;
+
+    // 异步加载缩略图，完成后发出 thumbnailReady
+    void requestThumbnail(const HistoryItem& item);
+
+    // 异步解码原图，完成后发出 fullImageReady
+    void requestFullImage(const HistoryItem& item);
 
     // 计算内容哈希
     static QString computeContentHash(const QImage& img, const QString& prompt, const QString& model, const QMap<QString, QString>& params = QMap<QString, QString>());
 
-    // 根据哈希查找历史记录
+    // 根据哈希查找历史记录 (结果缓存 → 布隆过滤 → SQLite)，返回的记录不含图片
+    // 线程安全：工作线程调用时使用该线程独立的数据库连接
     HistoryItem findItemByHash(const QString& hash);
 
+    // 缓存探测 (供 OCRPipeline 在工作线程中调用)，命中返回 true
+    bool lookupResult(const QString& hash, OCRResult& result);
+
+    // 近似去重探测：同一请求键下感知哈希汉明距离不超过 maxDistance 的历史结果，线程安全
+    bool lookupNearDuplicate(const QString& requestKey, quint64 phash, int maxDistance, OCRResult& result);
+
+    // 结果缓存内存预算 (字节)
+    void setResultCacheBudget(qint64 bytes);
+    ResultCache::Stats resultCacheStats() const;
+
 signals:
     void historyChanged();
+    void thumbnailReady(long long id, const QImage& thumbnail);
+    void fullImageReady(long long id, const QImage& image);
 
 private:
-    QVector<HistoryItem> m_memoryHistory; // 内存缓存 (无论是否持久化都维护，用于缓存命中和非持久化模式)
+    QVector<HistoryItem> m_memoryHistory; // 内存历史 (无论是否持久化都维护，用于非持久化模式的列表展示)
+    QHash<long long, QImage> m_pendingImages; // 原图尚在后台落盘的记录，写完之前详情与缩略图从这里取
+    std::shared_ptr<QAtomicInt> m_clearGeneration{new QAtomicInt(0)}; // 每次清空历史加一，后台写入据此判断是否已作废
+    ResultCache m_resultCache;            // 内容哈希 → 结果，用于缓存命中
+    PerceptualIndex m_perceptualIndex;    // 感知哈希 → 内容哈希，用于近似重复截图命中
     QString m_historyDir;
     QString m_imagesDir;
+    QString m_thumbsDir;
     
-    bool m_persistenceEnabled = false;
+    std::atomic<bool> m_persistenceEnabled{false}; // 工作线程探测缓存时读取
     int m_maxHistory;
 
     void ensureDirectories();
     QSqlDatabase getDatabase(); // 获取数据库连接
     void enforceMaxHistory();   // 强制执行数量限制
+    void removeImageFiles(const QString& imagePath, const QString& thumbPath); // 删除图片与缩略图
+    void finishImageSave(long long id, bool imageSaved, bool thumbSaved); // 后台落盘完成，写失败的路径从记录中清除
+    void loadPersistedKeys();   // 将数据库中已有的内容哈希载入布隆过滤器与感知哈希索引
+
+    static HistoryItem readItem(const QSqlQuery& query); // 从查询结果构建记录（不含图片）
+    static QString thumbnailKey(const HistoryItem& item); // 缩略图缓存键
 };
\ No newline at end of file
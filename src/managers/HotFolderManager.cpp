@@ -0,0 +1,354 @@
+#include "HotFolderManager.h"
+#include "HistoryManager.h"
+#include "../core/OCRPipeline.h"
+#include "../core/BatchSource.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <QCryptographicHash>
+#include <QTextStream>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+
+namespace {
+const char* const kContextPrefix = "hot:";
+// 持久化的已识别哈希上限；超过后淘汰最早的，文件中多出的行累计到上限的四分之一时重写
+const int kMaxSeenHashes = 50000;
+
+QStringList imageNameFilters() {
+    return QStringList() << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp" << "*.gif"
+                         << "*.tif" << "*.tiff" << "*.webp";
+}
+}
+
+HotFolderManager::HotFolderManager(OCRPipeline* pipeline, HistoryManager* historyManager, QObject* parent)
+    : QObject(parent)
+    , m_pipeline(pipeline)
+    , m_historyManager(historyManager)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(500);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &HotFolderManager::rescan);
+    connect(&m_rescanTimer, &QTimer::timeout, this, &HotFolderManager::rescan);
+    connect(&m_settleTimer, &QTimer::timeout, this, &HotFolderManager::checkCandidates);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &HotFolderManager::onDirectoryChanged);
+
+    connect(m_pipeline, &OCRPipeline::recognitionCompleted, this, &HotFolderManager::onRecognitionCompleted);
+    connect(m_pipeline, &OCRPipeline::recognitionFailed, this, &HotFolderManager::onRecognitionFailed);
+
+    loadSeenHashes();
+}
+
+HotFolderManager::~HotFolderManager() {
+    stop();
+}
+
+QString HotFolderManager::sidecarPath(const QString& imagePath) {
+    QFileInfo info(imagePath);
+    return info.absolutePath() + "/" + info.fileName() + ".ocr.txt";
+}
+
+bool HotFolderManager::isHotFolderContext(const QString& contextId) {
+    return contextId.startsWith(QLatin1String(kContextPrefix));
+}
+
+QString HotFolderManager::seenHashesPath() const {
+    return QDir::currentPath() + "/batch/hotfolder_seen.txt";
+}
+
+void HotFolderManager::loadSeenHashes() {
+    QFile file(seenHashesPath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+    int lines = 0;
+    while (!file.atEnd()) {
+        const QString hash = QString::fromLatin1(file.readLine()).trimmed();
+        if (hash.isEmpty()) continue;
+        lines++;
+        if (m_seenHashes.contains(hash)) continue;
+        m_seenHashes.insert(hash);
+        m_seenOrder.enqueue(hash);
+        if (m_seenOrder.size() > kMaxSeenHashes) {
+            m_seenHashes.remove(m_seenOrder.dequeue());
+        }
+    }
+    file.close();
+    if (lines > m_seenOrder.size()) {
+        rewriteSeenHashes();
+    }
+}
+
+void HotFolderManager::markSeen(const QString& hash) {
+    if (hash.isEmpty() || m_seenHashes.contains(hash)) return;
+    m_seenHashes.insert(hash);
+    m_seenOrder.enqueue(hash);
+    if (m_seenOrder.size() > kMaxSeenHashes) {
+        m_seenHashes.remove(m_seenOrder.dequeue());
+    }
+
+    if (++m_seenAppended > kMaxSeenHashes / 4 && m_seenOrder.size() >= kMaxSeenHashes) {
+        rewriteSeenHashes();
+        return;
+    }
+    QDir().mkpath(QFileInfo(seenHashesPath()).absolutePath());
+    QFile file(seenHashesPath());
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        file.write(hash.toLatin1());
+        file.write("\n");
+    }
+}
+
+void HotFolderManager::rewriteSeenHashes() {
+    m_seenAppended = 0;
+    QDir().mkpath(QFileInfo(seenHashesPath()).absolutePath());
+    QSaveFile file(seenHashesPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "HotFolderManager: Failed to rewrite" << file.fileName() << file.errorString();
+        return;
+    }
+    for (const QString& hash : m_seenOrder) {
+        file.write(hash.toLatin1());
+        file.write("\n");
+    }
+    if (!file.commit()) {
+        qWarning() << "HotFolderManager: Failed to rewrite" << file.fileName() << file.errorString();
+    }
+}
+
+void HotFolderManager::start(const Settings& settings) {
+    stop();
+    m_settings = settings;
+    m_settings.concurrency = qMax(1, m_settings.concurrency);
+
+    QStringList folders;
+    for (const QString& folder : settings.folders) {
+        const QString path = QDir::cleanPath(folder.trimmed());
+        if (path.isEmpty()) continue;
+        if (!QFileInfo(path).isDir()) {
+            qWarning() << "HotFolderManager: Folder does not exist:" << path;
+            continue;
+        }
+        folders << path;
+    }
+    if (folders.isEmpty()) return;
+
+    m_settings.folders = folders;
+    m_watcher.addPaths(folders);
+    m_rescanTimer.start(qMax(1000, m_settings.rescanMs));
+    m_settleTimer.setInterval(qMax(200, m_settings.settleMs / 2));
+    m_running = true;
+    qDebug() << "HotFolderManager: Watching" << folders << "concurrency" << m_settings.concurrency;
+
+    rescan();
+}
+
+void HotFolderManager::stop() {
+    if (!m_watcher.directories().isEmpty()) {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+    m_debounceTimer.stop();
+    m_rescanTimer.stop();
+    m_settleTimer.stop();
+    m_candidates.clear();
+    m_queue.clear();
+    m_pendingHashes.clear();
+    // 已提交的任务继续完成，结果照常输出
+    m_running = false;
+}
+
+void HotFolderManager::onDirectoryChanged(const QString& path) {
+    Q_UNUSED(path);
+    // 拷贝大文件时会连续触发多次通知，合并后再扫描
+    m_debounceTimer.start();
+}
+
+void HotFolderManager::rescan() {
+    if (!m_running) return;
+    for (const QString& folder : m_settings.folders) {
+        scanFolder(folder);
+    }
+    checkCandidates();
+}
+
+void HotFolderManager::scanFolder(const QString& folder) {
+    QDir dir(folder);
+    const QFileInfoList files = dir.entryInfoList(imageNameFilters(), QDir::Files | QDir::Readable, QDir::Time | QDir::Reversed);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const bool sidecar = m_settings.output != OutputMode::History;
+
+    for (const QFileInfo& info : files) {
+        const QString path = info.absoluteFilePath();
+        if (m_known.contains(path)) continue;
+
+        // 已有识别结果的文件视为处理过
+        if (sidecar && QFile::exists(sidecarPath(path))) {
+            m_known.insert(path);
+            continue;
+        }
+
+        auto it = m_candidates.find(path);
+        if (it == m_candidates.end()) {
+            Candidate candidate;
+            candidate.size = info.size();
+            candidate.modified = info.lastModified();
+            candidate.stableSinceMs = now;
+            m_candidates.insert(path, candidate);
+        }
+    }
+
+    if (!m_candidates.isEmpty() && !m_settleTimer.isActive()) {
+        m_settleTimer.start();
+    }
+}
+
+void HotFolderManager::checkCandidates() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_candidates.begin(); it != m_candidates.end();) {
+        QFileInfo info(it.key());
+        if (!info.exists()) {
+            it = m_candidates.erase(it);
+            continue;
+        }
+
+        // 仍在写入：大小或修改时间变化则重新计时
+        if (info.size() != it->size || info.lastModified() != it->modified || info.size() == 0) {
+            it->size = info.size();
+            it->modified = info.lastModified();
+            it->stableSinceMs = now;
+            ++it;
+            continue;
+        }
+        if (now - it->stableSinceMs < m_settings.settleMs) {
+            ++it;
+            continue;
+        }
+
+        // 部分扫描仪写完前会独占文件，能以只读方式打开再处理
+        QFile probe(it.key());
+        if (!probe.open(QIODevice::ReadOnly)) {
+            ++it;
+            continue;
+        }
+        probe.close();
+
+        const QString path = it.key();
+        it = m_candidates.erase(it);
+        m_known.insert(path);
+        hashAndEnqueue(path);
+    }
+
+    if (m_candidates.isEmpty()) {
+        m_settleTimer.stop();
+    }
+}
+
+void HotFolderManager::hashAndEnqueue(const QString& path) {
+    // 文件内容哈希在后台计算，同一份扫描件被重复投递（改名/复制）时只识别一次
+    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, path]() {
+        const QString hash = watcher->result();
+        watcher->deleteLater();
+        if (!m_running) return;
+
+        if (hash.isEmpty()) {
+            emit fileProcessed(path, false, "无法读取文件");
+            return;
+        }
+        if (m_seenHashes.contains(hash) || m_pendingHashes.contains(hash)) {
+            qDebug() << "HotFolderManager: Duplicate content, skipping" << path;
+            return;
+        }
+
+        m_pendingHashes.insert(hash);
+        m_fileHashes.insert(path, hash);
+        m_queue.append(path);
+        pump();
+    });
+    watcher->setFuture(QtConcurrent::run([path]() -> QString {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return QString();
+        QCryptographicHash hasher(QCryptographicHash::Md5);
+        if (!hasher.addData(&file)) return QString();
+        return QString::fromLatin1(hasher.result().toHex());
+    }));
+}
+
+void HotFolderManager::pump() {
+    while (m_inFlight.size() < m_settings.concurrency && !m_queue.isEmpty()) {
+        const QString path = m_queue.takeFirst();
+
+        OCRRequest request;
+        request.imageLoader = [path]() { return BatchSource::decode(path); };
+        request.filePath = path;
+        request.source = SubmitSource::HotFolder;
+        request.prompt = m_settings.prompt;
+        request.contextId = QString("%1%2").arg(kContextPrefix).arg(++m_nextId);
+        request.priority = OCRRequest::PriorityBatch;
+
+        m_inFlight.insert(request.contextId, path);
+        m_pipeline->submit(request);
+    }
+    emit queueChanged(m_queue.size(), m_inFlight.size());
+}
+
+void HotFolderManager::schedulePump() {
+    if (m_pumpScheduled) return;
+    m_pumpScheduled = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_pumpScheduled = false;
+        pump();
+    }, Qt::QueuedConnection);
+}
+
+void HotFolderManager::finishItem(const QString& contextId) {
+    const QString path = m_inFlight.take(contextId);
+    m_pendingHashes.remove(m_fileHashes.take(path));
+    // 没有可用模型时 submit() 同步发出失败信号，直接 pump() 会随排队文件数递归
+    schedulePump();
+}
+
+void HotFolderManager::onRecognitionCompleted(const OCRResult& result, const QImage& image, SubmitSource source, const QString& contextId) {
+    Q_UNUSED(image);
+    if (!m_inFlight.contains(contextId)) return;
+    const QString path = m_inFlight.value(contextId);
+
+    if (m_settings.output != OutputMode::History) {
+        QFile file(sidecarPath(path));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            QTextStream out(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            out.setCodec("UTF-8");
+#endif
+            out << result.fullText;
+        } else {
+            qWarning() << "HotFolderManager: Failed to write result:" << file.fileName() << file.errorString();
+        }
+    }
+    if (m_settings.output != OutputMode::Sidecar && m_historyManager) {
+        // 不带原图：监视文件夹的图片仍在原位置，历史中不再保存一份像素
+        HistoryItem item;
+        item.result = result;
+        item.source = source;
+        item.timestamp = result.timestamp;
+        item.contentHash = result.contentHash;
+        item.requestKey = result.requestKey;
+        item.perceptualHash = result.perceptualHash;
+        m_historyManager->addHistoryItem(item);
+    }
+
+    markSeen(m_fileHashes.value(path));
+    emit fileProcessed(path, true, result.fromCache ? "命中缓存" : QString("耗时 %1ms").arg(result.processingTimeMs));
+    finishItem(contextId);
+}
+
+void HotFolderManager::onRecognitionFailed(const QString& error, const QImage& image, SubmitSource source, const QString& contextId) {
+    Q_UNUSED(image);
+    Q_UNUSED(source);
+    if (!m_inFlight.contains(contextId)) return;
+
+    // 失败的文件本次运行不再重试，重启后会重新识别
+    qWarning() << "HotFolderManager: Recognition failed for" << m_inFlight.value(contextId) << error;
+    emit fileProcessed(m_inFlight.value(contextId), false, error);
+    finishItem(contextId);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QQueue>
+#include <QStringList>
+#include <QDateTime>
+#include "../core/OCRResult.h"
+
+class OCRPipeline;
+class HistoryManager;
+
+// 监视文件夹管理器
+// 监视配置的目录（QFileSystemWatcher + 定时全量扫描兜底，网络共享目录上的变更通知并不可靠），
+// 文件大小与修改时间稳定一段时间后才视为写入完成，按文件内容哈希去重，
+// 以批量优先级提交到 OCRPipeline，结果写到图片旁的 .ocr.txt 和/或历史记录
+class HotFolderManager : public QObject {
+    Q_OBJECT
+
+public:
+    enum class OutputMode { Sidecar, History, Both };
+
+    struct Settings {
+        QStringList folders;
+        int concurrency = 2;          // 同时识别的文件数
+        OutputMode output = OutputMode::Sidecar;
+        QString prompt;               // 为空时使用模型默认提示词
+        int settleMs = 2000;          // 文件大小/时间保持不变多久视为写入完成
+        int rescanMs = 30000;         // 全量扫描间隔
+    };
+
+    HotFolderManager(OCRPipeline* pipeline, HistoryManager* historyManager, QObject* parent = nullptr);
+    ~HotFolderManager() override;
+
+    // 应用设置并开始监视；folders 为空时停止
+    void start(const Settings& settings);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    int queuedCount() const { return m_queue.size(); }
+    int inFlightCount() const { return m_inFlight.size(); }
+
+    // 识别结果旁路文件路径 (<目录>/<文件名>.ocr.txt)
+    static QString sidecarPath(const QString& imagePath);
+
+    // 是否为监视文件夹提交的任务 (按 contextId 前缀判断)，界面据此跳过这些任务的状态更新
+    static bool isHotFolderContext(const QString& contextId);
+
+signals:
+    void fileProcessed(const QString& path, bool success, const QString& message);
+    void queueChanged(int queued, int inFlight);
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void rescan();
+    void checkCandidates();
+    void onRecognitionCompleted(const OCRResult& result, const QImage& image, SubmitSource source, const QString& contextId);
+    void onRecognitionFailed(const QString& error, const QImage& image, SubmitSource source, const QString& contextId);
+
+private:
+    struct Candidate {
+        qint64 size = -1;
+        QDateTime modified;
+        qint64 stableSinceMs = 0;   // 最近一次观察到变化的时间
+    };
+
+    void scanFolder(const QString& folder);
+    void hashAndEnqueue(const QString& path);
+    void pump();
+    void schedulePump();      // 合并到事件循环中执行，避免同步失败的提交回调中递归 pump()
+    void finishItem(const QString& contextId);
+    void loadSeenHashes();
+    void markSeen(const QString& hash);
+    void rewriteSeenHashes(); // 只保留最近的哈希重写持久化文件
+    QString seenHashesPath() const;
+
+    OCRPipeline* m_pipeline;
+    HistoryManager* m_historyManager;
+    Settings m_settings;
+    bool m_running = false;
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounceTimer;   // 目录变更通知合并
+    QTimer m_rescanTimer;     // 定时全量扫描
+    QTimer m_settleTimer;     // 检查待稳定文件
+
+    QHash<QString, Candidate> m_candidates; // 尚未稳定的新文件
+    QSet<QString> m_known;                  // 本次运行已处理或已入队的文件
+    QSet<QString> m_seenHashes;             // 已成功识别的文件内容哈希 (持久化)
+    QQueue<QString> m_seenOrder;            // 同上，按识别先后排列，超过上限时淘汰最早的
+    int m_seenAppended = 0;                 // 上次重写文件后追加的行数
+    QSet<QString> m_pendingHashes;          // 排队或识别中的哈希，避免同内容文件重复入队
+    QStringList m_queue;                    // 等待提交的文件
+    QHash<QString, QString> m_inFlight;     // contextId → 文件路径
+    QHash<QString, QString> m_fileHashes;   // 文件路径 → 内容哈希
+    quint64 m_nextId = 0;
+    bool m_pumpScheduled = false;
+};
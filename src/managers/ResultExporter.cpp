@@ -0,0 +1,232 @@
+#include "ResultExporter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPdfWriter>
+#include <QPainter>
+#include <QTextLayout>
+#include <QDebug>
+#include <memory>
+
+namespace {
+QString csvField(const QString& value) {
+    if (!value.contains(',') && !value.contains('"') && !value.contains('\n') && !value.contains('\r')) {
+        return value;
+    }
+    QString escaped = value;
+    escaped.replace("\"", "\"\"");
+    return "\"" + escaped + "\"";
+}
+}
+
+ResultExporter::Format ResultExporter::formatForFile(const QString& fileName) {
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "csv") return Format::Csv;
+    if (suffix == "md" || suffix == "markdown") return Format::Markdown;
+    if (suffix == "pdf") return Format::Pdf;
+    return Format::Jsonl;
+}
+
+QString ResultExporter::fileFilters() {
+    return "JSON Lines (*.jsonl);;Excel 表格 (*.csv);;Markdown (*.md);;PDF 文档 (*.pdf)";
+}
+
+ResultExporter::Record ResultExporter::fromHistoryItem(const HistoryItem& item) {
+    Record record;
+    record.path = item.imagePath.isEmpty() ? QString::number(item.id) : item.imagePath;
+    record.modelName = item.result.modelName;
+    record.processingTimeMs = item.result.processingTimeMs;
+    record.timestamp = item.timestamp;
+    record.success = item.result.success;
+    record.fullText = item.result.fullText;
+    record.error = item.result.errorMessage;
+    return record;
+}
+
+ResultExporter::RecordSource ResultExporter::listSource(const QVector<Record>& records) {
+    std::shared_ptr<int> next = std::make_shared<int>(0);
+    return [records, next](Record& record) -> bool {
+        if (*next >= records.size()) return false;
+        record = records.at((*next)++);
+        return true;
+    };
+}
+
+ResultExporter::RecordSource ResultExporter::historySource(HistoryManager* historyManager, const HistoryManager::HistoryFilter& filter, int pageSize) {
+    // 各页状态由 shared_ptr 持有，RecordSource 可按值拷贝到工作线程
+    struct State {
+        QVector<HistoryItem> page;
+        int pageIndex = 0;
+        int offset = 0;
+        bool exhausted = false;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    const int size = qMax(1, pageSize);
+
+    return [historyManager, filter, size, state](Record& record) -> bool {
+        if (state->offset >= state->page.size()) {
+            if (state->exhausted) return false;
+            state->page = historyManager->getHistoryList(++state->pageIndex, size, filter);
+            state->offset = 0;
+            if (state->page.size() < size) state->exhausted = true;
+            if (state->page.isEmpty()) return false;
+        }
+        record = fromHistoryItem(state->page.at(state->offset++));
+        return true;
+    };
+}
+
+int ResultExporter::exportTo(const QString& fileName, Format format, const RecordSource& source, QString* errorMessage) {
+    if (format == Format::Pdf) {
+        return writePdf(fileName, source, errorMessage);
+    }
+    return writeText(fileName, format, source, errorMessage);
+}
+
+int ResultExporter::writeText(const QString& fileName, Format format, const RecordSource& source, QString* errorMessage) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return -1;
+    }
+
+    QTextStream out(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    out.setCodec("UTF-8");
+#endif
+    if (format == Format::Csv) {
+        // UTF-8 BOM 以兼容 Excel
+        out.setGenerateByteOrderMark(true);
+        out << "path,model,prompt,time_ms,timestamp,status,text,error\r\n";
+    }
+
+    int count = 0;
+    Record record;
+    while (source(record)) {
+        switch (format) {
+        case Format::Jsonl: {
+            QJsonObject obj;
+            obj["path"] = record.path;
+            obj["model"] = record.modelName;
+            obj["prompt"] = record.prompt;
+            obj["time_ms"] = static_cast<double>(record.processingTimeMs);
+            obj["timestamp"] = record.timestamp.toString(Qt::ISODate);
+            obj["success"] = record.success;
+            obj["text"] = record.fullText;
+            if (!record.error.isEmpty()) obj["error"] = record.error;
+            out << QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact)) << "\n";
+            break;
+        }
+        case Format::Csv:
+            out << csvField(record.path) << ','
+                << csvField(record.modelName) << ','
+                << csvField(record.prompt) << ','
+                << record.processingTimeMs << ','
+                << record.timestamp.toString(Qt::ISODate) << ','
+                << (record.success ? "ok" : "failed") << ','
+                << csvField(record.fullText) << ','
+                << csvField(record.error) << "\r\n";
+            break;
+        case Format::Markdown:
+            out << "## " << QFileInfo(record.path).fileName() << "\n\n";
+            out << "> " << record.modelName;
+            if (record.processingTimeMs > 0) out << " · " << record.processingTimeMs << "ms";
+            if (record.timestamp.isValid()) out << " · " << record.timestamp.toString("yyyy-MM-dd HH:mm:ss");
+            out << "\n\n";
+            if (!record.fullText.isEmpty()) out << record.fullText << "\n\n";
+            if (!record.success) out << QString("**识别失败**: %1").arg(record.error) << "\n\n";
+            out << "---\n\n";
+            break;
+        case Format::Pdf:
+            break;
+        }
+        count++;
+    }
+
+    out.flush();
+    if (out.status() != QTextStream::Ok) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return -1;
+    }
+    return count;
+}
+
+int ResultExporter::writePdf(const QString& fileName, const RecordSource& source, QString* errorMessage) {
+    // 逐条排版并按页输出，不在内存中拼接整份文档
+    QPdfWriter writer(fileName);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setResolution(150);
+    writer.setPageMargins(QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter);
+
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        if (errorMessage) *errorMessage = "无法创建 PDF 文件";
+        return -1;
+    }
+
+    const QRect page = painter.viewport();
+    const qreal width = page.width();
+    qreal y = 0;
+
+    QFont headingFont = painter.font();
+    headingFont.setPointSizeF(12);
+    headingFont.setBold(true);
+    QFont metaFont = painter.font();
+    metaFont.setPointSizeF(8);
+    QFont bodyFont = painter.font();
+    bodyFont.setPointSizeF(10);
+
+    // 排版一段文本，超出页底时换页
+    auto drawParagraph = [&](const QString& text, const QFont& font, const QColor& color) {
+        painter.setFont(font);
+        painter.setPen(color);
+        const QStringList lines = text.split('\n');
+        for (const QString& line : lines) {
+            QTextLayout layout(line, font, &writer);
+            layout.beginLayout();
+            qreal lineY = 0;
+            for (;;) {
+                QTextLine textLine = layout.createLine();
+                if (!textLine.isValid()) break;
+                textLine.setLineWidth(width);
+                textLine.setPosition(QPointF(0, lineY));
+                lineY += textLine.height();
+            }
+            layout.endLayout();
+
+            // 段落可能跨页，逐行绘制
+            for (int i = 0; i < layout.lineCount(); ++i) {
+                QTextLine textLine = layout.lineAt(i);
+                if (y + textLine.height() > page.height()) {
+                    writer.newPage();
+                    y = 0;
+                }
+                textLine.draw(&painter, QPointF(0, y - textLine.y()));
+                y += textLine.height();
+            }
+        }
+    };
+
+    int count = 0;
+    Record record;
+    while (source(record)) {
+        drawParagraph(QFileInfo(record.path).fileName(), headingFont, Qt::black);
+        QString meta = record.modelName;
+        if (record.processingTimeMs > 0) meta += QString(" · %1ms").arg(record.processingTimeMs);
+        if (record.timestamp.isValid()) meta += " · " + record.timestamp.toString("yyyy-MM-dd HH:mm:ss");
+        drawParagraph(meta, metaFont, QColor(120, 120, 120));
+        if (!record.fullText.isEmpty()) {
+            drawParagraph(record.fullText, bodyFont, Qt::black);
+        }
+        if (!record.success) {
+            drawParagraph("识别失败: " + record.error, bodyFont, QColor(200, 40, 40));
+        }
+        y += QFontMetricsF(bodyFont, &writer).height();
+        count++;
+    }
+
+    painter.end();
+    return count;
+}
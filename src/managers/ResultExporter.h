@@ -0,0 +1,46 @@
+#pragma once
+#include <QString>
+#include <QDateTime>
+#include <functional>
+#include "HistoryManager.h"
+
+// 结果批量导出
+// 记录通过 RecordSource 逐条拉取并立即写出 (JSONL / CSV / Markdown / PDF)，
+// 内存占用与记录总数无关，可在工作线程中运行
+class ResultExporter {
+public:
+    enum class Format { Jsonl, Csv, Markdown, Pdf };
+
+    struct Record {
+        QString path;           // 图片路径 (批量) 或历史记录 ID
+        QString modelName;
+        QString prompt;
+        qint64 processingTimeMs = 0;
+        QDateTime timestamp;
+        bool success = false;
+        QString fullText;
+        QString error;
+    };
+
+    // 取下一条记录，没有更多时返回 false
+    typedef std::function<bool(Record&)> RecordSource;
+
+    static Format formatForFile(const QString& fileName);
+    static QString fileFilters();
+
+    // 流式导出，返回写出的记录数；失败返回 -1 并写入 errorMessage
+    static int exportTo(const QString& fileName, Format format, const RecordSource& source, QString* errorMessage = nullptr);
+
+    static Record fromHistoryItem(const HistoryItem& item);
+
+    // 依次返回内存中的记录 (QString 隐式共享，拷贝开销很小)
+    static RecordSource listSource(const QVector<Record>& records);
+
+    // 按筛选条件分页读取持久化的历史记录 (每页一次查询，工作线程使用独立连接)
+    // 未开启持久化时历史只在内存中，应在界面线程用 listSource 快照
+    static RecordSource historySource(HistoryManager* historyManager, const HistoryManager::HistoryFilter& filter, int pageSize = 200);
+
+private:
+    static int writeText(const QString& fileName, Format format, const RecordSource& source, QString* errorMessage);
+    static int writePdf(const QString& fileName, const RecordSource& source, QString* errorMessage);
+};
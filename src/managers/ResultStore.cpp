@@ -0,0 +1,568 @@
+#include "ResultStore.h"
+#include <QDir>
+#include <QDebug>
+#include <QDataStream>
+#include <QDateTime>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const quint32 kRecordMagic = 0x58535243;   // "XSRC"
+const quint32 kIndexMagic = 0x58535249;    // "XSRI"
+const quint32 kIndexVersion = 1;
+const int kKeySize = 16;                   // MD5 二进制
+const int kRecordHeaderSize = 8 + kKeySize + 4; // magic + 长度 + 键 + 写入时间
+const int kIndexHeaderSize = 32;           // magic + 版本 + 条目数 + 保留 + 数据末尾偏移 + 保留
+const int kIndexEntrySize = 32;            // 键 + 偏移 + 长度 + 写入时间
+const int kFlushThreshold = 256;           // 待合并条目超过该数量时重建索引
+const double kCompactTargetRatio = 0.8;    // 压缩后的目标占用，留出余量避免频繁压缩
+const char kBackupSuffix[] = ".bak";        // 压缩替换文件期间旧文件的备份后缀
+
+void writeIndexEntry(uchar* dst, const QByteArray& key, quint64 offset, quint32 length, quint32 storedAt) {
+    memcpy(dst, key.constData(), kKeySize);
+    qToLittleEndian<quint64>(offset, dst + 16);
+    qToLittleEndian<quint32>(length, dst + 24);
+    qToLittleEndian<quint32>(storedAt, dst + 28);
+}
+}
+
+ResultStore::ResultStore(const QString& dirPath, QObject* parent)
+    : QObject(parent)
+    , m_dirPath(dirPath.isEmpty() ? QDir::currentPath() + "/cache" : dirPath)
+{
+}
+
+ResultStore::~ResultStore() {
+    m_compactFuture.waitForFinished();
+    QMutexLocker locker(&m_mutex);
+    if (m_opened) {
+        flushLocked();
+        closeLocked();
+    }
+}
+
+bool ResultStore::open() {
+    QMutexLocker locker(&m_mutex);
+    if (!m_opened && !openLocked()) return false;
+    if (needsCompactionLocked(true)) {
+        compactLocked();
+    }
+    return m_opened;
+}
+
+void ResultStore::openAsync() {
+    QMutexLocker locker(&m_mutex);
+    m_compactScheduled = true;
+    m_compactFuture = QtConcurrent::run([this]() {
+        open();
+        QMutexLocker innerLocker(&m_mutex);
+        m_compactScheduled = false;
+    });
+}
+
+bool ResultStore::openLocked() {
+    QDir().mkpath(m_dirPath);
+    // 上次压缩替换文件时中断：回到压缩前的一对文件
+    restoreBackupsLocked();
+
+    m_dataFile.setFileName(m_dirPath + "/results.dat");
+    if (!m_dataFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "ResultStore: Failed to open data file:" << m_dataFile.errorString();
+        return false;
+    }
+
+    m_indexFile.setFileName(m_dirPath + "/results.idx");
+    quint64 dataEnd = 0;
+    if (!mapIndexLocked(dataEnd) || dataEnd > static_cast<quint64>(m_dataFile.size())) {
+        // 索引缺失或与数据文件不一致：丢弃索引，从头扫描数据文件重建
+        closeIndexLocked();
+        dataEnd = 0;
+    }
+    recoverTailLocked(dataEnd);
+
+    m_opened = true;
+    qDebug() << "ResultStore: Opened" << m_dirPath << "entries:" << m_indexCount + m_pending.size()
+             << "bytes:" << m_dataFile.size();
+    return true;
+}
+
+bool ResultStore::backupLocked(const QString& path) const {
+    // 文件不存在 (如索引尚未写出) 时无需备份
+    if (!QFile::exists(path)) return true;
+    if (!QFile::rename(path, path + kBackupSuffix)) {
+        qWarning() << "ResultStore: Failed to back up" << path;
+        return false;
+    }
+    return true;
+}
+
+void ResultStore::restoreBackupsLocked() const {
+    const QStringList paths = QStringList() << m_dirPath + "/results.dat" << m_dirPath + "/results.idx";
+    for (const QString& path : paths) {
+        const QString backup = path + kBackupSuffix;
+        if (!QFile::exists(backup)) continue;
+        QFile::remove(path);
+        if (QFile::rename(backup, path)) {
+            qWarning() << "ResultStore: Restored" << path << "from backup";
+        } else {
+            qWarning() << "ResultStore: Failed to restore" << path << "from backup";
+        }
+    }
+}
+
+void ResultStore::closeIndexLocked() {
+    if (m_indexMap) {
+        m_indexFile.unmap(m_indexMap);
+        m_indexMap = nullptr;
+    }
+    m_indexFile.close();
+    m_index = nullptr;
+    m_indexCount = 0;
+}
+
+void ResultStore::closeLocked() {
+    closeIndexLocked();
+    m_dataFile.close();
+    m_pending.clear();
+    m_opened = false;
+}
+
+bool ResultStore::mapIndexLocked(quint64& dataEnd) {
+    if (!m_indexFile.exists() || !m_indexFile.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = m_indexFile.size();
+    if (size < kIndexHeaderSize) return false;
+
+    m_indexMap = m_indexFile.map(0, size);
+    if (!m_indexMap) {
+        qWarning() << "ResultStore: Failed to map index:" << m_indexFile.errorString();
+        return false;
+    }
+
+    const quint32 magic = qFromLittleEndian<quint32>(m_indexMap);
+    const quint32 version = qFromLittleEndian<quint32>(m_indexMap + 4);
+    const quint32 count = qFromLittleEndian<quint32>(m_indexMap + 8);
+    if (magic != kIndexMagic || version != kIndexVersion
+        || size != kIndexHeaderSize + static_cast<qint64>(count) * kIndexEntrySize) {
+        qWarning() << "ResultStore: Invalid index file, rebuilding";
+        return false;
+    }
+
+    dataEnd = qFromLittleEndian<quint64>(m_indexMap + 16);
+    m_index = m_indexMap + kIndexHeaderSize;
+    m_indexCount = count;
+    return true;
+}
+
+void ResultStore::recoverTailLocked(quint64 from) {
+    // 索引之后追加的记录 (上次未 flush 即退出) 重新登记到待合并表；遇到残缺记录时截断
+    const qint64 fileSize = m_dataFile.size();
+    qint64 pos = static_cast<qint64>(from);
+    while (pos + kRecordHeaderSize <= fileSize) {
+        m_dataFile.seek(pos);
+        const QByteArray header = m_dataFile.read(kRecordHeaderSize);
+        if (header.size() != kRecordHeaderSize) break;
+
+        const uchar* p = reinterpret_cast<const uchar*>(header.constData());
+        const quint32 magic = qFromLittleEndian<quint32>(p);
+        const quint32 bodyLength = qFromLittleEndian<quint32>(p + 4);
+        const qint64 length = 8 + static_cast<qint64>(bodyLength);
+        if (magic != kRecordMagic || bodyLength < kKeySize + 4 || pos + length > fileSize) break;
+
+        Location location;
+        location.offset = static_cast<quint64>(pos);
+        location.length = static_cast<quint32>(length);
+        location.storedAt = qFromLittleEndian<quint32>(p + 8 + kKeySize);
+        m_pending.insert(header.mid(8, kKeySize), location);
+        pos += length;
+    }
+
+    if (pos < fileSize) {
+        qWarning() << "ResultStore: Truncating incomplete records at" << pos;
+        m_dataFile.resize(pos);
+    }
+}
+
+bool ResultStore::writeIndexLocked(QFile& file, const QHash<QByteArray, Location>& entries, quint64 dataEnd) const {
+    QList<QByteArray> keys = entries.keys();
+    std::sort(keys.begin(), keys.end());
+
+    QByteArray buffer(kIndexHeaderSize + keys.size() * kIndexEntrySize, '\0');
+    uchar* p = reinterpret_cast<uchar*>(buffer.data());
+    qToLittleEndian<quint32>(kIndexMagic, p);
+    qToLittleEndian<quint32>(kIndexVersion, p + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(keys.size()), p + 8);
+    qToLittleEndian<quint64>(dataEnd, p + 16);
+
+    uchar* entry = p + kIndexHeaderSize;
+    for (const QByteArray& key : keys) {
+        const Location& location = entries[key];
+        writeIndexEntry(entry, key, location.offset, location.length, location.storedAt);
+        entry += kIndexEntrySize;
+    }
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "ResultStore: Failed to write index:" << file.errorString();
+        return false;
+    }
+    const bool ok = file.write(buffer) == buffer.size();
+    file.close();
+    return ok;
+}
+
+void ResultStore::flush() {
+    QMutexLocker locker(&m_mutex);
+    if (m_opened) flushLocked();
+}
+
+void ResultStore::flushLocked() {
+    if (m_pending.isEmpty()) return;
+
+    m_dataFile.flush();
+    const QHash<QByteArray, Location> entries = allEntriesLocked();
+    const QString indexPath = m_indexFile.fileName();
+    QFile tmp(indexPath + ".tmp");
+    if (!writeIndexLocked(tmp, entries, static_cast<quint64>(m_dataFile.size()))) return;
+
+    // 替换前先解除映射 (Windows 下映射中的文件无法删除)
+    closeIndexLocked();
+    QFile::remove(indexPath);
+    if (!tmp.rename(indexPath)) {
+        qWarning() << "ResultStore: Failed to replace index:" << tmp.errorString();
+        m_pending = entries;
+        return;
+    }
+
+    quint64 dataEnd = 0;
+    if (mapIndexLocked(dataEnd)) {
+        m_pending.clear();
+    } else {
+        closeIndexLocked();
+        m_pending = entries;
+    }
+}
+
+QHash<QByteArray, ResultStore::Location> ResultStore::allEntriesLocked() const {
+    QHash<QByteArray, Location> entries;
+    entries.reserve(static_cast<int>(m_indexCount) + m_pending.size());
+    for (quint32 i = 0; i < m_indexCount; ++i) {
+        const uchar* entry = m_index + static_cast<qint64>(i) * kIndexEntrySize;
+        Location location;
+        location.offset = qFromLittleEndian<quint64>(entry + 16);
+        location.length = qFromLittleEndian<quint32>(entry + 24);
+        location.storedAt = qFromLittleEndian<quint32>(entry + 28);
+        entries.insert(QByteArray(reinterpret_cast<const char*>(entry), kKeySize), location);
+    }
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        entries.insert(it.key(), it.value());
+    }
+    return entries;
+}
+
+bool ResultStore::findLocked(const QByteArray& key, Location& location) const {
+    auto pending = m_pending.constFind(key);
+    if (pending != m_pending.constEnd()) {
+        location = pending.value();
+        return true;
+    }
+
+    // 映射索引上二分查找
+    quint32 lo = 0;
+    quint32 hi = m_indexCount;
+    while (lo < hi) {
+        const quint32 mid = lo + (hi - lo) / 2;
+        const uchar* entry = m_index + static_cast<qint64>(mid) * kIndexEntrySize;
+        const int cmp = memcmp(entry, key.constData(), kKeySize);
+        if (cmp == 0) {
+            location.offset = qFromLittleEndian<quint64>(entry + 16);
+            location.length = qFromLittleEndian<quint32>(entry + 24);
+            location.storedAt = qFromLittleEndian<quint32>(entry + 28);
+            return true;
+        }
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return false;
+}
+
+bool ResultStore::isExpiredLocked(const Location& location) const {
+    if (m_ttlDays <= 0) return false;
+    const qint64 age = QDateTime::currentSecsSinceEpoch() - static_cast<qint64>(location.storedAt);
+    return age > static_cast<qint64>(m_ttlDays) * 24 * 3600;
+}
+
+bool ResultStore::needsCompactionLocked(bool checkExpired) const {
+    if (!m_opened) return false;
+    if (m_dataFile.size() > m_maxBytes) return true;
+    if (!checkExpired || m_ttlDays <= 0) return false;
+
+    // 扫描映射索引中的写入时间即可，无需读取数据文件
+    for (quint32 i = 0; i < m_indexCount; ++i) {
+        Location location;
+        location.storedAt = qFromLittleEndian<quint32>(m_index + static_cast<qint64>(i) * kIndexEntrySize + 28);
+        if (isExpiredLocked(location)) return true;
+    }
+    for (const Location& location : m_pending) {
+        if (isExpiredLocked(location)) return true;
+    }
+    return false;
+}
+
+bool ResultStore::lookup(const QString& hash, OCRResult& result) {
+    const QByteArray key = keyFromHash(hash);
+    if (key.isEmpty()) return false;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_opened && !openLocked()) return false;
+
+    Location location;
+    if (!findLocked(key, location) || isExpiredLocked(location)) {
+        m_stats.misses++;
+        return false;
+    }
+
+    m_dataFile.seek(static_cast<qint64>(location.offset));
+    const QByteArray record = m_dataFile.read(location.length);
+    if (!decodeRecord(record, key, result)) {
+        qWarning() << "ResultStore: Corrupted record for" << hash;
+        m_stats.misses++;
+        return false;
+    }
+
+    m_stats.hits++;
+    return true;
+}
+
+void ResultStore::insert(const QString& hash, const OCRResult& result) {
+    const QByteArray key = keyFromHash(hash);
+    if (key.isEmpty() || !result.success) return;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_opened && !openLocked()) return;
+
+    const quint32 storedAt = static_cast<quint32>(QDateTime::currentSecsSinceEpoch());
+    const QByteArray record = encodeRecord(key, storedAt, result);
+    const qint64 offset = m_dataFile.size();
+    if (!m_dataFile.seek(offset) || m_dataFile.write(record) != record.size()) {
+        qWarning() << "ResultStore: Failed to append record:" << m_dataFile.errorString();
+        m_dataFile.resize(offset);
+        return;
+    }
+    m_dataFile.flush();
+
+    Location location;
+    location.offset = static_cast<quint64>(offset);
+    location.length = static_cast<quint32>(record.size());
+    location.storedAt = storedAt;
+    m_pending.insert(key, location);
+
+    if (m_pending.size() >= kFlushThreshold) {
+        flushLocked();
+    }
+    if (needsCompactionLocked(false)) {
+        scheduleCompaction();
+    }
+}
+
+void ResultStore::setPolicy(qint64 maxBytes, int ttlDays) {
+    QMutexLocker locker(&m_mutex);
+    if (maxBytes > 0) m_maxBytes = maxBytes;
+    m_ttlDays = qMax(0, ttlDays);
+    if (needsCompactionLocked(true)) {
+        scheduleCompaction();
+    }
+}
+
+void ResultStore::scheduleCompaction() {
+    // 调用方已持有锁；压缩在后台线程执行，期间的查找/写入会等待锁
+    if (m_compactScheduled) return;
+    m_compactScheduled = true;
+    m_compactFuture = QtConcurrent::run([this]() {
+        compact();
+    });
+}
+
+bool ResultStore::compact() {
+    QMutexLocker locker(&m_mutex);
+    m_compactScheduled = false;
+    if (!m_opened && !openLocked()) return false;
+    return compactLocked();
+}
+
+bool ResultStore::compactLocked() {
+    struct Item {
+        QByteArray key;
+        Location location;
+    };
+
+    // 1. 收集未过期条目，按写入时间从新到旧排列
+    const QHash<QByteArray, Location> entries = allEntriesLocked();
+    QVector<Item> items;
+    items.reserve(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (isExpiredLocked(it.value())) continue;
+        Item item;
+        item.key = it.key();
+        item.location = it.value();
+        items.append(item);
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.location.storedAt > b.location.storedAt;
+    });
+
+    // 2. 超出容量时只保留最新的记录，压缩到目标占用
+    qint64 liveBytes = 0;
+    for (const Item& item : items) liveBytes += item.location.length;
+    if (liveBytes > m_maxBytes) {
+        const qint64 target = static_cast<qint64>(m_maxBytes * kCompactTargetRatio);
+        qint64 kept = 0;
+        int count = 0;
+        while (count < items.size() && kept + items.at(count).location.length <= target) {
+            kept += items.at(count).location.length;
+            ++count;
+        }
+        items.resize(count);
+    }
+
+    // 3. 重写数据文件 (从旧到新写入) 与索引
+    const QString dataPath = m_dataFile.fileName();
+    const QString indexPath = m_indexFile.fileName();
+    QFile newData(dataPath + ".tmp");
+    if (!newData.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "ResultStore: Failed to create compacted data file:" << newData.errorString();
+        return false;
+    }
+
+    QHash<QByteArray, Location> newEntries;
+    newEntries.reserve(items.size());
+    for (int i = items.size() - 1; i >= 0; --i) {
+        const Item& item = items.at(i);
+        m_dataFile.seek(static_cast<qint64>(item.location.offset));
+        const QByteArray record = m_dataFile.read(item.location.length);
+        if (record.size() != static_cast<int>(item.location.length)) continue;
+
+        Location location = item.location;
+        location.offset = static_cast<quint64>(newData.pos());
+        if (newData.write(record) != record.size()) {
+            qWarning() << "ResultStore: Failed to write compacted data:" << newData.errorString();
+            newData.close();
+            QFile::remove(newData.fileName());
+            return false;
+        }
+        newEntries.insert(item.key, location);
+    }
+    const quint64 dataEnd = static_cast<quint64>(newData.pos());
+    newData.close();
+
+    QFile newIndex(indexPath + ".tmp");
+    if (!writeIndexLocked(newIndex, newEntries, dataEnd)) {
+        QFile::remove(newData.fileName());
+        return false;
+    }
+
+    const int dropped = entries.size() - newEntries.size();
+    closeLocked();
+
+    // 4. 替换：旧文件先改名为备份，两个新文件都就位后才删除备份；
+    //    任一步失败 (或中途崩溃，下次打开时) 从备份恢复，数据文件与索引始终成对
+    QFile::remove(dataPath + kBackupSuffix);
+    QFile::remove(indexPath + kBackupSuffix);
+    const bool swapped = backupLocked(dataPath) && backupLocked(indexPath)
+                         && newData.rename(dataPath) && newIndex.rename(indexPath);
+    if (swapped) {
+        QFile::remove(dataPath + kBackupSuffix);
+        QFile::remove(indexPath + kBackupSuffix);
+    } else {
+        qWarning() << "ResultStore: Failed to replace store files, keeping the uncompacted store";
+        restoreBackupsLocked();
+        QFile::remove(newData.fileName());
+        QFile::remove(newIndex.fileName());
+    }
+
+    const bool ok = openLocked();
+    qDebug() << "ResultStore: Compacted, kept" << newEntries.size() << "dropped" << dropped
+             << "bytes" << dataEnd;
+    return ok;
+}
+
+void ResultStore::clear() {
+    m_compactFuture.waitForFinished();
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+    QFile::remove(m_dirPath + "/results.dat");
+    QFile::remove(m_dirPath + "/results.idx");
+    openLocked();
+}
+
+ResultStore::Stats ResultStore::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.entries = static_cast<int>(m_indexCount) + m_pending.size();
+    stats.dataBytes = m_opened ? m_dataFile.size() : 0;
+    return stats;
+}
+
+QByteArray ResultStore::keyFromHash(const QString& hash) {
+    const QByteArray key = QByteArray::fromHex(hash.toLatin1());
+    return key.size() == kKeySize ? key : QByteArray();
+}
+
+QByteArray ResultStore::encodeRecord(const QByteArray& key, quint32 storedAt, const OCRResult& result) {
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << quint8(2); // 记录格式版本 (2: 文本块带粒度)
+        out << result.fullText << result.modelName << qint64(result.processingTimeMs);
+        out << quint32(result.textBlocks.size());
+        for (const TextBlock& block : result.textBlocks) {
+            out << block.text << block.boundingBox << block.confidence << quint8(block.level);
+        }
+    }
+
+    QByteArray record(kRecordHeaderSize, '\0');
+    uchar* p = reinterpret_cast<uchar*>(record.data());
+    qToLittleEndian<quint32>(kRecordMagic, p);
+    qToLittleEndian<quint32>(static_cast<quint32>(kKeySize + 4 + payload.size()), p + 4);
+    memcpy(p + 8, key.constData(), kKeySize);
+    qToLittleEndian<quint32>(storedAt, p + 8 + kKeySize);
+    record.append(payload);
+    return record;
+}
+
+bool ResultStore::decodeRecord(const QByteArray& record, const QByteArray& key, OCRResult& result) {
+    if (record.size() < kRecordHeaderSize) return false;
+    const uchar* p = reinterpret_cast<const uchar*>(record.constData());
+    if (qFromLittleEndian<quint32>(p) != kRecordMagic) return false;
+    if (8 + qFromLittleEndian<quint32>(p + 4) != static_cast<quint32>(record.size())) return false;
+    if (memcmp(p + 8, key.constData(), kKeySize) != 0) return false;
+
+    QDataStream in(record.mid(kRecordHeaderSize));
+    in.setVersion(QDataStream::Qt_5_12);
+    quint8 version = 0;
+    in >> version;
+    if (version != 1 && version != 2) return false;
+
+    OCRResult decoded;
+    qint64 processingTimeMs = 0;
+    quint32 blockCount = 0;
+    in >> decoded.fullText >> decoded.modelName >> processingTimeMs >> blockCount;
+    decoded.processingTimeMs = processingTimeMs;
+    for (quint32 i = 0; i < blockCount && in.status() == QDataStream::Ok; ++i) {
+        TextBlock block;
+        in >> block.text >> block.boundingBox >> block.confidence;
+        if (version >= 2) {
+            quint8 level = 0;
+            in >> level;
+            if (level <= TextBlock::Word) block.level = static_cast<TextBlock::Level>(level);
+        }
+        decoded.textBlocks.append(block);
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    decoded.success = true;
+    result = decoded;
+    return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QByteArray>
+#include <QFuture>
+#include "../core/OCRResult.h"
+
+// 持久化结果缓存
+// 内容哈希 → 识别结果，独立于历史记录的保留策略（max_history / 是否持久化）
+//
+// 磁盘格式 (cache 目录):
+//   results.dat  追加写入的记录：[magic][长度][QDataStream 序列化的结果]
+//   results.idx  按键排序的定长索引：[文件头][键(16B) 偏移(8B) 长度(4B) 写入时间(4B)] * N
+//                通过内存映射只读访问，二分查找，不需要整体载入内存
+// 新写入的记录先进入内存待合并表，flush / 压缩时统一重建索引；崩溃后从索引记录的数据末尾重新扫描补齐
+// 所有公开接口线程安全，可在流水线工作线程中调用
+class ResultStore : public QObject {
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int entries = 0;         // 索引 + 待合并条目数
+        qint64 dataBytes = 0;    // 数据文件大小
+    };
+
+    explicit ResultStore(const QString& dirPath = QString(), QObject* parent = nullptr);
+    ~ResultStore() override;
+
+    // 打开 (或创建) 存储并按策略压缩，耗时操作，可在后台线程调用
+    bool open();
+
+    // 在后台线程执行 open()，期间的查找会等待其完成
+    void openAsync();
+
+    // 容量上限 (字节) 与有效期 (天，0 表示永不过期)；超限时在后台压缩
+    void setPolicy(qint64 maxBytes, int ttlDays);
+
+    // 查找结果，过期记录视为未命中
+    bool lookup(const QString& hash, OCRResult& result);
+
+    // 写入成功结果 (追加到数据文件)
+    void insert(const QString& hash, const OCRResult& result);
+
+    // 将待合并条目写入索引文件
+    void flush();
+
+    // 丢弃过期记录并按容量淘汰最旧的记录，重写数据与索引文件
+    bool compact();
+
+    // 删除全部缓存记录
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Location {
+        quint64 offset = 0;
+        quint32 length = 0;
+        quint32 storedAt = 0;    // 写入时间 (秒)
+    };
+
+    // 以下 *Locked 函数要求调用方已持有 m_mutex
+    bool openLocked();
+    void closeLocked();
+    void closeIndexLocked();
+    bool mapIndexLocked(quint64& dataEnd);
+    void recoverTailLocked(quint64 from);
+    bool writeIndexLocked(QFile& file, const QHash<QByteArray, Location>& entries, quint64 dataEnd) const;
+    void flushLocked();
+    bool compactLocked();
+    bool backupLocked(const QString& path) const;
+    void restoreBackupsLocked() const;
+    bool needsCompactionLocked(bool checkExpired) const;
+    bool findLocked(const QByteArray& key, Location& location) const;
+    bool isExpiredLocked(const Location& location) const;
+    QHash<QByteArray, Location> allEntriesLocked() const;
+    void scheduleCompaction();
+
+    static QByteArray keyFromHash(const QString& hash);
+    static QByteArray encodeRecord(const QByteArray& key, quint32 storedAt, const OCRResult& result);
+    static bool decodeRecord(const QByteArray& record, const QByteArray& key, OCRResult& result);
+
+    mutable QMutex m_mutex;
+    QString m_dirPath;
+    QFile m_dataFile;
+    QFile m_indexFile;
+    uchar* m_indexMap = nullptr;     // 索引文件映射基址
+    const uchar* m_index = nullptr;  // 映射的索引条目起始地址
+    quint32 m_indexCount = 0;
+    QHash<QByteArray, Location> m_pending; // 尚未写入索引的新条目 (覆盖索引中的同名键)
+    bool m_opened = false;
+    bool m_compactScheduled = false;
+    QFuture<void> m_compactFuture;
+
+    qint64 m_maxBytes = 256LL * 1024 * 1024;
+    int m_ttlDays = 30;
+    Stats m_stats;
+};
@@ -0,0 +1,122 @@
+#include "BatchDashboard.h"
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QPainter>
+
+BatchDashboard::BatchDashboard(QWidget* parent)
+    : QFrame(parent)
+{
+    setObjectName("batchDashboard");
+    setStyleSheet(
+        "QFrame#batchDashboard { background: rgba(245, 247, 250, 0.95); border: 1px solid #e0e0e0; border-radius: 8px; }"
+        "QLabel { color: #444; font-size: 9pt; background: transparent; border: none; }"
+    );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(10, 6, 10, 6);
+    layout->setSpacing(4);
+
+    QGridLayout* grid = new QGridLayout();
+    grid->setHorizontalSpacing(16);
+    grid->setVerticalSpacing(2);
+    m_progressLabel = new QLabel();
+    m_throughputLabel = new QLabel();
+    m_queueLabel = new QLabel();
+    m_queueLabel->setToolTip("执行中/并发上限：上限按模型的响应延迟与限流、超时情况自动调整");
+    m_cacheLabel = new QLabel();
+    m_failureLabel = new QLabel();
+    m_etaLabel = new QLabel();
+    grid->addWidget(m_progressLabel, 0, 0);
+    grid->addWidget(m_throughputLabel, 0, 1);
+    grid->addWidget(m_etaLabel, 0, 2);
+    grid->addWidget(m_queueLabel, 1, 0);
+    grid->addWidget(m_cacheLabel, 1, 1);
+    grid->addWidget(m_failureLabel, 1, 2);
+    layout->addLayout(grid);
+
+    // 耗时分布在 paintEvent 中绘制到该区域
+    m_histogramArea = new QWidget();
+    m_histogramArea->setFixedHeight(36);
+    m_histogramArea->setToolTip("单张耗时分布 (提交到完成)");
+    layout->addWidget(m_histogramArea);
+
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &BatchDashboard::refresh);
+
+    hide();
+}
+
+void BatchDashboard::track(const BatchStats* stats) {
+    m_stats = stats;
+    refresh();
+    show();
+    m_refreshTimer.start();
+}
+
+void BatchDashboard::stopTracking() {
+    m_refreshTimer.stop();
+    refresh();
+}
+
+QString BatchDashboard::formatDuration(int seconds) {
+    if (seconds < 0) return "--";
+    if (seconds < 60) return QString("%1 秒").arg(seconds);
+    if (seconds < 3600) return QString("%1 分 %2 秒").arg(seconds / 60).arg(seconds % 60);
+    return QString("%1 小时 %2 分").arg(seconds / 3600).arg((seconds % 3600) / 60);
+}
+
+void BatchDashboard::refresh() {
+    if (!m_stats) return;
+    m_snapshot = m_stats->snapshot();
+    const BatchStats::Snapshot& s = m_snapshot;
+
+    const int done = s.restored + s.completed + s.failed;
+    m_progressLabel->setText(QString("进度: %1/%2").arg(done).arg(s.total));
+    m_throughputLabel->setText(QString("吞吐: %1 张/秒").arg(s.throughput, 0, 'f', 2));
+    if (!m_refreshTimer.isActive()) {
+        m_etaLabel->setText(QString("用时: %1").arg(formatDuration(static_cast<int>(s.elapsedMs / 1000))));
+    } else {
+        m_etaLabel->setText(QString("剩余: %1").arg(formatDuration(s.etaSeconds)));
+    }
+    m_queueLabel->setText(QString("执行中: %1/%2 · 排队: %3").arg(s.inFlight).arg(s.concurrency).arg(s.queued));
+    m_cacheLabel->setText(QString("缓存命中: %1 (%2%)")
+                              .arg(s.cacheHits)
+                              .arg(s.cacheHitRatio() * 100.0, 0, 'f', 1));
+    m_failureLabel->setText(QString("失败: %1 · 重试: %2").arg(s.failed).arg(s.retries));
+    update();
+}
+
+void BatchDashboard::paintEvent(QPaintEvent* event) {
+    QFrame::paintEvent(event);
+    if (m_snapshot.histogram.isEmpty()) return;
+
+    const QRect area = m_histogramArea->geometry();
+    const QVector<qint64>& buckets = BatchStats::latencyBuckets();
+    const int count = m_snapshot.histogram.size();
+    int maxValue = 1;
+    for (int value : m_snapshot.histogram) maxValue = qMax(maxValue, value);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QFont font = painter.font();
+    font.setPointSizeF(7.5);
+    painter.setFont(font);
+
+    const int labelHeight = 12;
+    const int gap = 4;
+    const qreal barWidth = (area.width() - gap * (count - 1)) / static_cast<qreal>(count);
+    for (int i = 0; i < count; ++i) {
+        const qreal x = area.left() + i * (barWidth + gap);
+        const int value = m_snapshot.histogram.at(i);
+        const qreal barHeight = (area.height() - labelHeight) * value / static_cast<qreal>(maxValue);
+        QRectF bar(x, area.bottom() - labelHeight - barHeight, barWidth, barHeight);
+        painter.fillRect(bar, QColor(64, 158, 255, value > 0 ? 200 : 60));
+
+        const QString label = i < buckets.size()
+            ? QString("≤%1s").arg(buckets.at(i) / 1000.0)
+            : QString(">%1s").arg(buckets.last() / 1000.0);
+        painter.setPen(QColor(120, 120, 120));
+        painter.drawText(QRectF(x, area.bottom() - labelHeight, barWidth, labelHeight),
+                         Qt::AlignCenter, value > 0 ? QString("%1 %2").arg(label).arg(value) : label);
+    }
+}
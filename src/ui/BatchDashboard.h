@@ -0,0 +1,40 @@
+#pragma once
+#include <QFrame>
+#include <QLabel>
+#include <QTimer>
+#include "../core/BatchStats.h"
+
+// 批量任务面板：吞吐量、并发、队列、缓存命中、失败/重试、耗时分布与剩余时间
+class BatchDashboard : public QFrame {
+    Q_OBJECT
+
+public:
+    explicit BatchDashboard(QWidget* parent = nullptr);
+    ~BatchDashboard() override = default;
+
+    // 跟踪批次统计，每秒刷新一次 (剩余时间需要随时间更新)
+    void track(const BatchStats* stats);
+    // 批次结束：最后刷新一次并停止定时器，面板保留最终数据
+    void stopTracking();
+
+public slots:
+    void refresh();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    static QString formatDuration(int seconds);
+
+    const BatchStats* m_stats = nullptr;
+    BatchStats::Snapshot m_snapshot;
+    QTimer m_refreshTimer;
+
+    QLabel* m_progressLabel;
+    QLabel* m_throughputLabel;
+    QLabel* m_queueLabel;
+    QLabel* m_cacheLabel;
+    QLabel* m_failureLabel;
+    QLabel* m_etaLabel;
+    QWidget* m_histogramArea;
+};
@@ -0,0 +1,83 @@
+#include "BatchErrorPanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+BatchErrorPanel::BatchErrorPanel(QWidget* parent)
+    : QFrame(parent)
+{
+    setObjectName("batchErrorPanel");
+    setStyleSheet(
+        "QFrame#batchErrorPanel { background: rgba(255, 245, 245, 0.95); border: 1px solid #f5c2c7; border-radius: 8px; }"
+        "QLabel { color: #842029; font-size: 9pt; background: transparent; border: none; }"
+        "QListWidget { font-size: 9pt; border: none; background: transparent; }"
+    );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(10, 6, 10, 6);
+    layout->setSpacing(4);
+
+    QHBoxLayout* header = new QHBoxLayout();
+    m_summaryLabel = new QLabel();
+    m_summaryLabel->setWordWrap(true);
+    header->addWidget(m_summaryLabel, 1);
+
+    m_retryBtn = new QPushButton("重试失败项");
+    m_retryBtn->setCursor(Qt::PointingHandCursor);
+    header->addWidget(m_retryBtn);
+
+    m_dismissBtn = new QPushButton("忽略");
+    m_dismissBtn->setCursor(Qt::PointingHandCursor);
+    m_dismissBtn->setToolTip("清空失败列表，不再重试");
+    header->addWidget(m_dismissBtn);
+    layout->addLayout(header);
+
+    m_list = new QListWidget();
+    m_list->setMaximumHeight(96);
+    m_list->setToolTip("双击查看对应图片");
+    layout->addWidget(m_list);
+
+    connect(m_retryBtn, &QPushButton::clicked, this, &BatchErrorPanel::retryRequested);
+    connect(m_dismissBtn, &QPushButton::clicked, this, &BatchErrorPanel::dismissRequested);
+    connect(m_list, &QListWidget::itemDoubleClicked, this, [this](QListWidgetItem* item) {
+        emit itemActivated(item->data(Qt::UserRole).toInt());
+    });
+
+    hide();
+}
+
+void BatchErrorPanel::addError(int index, const QString& fileName, const QString& error) {
+    QListWidgetItem* item = new QListWidgetItem(QString("%1: %2").arg(fileName, error));
+    item->setData(Qt::UserRole, index);
+    item->setToolTip(error);
+    m_list->addItem(item);
+    m_errorCounts[error]++;
+
+    updateSummary();
+    show();
+}
+
+void BatchErrorPanel::clearErrors() {
+    m_list->clear();
+    m_errorCounts.clear();
+    hide();
+}
+
+void BatchErrorPanel::updateSummary() {
+    // 大量失败通常是同一原因 (限流、鉴权)，摘要里给出最常见的一条
+    QString topError;
+    int topCount = 0;
+    for (auto it = m_errorCounts.constBegin(); it != m_errorCounts.constEnd(); ++it) {
+        if (it.value() > topCount) {
+            topError = it.key();
+            topCount = it.value();
+        }
+    }
+
+    QString summary = QString("失败 %1 张").arg(m_list->count());
+    if (m_errorCounts.size() > 1) {
+        summary += QString("，最常见原因 (%1 次): %2").arg(topCount).arg(topError);
+    } else if (!topError.isEmpty()) {
+        summary += QString("，原因: %1").arg(topError);
+    }
+    m_summaryLabel->setText(summary);
+}
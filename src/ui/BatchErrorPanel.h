@@ -0,0 +1,34 @@
+#pragma once
+#include <QFrame>
+#include <QLabel>
+#include <QListWidget>
+#include <QPushButton>
+#include <QMap>
+
+// 批量失败面板
+// 批量任务中的失败项汇总到这里（非模态），不打断调度；可一键重试全部失败项
+class BatchErrorPanel : public QFrame {
+    Q_OBJECT
+
+public:
+    explicit BatchErrorPanel(QWidget* parent = nullptr);
+    ~BatchErrorPanel() override = default;
+
+    void addError(int index, const QString& fileName, const QString& error);
+    void clearErrors();
+    int errorCount() const { return m_list->count(); }
+
+signals:
+    void retryRequested();
+    void dismissRequested();
+    void itemActivated(int index);   // 双击失败项，跳转查看
+
+private:
+    void updateSummary();
+
+    QLabel* m_summaryLabel;
+    QListWidget* m_list;
+    QPushButton* m_retryBtn;
+    QPushButton* m_dismissBtn;
+    QMap<QString, int> m_errorCounts;   // 错误信息 → 次数，用于汇总最常见的原因
+};
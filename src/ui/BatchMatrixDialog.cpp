@@ -0,0 +1,118 @@
+#include "BatchMatrixDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDialogButtonBox>
+
+namespace {
+// 组合数过多时请求量成倍增加，给出上限避免误操作
+const int kMaxVariants = 12;
+
+const int kValueRole = Qt::UserRole;      // 提示词内容 / 模型 ID
+const int kNameRole = Qt::UserRole + 1;
+}
+
+BatchMatrixDialog::BatchMatrixDialog(const QString& currentPrompt,
+                                     const QVector<PromptTemplate>& templates,
+                                     const QList<ModelAdapter*>& models,
+                                     const QString& currentModelId,
+                                     QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("多提示词 / 多模型批量");
+    setMinimumSize(560, 420);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QLabel* hint = new QLabel("每张图片只解码、编码一次，按勾选的 提示词 × 模型 组合分别识别，结果并列展示。");
+    hint->setWordWrap(true);
+    mainLayout->addWidget(hint);
+
+    QHBoxLayout* listsLayout = new QHBoxLayout();
+
+    QVBoxLayout* promptLayout = new QVBoxLayout();
+    promptLayout->addWidget(new QLabel("提示词:"));
+    m_promptList = new QListWidget();
+    if (!currentPrompt.isEmpty()) {
+        QListWidgetItem* item = new QListWidgetItem("当前输入的提示词");
+        item->setData(kValueRole, currentPrompt);
+        item->setData(kNameRole, "当前提示词");
+        item->setToolTip(currentPrompt);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Checked);
+        m_promptList->addItem(item);
+    }
+    for (const PromptTemplate& tmpl : templates) {
+        if (tmpl.content.isEmpty()) continue;
+        QListWidgetItem* item = new QListWidgetItem(QString("%1 [%2]").arg(tmpl.name, tmpl.type));
+        item->setData(kValueRole, tmpl.content);
+        item->setData(kNameRole, tmpl.name);
+        item->setToolTip(tmpl.content);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+        m_promptList->addItem(item);
+    }
+    promptLayout->addWidget(m_promptList);
+    listsLayout->addLayout(promptLayout, 3);
+
+    QVBoxLayout* modelLayout = new QVBoxLayout();
+    modelLayout->addWidget(new QLabel("模型:"));
+    m_modelList = new QListWidget();
+    for (ModelAdapter* adapter : models) {
+        if (!adapter || !adapter->config().enabled) continue;
+        const ModelConfig& config = adapter->config();
+        QListWidgetItem* item = new QListWidgetItem(config.displayName + " " + adapter->typeDescription());
+        item->setData(kValueRole, config.id);
+        item->setData(kNameRole, config.displayName);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(config.id == currentModelId ? Qt::Checked : Qt::Unchecked);
+        m_modelList->addItem(item);
+    }
+    modelLayout->addWidget(m_modelList);
+    listsLayout->addLayout(modelLayout, 2);
+    mainLayout->addLayout(listsLayout, 1);
+
+    m_summaryLabel = new QLabel();
+    mainLayout->addWidget(m_summaryLabel);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    m_okBtn = buttons->button(QDialogButtonBox::Ok);
+    m_okBtn->setText("选择图片...");
+    buttons->button(QDialogButtonBox::Cancel)->setText("取消");
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttons);
+
+    connect(m_promptList, &QListWidget::itemChanged, this, &BatchMatrixDialog::updateSummary);
+    connect(m_modelList, &QListWidget::itemChanged, this, &BatchMatrixDialog::updateSummary);
+    updateSummary();
+}
+
+BatchVariantList BatchMatrixDialog::variants() const {
+    BatchVariantList result;
+    for (int p = 0; p < m_promptList->count(); ++p) {
+        const QListWidgetItem* promptItem = m_promptList->item(p);
+        if (promptItem->checkState() != Qt::Checked) continue;
+        for (int m = 0; m < m_modelList->count(); ++m) {
+            const QListWidgetItem* modelItem = m_modelList->item(m);
+            if (modelItem->checkState() != Qt::Checked) continue;
+            BatchVariant variant;
+            variant.prompt = promptItem->data(kValueRole).toString();
+            variant.modelId = modelItem->data(kValueRole).toString();
+            variant.name = QString("%1 · %2").arg(promptItem->data(kNameRole).toString(),
+                                                  modelItem->data(kNameRole).toString());
+            result.append(variant);
+        }
+    }
+    return result;
+}
+
+void BatchMatrixDialog::updateSummary() {
+    const int count = variants().size();
+    if (count == 0) {
+        m_summaryLabel->setText("请至少勾选一个提示词和一个模型");
+    } else if (count > kMaxVariants) {
+        m_summaryLabel->setText(QString("共 %1 个组合，超过上限 %2，请减少勾选").arg(count).arg(kMaxVariants));
+    } else {
+        m_summaryLabel->setText(QString("共 %1 个组合，每张图片将识别 %1 次").arg(count));
+    }
+    m_okBtn->setEnabled(count > 0 && count <= kMaxVariants);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <QDialog>
+#include <QListWidget>
+#include <QLabel>
+#include <QPushButton>
+#include "../core/BatchVariant.h"
+#include "../core/ModelAdapter.h"
+#include "../utils/ConfigManager.h"
+
+// 批量矩阵设置
+// 勾选多个提示词模板与模型，同一批图片按 提示词 × 模型 的每个组合各识别一次
+class BatchMatrixDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    BatchMatrixDialog(const QString& currentPrompt,
+                      const QVector<PromptTemplate>& templates,
+                      const QList<ModelAdapter*>& models,
+                      const QString& currentModelId,
+                      QWidget* parent = nullptr);
+
+    // 勾选的组合 (提示词在外层、模型在内层)
+    BatchVariantList variants() const;
+
+private:
+    void updateSummary();
+
+    QListWidget* m_promptList;
+    QListWidget* m_modelList;
+    QLabel* m_summaryLabel;
+    QPushButton* m_okBtn;
+};
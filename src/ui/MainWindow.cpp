@@ -9,8 +9,12 @@
 #include "../adapters/DoubaoAdapter.h"
 #include "../adapters/GeneralAdapter.h"
 #include "../adapters/GeminiAdapter.h"
+#include "../adapters/CascadeAdapter.h"
+#include "../adapters/PaddleOnnxAdapter.h"
 #include "../utils/ConfigManager.h"
 #include "../utils/ThemeManager.h"
+#include "../utils/ThumbnailCache.h"
+#include <QPointer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
@@ -53,6 +57,8 @@
 #include <functional>
 #include <QStandardItemModel>
 #include <QStandardItem>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -93,6 +99,9 @@ MainWindow::MainWindow(QWidget *parent)
     setupSystemTray();
 
     showStatusMessage("就绪");
+
+    // 窗口显示后再检查是否有中断的批量任务
+    QTimer::singleShot(0, this, &MainWindow::checkPendingBatch);
 }
 
 MainWindow::~MainWindow()
@@ -360,6 +369,14 @@ void MainWindow::setupUI()
     m_batchInfoLabel->hide();
     
     uploadCardLayout->addWidget(m_imageContainer, 1);
+
+    // 批量面板（批量任务开始后显示）
+    m_batchDashboard = new BatchDashboard();
+    uploadCardLayout->addWidget(m_batchDashboard);
+
+    // 批量失败面板（有失败项时显示）
+    m_batchErrorPanel = new BatchErrorPanel();
+    uploadCardLayout->addWidget(m_batchErrorPanel);
     
     QWidget *uploadCard = createCard("", uploadCardContent);
     homeLayout->addWidget(uploadCard, 1);
@@ -540,6 +557,7 @@ void MainWindow::setupUI()
         "  background: #f5f5f5;"
         "}"
     );
+    m_historyList->setIconSize(QSize(64, 64));
     historyPageLayout->addWidget(m_historyList);
     
     // 分页控件
@@ -573,7 +591,28 @@ void MainWindow::setupUI()
         "  background: #d32f2f;"
         "}"
     );
-    historyPageLayout->addWidget(m_clearHistoryBtn);
+    // 导出当前筛选条件下的全部历史结果
+    m_exportHistoryBtn = new QPushButton("导出筛选结果");
+    m_exportHistoryBtn->setMinimumHeight(40);
+    m_exportHistoryBtn->setStyleSheet(
+        "QPushButton { "
+        "  padding: 10px 20px; "
+        "  font-size: 10pt; "
+        "  font-weight: normal; "
+        "  color: white; "
+        "  background: #409eff; "
+        "  border: none; "
+        "  border-radius: 8px;"
+        "}"
+        "QPushButton:hover { "
+        "  background: #337ecc;"
+        "}"
+    );
+
+    QHBoxLayout *historyActionLayout = new QHBoxLayout();
+    historyActionLayout->addWidget(m_exportHistoryBtn);
+    historyActionLayout->addWidget(m_clearHistoryBtn);
+    historyPageLayout->addLayout(historyActionLayout);
     
     // 将历史页面设置到滚动区域并添加到 StackedWidget
     historyScrollArea->setWidget(m_historyPage);
@@ -663,23 +702,39 @@ void MainWindow::setupConnections()
     
     // UI 按钮连接
     connect(m_uploadBtn, &QPushButton::clicked, this, &MainWindow::onUploadImageClicked);
+    // 右键：多提示词 / 多模型批量
+    m_uploadBtn->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_uploadBtn->setToolTip("右键可按多个提示词 / 模型组合批量识别");
+    connect(m_uploadBtn, &QPushButton::customContextMenuRequested, this, [this](const QPoint& pos) {
+        QMenu menu(this);
+        QAction* matrixAction = menu.addAction("多提示词 / 多模型批量...");
+        if (menu.exec(m_uploadBtn->mapToGlobal(pos)) == matrixAction) {
+            onMatrixBatchRequested();
+        }
+    });
     connect(m_pasteBtn, &QPushButton::clicked, this, &MainWindow::onPasteImageClicked);
     connect(m_recognizeBtn, &QPushButton::clicked, this, &MainWindow::onRecognizeClicked);
     connect(m_closeImageBtn, &QPushButton::clicked, this, &MainWindow::onCloseImageClicked);
+    // 批量矩阵中同一图片的各组合一起展示，翻页按图片跳转
     connect(m_prevImageBtn, &QPushButton::clicked, this, [this]() {
         if (m_batchItems.isEmpty()) return;
+        const int step = batchVariantCount();
         int total = m_batchItems.size();
-        int current = (m_batchViewIndex >= 0) ? m_batchViewIndex : 0;
-        int idx = current <= 0 ? total - 1 : current - 1;
+        int current = (m_batchViewIndex >= 0) ? m_batchViewIndex - m_batchViewIndex % step : 0;
+        int idx = current <= 0 ? total - step : current - step;
         showBatchItem(idx);
     });
     connect(m_nextImageBtn, &QPushButton::clicked, this, [this]() {
         if (m_batchItems.isEmpty()) return;
+        const int step = batchVariantCount();
         int total = m_batchItems.size();
-        int current = (m_batchViewIndex >= 0) ? m_batchViewIndex : 0;
-        int idx = (current + 1) % total;
+        int current = (m_batchViewIndex >= 0) ? m_batchViewIndex - m_batchViewIndex % step : 0;
+        int idx = (current + step) % total;
         showBatchItem(idx);
     });
+    connect(m_batchErrorPanel, &BatchErrorPanel::retryRequested, this, &MainWindow::retryFailedBatchItems);
+    connect(m_batchErrorPanel, &BatchErrorPanel::dismissRequested, this, &MainWindow::dismissBatchErrors);
+    connect(m_batchErrorPanel, &BatchErrorPanel::itemActivated, this, &MainWindow::showBatchItem);
     connect(m_modelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onModelChanged);
     // 提示词模板选择将在加载时连接
@@ -698,8 +753,11 @@ void MainWindow::setupConnections()
     });
     
     connect(m_clearHistoryBtn, &QPushButton::clicked, this, &MainWindow::onClearHistoryClicked);
+    connect(m_exportHistoryBtn, &QPushButton::clicked, this, &MainWindow::onExportHistoryClicked);
 
     connect(m_historyList, &QListWidget::itemClicked, this, &MainWindow::onHistoryItemClicked);
+    connect(m_historyManager, &HistoryManager::thumbnailReady, this, &MainWindow::onHistoryThumbnailReady);
+    connect(m_historyManager, &HistoryManager::fullImageReady, this, &MainWindow::onHistoryImageReady);
     
     // 筛选与分页事件
     connect(m_searchBtn, &QPushButton::clicked, this, [this]() { loadHistoryPage(1); });
@@ -773,6 +831,27 @@ void MainWindow::initializeServices()
     // connect(m_historyManager, &HistoryManager::historyChanged, [this]() { ... });
     
     m_historyManager = new HistoryManager(this);
+    m_resultStore = new ResultStore(QString(), this);
+    m_hotFolderManager = new HotFolderManager(m_pipeline, m_historyManager, this);
+    connect(m_hotFolderManager, &HotFolderManager::fileProcessed, this, [this](const QString& path, bool success, const QString& message) {
+        const QString name = QFileInfo(path).fileName();
+        showStatusMessage(success ? QString("监视文件夹: %1 识别完成 (%2)").arg(name, message)
+                                  : QString("监视文件夹: %1 识别失败: %2").arg(name, message));
+    });
+
+    // 流水线在工作线程中探测结果缓存（HistoryManager / ResultStore 的查询接口线程安全）
+    // 先查历史（内存 LRU + SQLite），未命中再查不受历史保留策略影响的持久化缓存
+    HistoryManager* historyManager = m_historyManager;
+    ResultStore* resultStore = m_resultStore;
+    m_pipeline->setCacheLookup([historyManager, resultStore](const QString& hash, OCRResult& result) {
+        return historyManager->lookupResult(hash, result) || resultStore->lookup(hash, result);
+    });
+    m_pipeline->setCacheStore([resultStore](const QString& hash, const OCRResult& result) {
+        resultStore->insert(hash, result);
+    });
+    m_pipeline->setNearDuplicateLookup([historyManager](const QString& requestKey, quint64 phash, int maxDistance, OCRResult& result) {
+        return historyManager->lookupNearDuplicate(requestKey, phash, maxDistance, result);
+    });
     
     qDebug() << "=== Initializing XS-VLM-OCR Services ===";
 
@@ -822,6 +901,17 @@ void MainWindow::initializeServices()
     bool persistence = m_configManager->getSetting("history_persistence", false).toBool();
     m_historyManager->setPersistenceEnabled(persistence);
 
+    int cacheMb = m_configManager->getSetting("result_cache_mb", 32).toInt();
+    m_historyManager->setResultCacheBudget(static_cast<qint64>(cacheMb) * 1024 * 1024);
+
+    // 持久化结果缓存：后台打开并按容量/有效期压缩
+    int storeMb = m_configManager->getSetting("result_store_max_mb", 256).toInt();
+    int storeTtlDays = m_configManager->getSetting("result_store_ttl_days", 30).toInt();
+    m_resultStore->setPolicy(static_cast<qint64>(storeMb) * 1024 * 1024, storeTtlDays);
+    m_resultStore->openAsync();
+
+    BatchSource::setRenderDpi(m_configManager->getSetting("pdf_render_dpi", 150).toInt());
+
     // 每次启动都从数据库加载（若启用了持久化则会加载已保存记录）
     m_historyManager->loadHistory();
 
@@ -875,6 +965,14 @@ void MainWindow::initializeServices()
             {
                 adapter = new DoubaoAdapter(config, this);
             }
+            else if (config.engine == "paddle_onnx")
+            {
+                adapter = new PaddleOnnxAdapter(config, this);
+            }
+            else if (config.engine == "cascade")
+            {
+                adapter = createCascadeAdapter(config);
+            }
             else
             {
                 qWarning() << "MainWindow: 未知引擎类型:" << config.engine;
@@ -1019,9 +1117,48 @@ void MainWindow::initializeServices()
         QString typeText = activeModel->config().type == "local" ? "离线" : "线上";
         m_statusLabel->setText(QString("就绪 - %1 (%2)").arg(activeModel->config().displayName, typeText));
     }
+
+    // 模型就绪后再开始监视文件夹，避免启动扫描出的文件因无可用模型而失败
+    applyHotFolderSettings();
     qDebug() << "=== Services initialized ===";
 }
 
+ModelAdapter *MainWindow::createCascadeAdapter(const ModelConfig &config)
+{
+    // 被引用的模型在 initialize() 时才解析，与配置中的先后顺序无关
+    QPointer<ModelManager> manager = m_modelManager;
+    CascadeAdapter::AdapterResolver resolver = [manager](const QString &modelId) -> ModelAdapter * {
+        return manager ? manager->getModel(modelId) : nullptr;
+    };
+    return new CascadeAdapter(config, resolver, this);
+}
+
+void MainWindow::applyHotFolderSettings()
+{
+    if (!m_hotFolderManager || !m_configManager) return;
+
+    if (!m_configManager->getSetting("hot_folder_enabled", false).toBool()) {
+        m_hotFolderManager->stop();
+        return;
+    }
+
+    HotFolderManager::Settings settings;
+    settings.folders = m_configManager->getSetting("hot_folders", "").toString().split(';', Qt::SkipEmptyParts);
+    settings.concurrency = m_configManager->getSetting("hot_folder_concurrency", 2).toInt();
+    settings.prompt = m_configManager->getSetting("hot_folder_prompt", "").toString();
+
+    const QString output = m_configManager->getSetting("hot_folder_output", "sidecar").toString();
+    if (output == "history") {
+        settings.output = HotFolderManager::OutputMode::History;
+    } else if (output == "both") {
+        settings.output = HotFolderManager::OutputMode::Both;
+    } else {
+        settings.output = HotFolderManager::OutputMode::Sidecar;
+    }
+
+    m_hotFolderManager->start(settings);
+}
+
 #ifdef _WIN32
 // 辅助函数：将Qt键序列转换为Windows热键参数
 bool parseKeySequence(const QString& keySeq, UINT& mod, UINT& vk)
@@ -1279,6 +1416,7 @@ void MainWindow::loadImage(const QImage &image, SubmitSource source)
     }
 
     m_currentImage = image;
+    m_viewingHistoryId = -1;
 
     // 清除之前的识别结果
     if (m_resultText)
@@ -1287,32 +1425,7 @@ void MainWindow::loadImage(const QImage &image, SubmitSource source)
     }
 
     // 显示图像（缩放以适应显示）
-    QPixmap pixmap = QPixmap::fromImage(image);
-    int maxWidth = 600;
-    if (pixmap.width() > maxWidth)
-    {
-        pixmap = pixmap.scaledToWidth(maxWidth, Qt::SmoothTransformation);
-    }
-    m_imageLabel->setPixmap(pixmap);
-    m_imageLabel->setText(""); // 清除提示文字
-    
-    // 显示关闭按钮并定位到右上角
-    if (m_closeImageBtn)
-    {
-        QWidget* container = m_closeImageBtn->parentWidget();
-        if (container)
-        {
-            m_closeImageBtn->show();
-            // 延迟定位，确保容器大小已确定
-            QTimer::singleShot(10, [this, container]() {
-                if (m_closeImageBtn && container)
-                {
-                    m_closeImageBtn->move(container->width() - m_closeImageBtn->width() - 10, 10);
-                    m_closeImageBtn->raise();
-                }
-            });
-        }
-    }
+    showPreviewImage(image);
 
     // 识别按钮始终保持启用（即使没有图片也可以询问AI）
     // m_recognizeBtn->setEnabled(true); // 已移除，按钮始终启用
@@ -1332,6 +1445,9 @@ void MainWindow::loadImage(const QImage &image, SubmitSource source)
     case SubmitSource::DragDrop:
         sourceText = "拖拽";
         break;
+    case SubmitSource::HotFolder:
+        sourceText = "监视文件夹";
+        break;
     }
 
     showStatusMessage(QString("图像已加载 (%1) - %2x%3")
@@ -1342,50 +1458,177 @@ void MainWindow::loadImage(const QImage &image, SubmitSource source)
     updateBatchNav();
 }
 
-void MainWindow::startBatchProcessing(const QStringList& files, SubmitSource source)
+void MainWindow::showPreviewImage(const QImage& image)
+{
+    QPixmap pixmap = QPixmap::fromImage(image);
+    if (pixmap.width() > ThumbnailCache::kPreviewWidth)
+    {
+        pixmap = pixmap.scaledToWidth(ThumbnailCache::kPreviewWidth, Qt::SmoothTransformation);
+    }
+    m_imageLabel->setPixmap(pixmap);
+    m_imageLabel->setText(""); // 清除提示文字
+
+    // 显示关闭按钮并定位到右上角
+    if (m_closeImageBtn && m_imageContainer)
+    {
+        m_closeImageBtn->show();
+        // 延迟定位，确保容器大小已确定
+        QTimer::singleShot(10, this, &MainWindow::updateCloseButtonPosition);
+    }
+}
+
+void MainWindow::onMatrixBatchRequested()
+{
+    if (m_recognizing || m_batchScanning) {
+        QMessageBox::information(this, "提示", "当前正在识别，请稍后再开始批量处理");
+        return;
+    }
+
+    const QString currentModelId = m_pipeline->currentAdapter() ? m_pipeline->currentAdapter()->config().id : QString();
+    BatchMatrixDialog dialog(m_promptEdit ? m_promptEdit->toPlainText().trimmed() : QString(),
+                             m_promptTemplatesCache, m_modelManager->getInitializedModels(),
+                             currentModelId, this);
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+    const BatchVariantList variants = dialog.variants();
+    if (variants.isEmpty())
+        return;
+
+    QString filters = BatchSource::pdfSupported()
+        ? "图片或文档 (*.png *.jpg *.jpeg *.bmp *.gif *.webp *.tif *.tiff *.pdf)"
+        : "图片文件 (*.png *.jpg *.jpeg *.bmp *.gif *.webp *.tif *.tiff)";
+    QStringList fileNames = QFileDialog::getOpenFileNames(this, "选择图片", QString(), filters);
+    if (fileNames.isEmpty())
+        return;
+
+    startBatchProcessing(fileNames, SubmitSource::Upload, variants);
+}
+
+void MainWindow::startBatchProcessing(const QStringList& files, SubmitSource source, const BatchVariantList& variants)
 {
-    if (m_recognizing) {
+    if (m_recognizing || m_batchScanning) {
         QMessageBox::information(this, "提示", "当前正在识别，请稍后再开始批量处理");
         return;
     }
 
+    // 只在后台读取文件头校验，不在界面线程解码任何图片
+    m_batchScanning = true;
+    m_recognizeBtn->setEnabled(false);
+    showStatusMessage(QString("正在检查 %1 个文件...").arg(files.size()));
+
+    QFutureWatcher<BatchSource::ScanResult>* watcher = new QFutureWatcher<BatchSource::ScanResult>(this);
+    connect(watcher, &QFutureWatcher<BatchSource::ScanResult>::finished, this, [this, watcher, source, variants]() {
+        BatchSource::ScanResult scan = watcher->result();
+        watcher->deleteLater();
+        m_batchScanning = false;
+        m_recognizeBtn->setEnabled(!m_recognizing);
+        beginBatch(scan, source, nullptr, variants);
+    });
+    watcher->setFuture(QtConcurrent::run([files]() {
+        return BatchSource::scan(files);
+    }));
+}
+
+void MainWindow::beginBatch(const BatchSource::ScanResult& scan, SubmitSource source, const BatchJournal::Job* resumeJob,
+                            const BatchVariantList& variants)
+{
+    if (m_batchLoader) m_batchLoader->cancel();
+    m_batchVariants = resumeJob ? resumeJob->variants : variants;
+    // 单个组合等同于普通批量；其模型已不可用时保留为组合，由调度按组合报告失败，不改用当前模型
+    if (m_batchVariants.size() == 1 && m_modelComboBox->findData(m_batchVariants.first().modelId) >= 0) {
+        const BatchVariant only = m_batchVariants.first();
+        m_batchVariants.clear();
+        int modelIndex = m_modelComboBox->findData(only.modelId);
+        if (modelIndex != m_modelComboBox->currentIndex()) {
+            m_modelComboBox->setCurrentIndex(modelIndex);
+        }
+        if (m_promptEdit && !resumeJob) m_promptEdit->setPlainText(only.prompt);
+    }
+    QStringList missingModels;
+    for (const BatchVariant& variant : m_batchVariants) {
+        if (!m_modelManager->getModel(variant.modelId) && !missingModels.contains(variant.modelId)) {
+            missingModels << variant.modelId;
+        }
+    }
+    const int variantCount = batchVariantCount();
+    m_batchLoader = std::make_shared<BatchSource>(scan.entries);
+    // 同一张图片由各组合共用：只解码一次，编码结果由 ImagePayload 复用
+    m_batchLoader->setFanOut(variantCount);
     m_batchFiles.clear();
     m_batchItems.clear();
     m_batchViewIndex = -1;
     m_batchInFlight = 0;
+    m_batchAdapterInFlight.clear();
     m_batchIndex = 0;
-    m_batchPrompt = m_promptEdit ? m_promptEdit->toPlainText().trimmed() : QString();
+    if (resumeJob) {
+        m_batchPrompt = resumeJob->prompt;
+    } else {
+        m_batchPrompt = m_promptEdit ? m_promptEdit->toPlainText().trimmed() : QString();
+    }
     m_batchSource = source;
     m_batchRunning = true;
 
-    int added = 0;
-    int skipped = 0;
-    for (const QString& path : files) {
-        QImage img(path);
-        if (img.isNull()) {
-            skipped++;
-            continue;
+    // 批量项按 图片 × 组合 展开：第 i 张图片的第 v 个组合下标为 i * 组合数 + v，同一图片的组合相邻提交
+    int restored = 0;
+    QStringList entryRefs;
+    for (int entryIndex = 0; entryIndex < scan.entries.size(); ++entryIndex) {
+        const BatchSource::Entry& entry = scan.entries.at(entryIndex);
+        entryRefs << entry.ref();
+        for (int v = 0; v < variantCount; ++v) {
+            BatchItem item;
+            item.path = entry.path;
+            item.variant = v;
+            item.page = entry.page;
+            item.pageCount = entry.pageCount;
+            // 恢复任务：已完成的项直接沿用日志中的结果，失败的项重新处理
+            if (resumeJob) {
+                auto record = resumeJob->items.constFind(m_batchItems.size());
+                if (record != resumeJob->items.constEnd() && record->state == BatchJournal::ItemState::Done) {
+                    item.result = record->result;
+                    item.finished = true;
+                    m_batchLoader->skip(entryIndex);
+                    restored++;
+                }
+            }
+            m_batchFiles << entry.ref();
+            m_batchItems.append(item);
         }
-        m_batchFiles << path;
-        BatchItem item;
-        item.path = path;
-        item.image = img;
-        m_batchItems.append(item);
-        added++;
     }
+    const int added = m_batchItems.size();
+    const int skipped = scan.rejected.size();
 
     if (m_batchFiles.isEmpty()) {
         m_batchRunning = false;
+        m_batchJournal.discard();
         showStatusMessage("没有有效的图片可处理");
         updateBatchNav();
         return;
     }
 
+    m_batchStats.reset(added, restored);
+    m_batchDashboard->track(&m_batchStats);
+    m_batchErrorPanel->clearErrors();
+
+    // 写入任务日志，中断后可从此处恢复
+    if (resumeJob) {
+        m_batchJournal.resume(*resumeJob);
+    } else {
+        QString modelId = m_pipeline->currentAdapter() ? m_pipeline->currentAdapter()->config().id : QString();
+        m_batchJournal.begin(entryRefs, m_batchPrompt, modelId, source, m_batchVariants);
+    }
+
     // 预览第一张
     m_batchViewIndex = 0;
     showBatchItem(0);
 
-    if (skipped > 0) {
+    if (!missingModels.isEmpty()) {
+        qWarning() << "MainWindow: 批量组合的模型不可用，对应项将记为失败:" << missingModels;
+        showStatusMessage(QString("模型 %1 不可用，使用该模型的组合将记为失败").arg(missingModels.join(", ")));
+    } else if (resumeJob) {
+        showStatusMessage(QString("继续批量任务，共 %1 张（已完成 %2 张）").arg(added).arg(restored));
+    } else if (variantCount > 1) {
+        showStatusMessage(QString("开始批量处理，共 %1 张图片 × %2 个组合").arg(scan.entries.size()).arg(variantCount));
+    } else if (skipped > 0) {
         showStatusMessage(QString("开始批量处理，共 %1 张（跳过 %2 张无效图片）").arg(added).arg(skipped));
     } else {
         showStatusMessage(QString("开始批量处理，共 %1 张").arg(added));
@@ -1397,69 +1640,336 @@ void MainWindow::startBatchProcessing(const QStringList& files, SubmitSource sou
     dispatchBatchJobs();
 }
 
+void MainWindow::checkPendingBatch()
+{
+    BatchJournal::Job job = m_batchJournal.loadPending();
+    if (!job.isValid())
+        return;
+
+    const int total = job.itemCount();
+    const int done = job.doneCount();
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "恢复批量任务",
+        QString("检测到上次未完成的批量任务（%1）：\n共 %2 张，已完成 %3 张，失败 %4 张。\n\n是否继续处理剩余图片？")
+            .arg(job.created.toString("yyyy-MM-dd HH:mm"))
+            .arg(total)
+            .arg(done)
+            .arg(job.failedCount()),
+        QMessageBox::Yes | QMessageBox::No);
+
+    if (reply == QMessageBox::Yes) {
+        resumeBatch(job);
+    } else {
+        m_batchJournal.discard();
+    }
+}
+
+void MainWindow::resumeBatch(const BatchJournal::Job& job)
+{
+    if (m_recognizing || m_batchScanning) {
+        return;
+    }
+
+    // 尽量使用任务原来的模型，保证结果与缓存一致
+    int modelIndex = m_modelComboBox->findData(job.modelId);
+    if (modelIndex >= 0 && modelIndex != m_modelComboBox->currentIndex()) {
+        m_modelComboBox->setCurrentIndex(modelIndex);
+    } else if (modelIndex < 0 && !job.modelId.isEmpty()) {
+        showStatusMessage(QString("原模型 %1 不可用，使用当前模型继续").arg(job.modelId));
+    }
+
+    // 直接按日志中的文件列表恢复（保持下标与日志一致），缺失的文件在解码时报错
+    BatchSource::ScanResult scan;
+    QHash<QString, int> pageCounts;
+    for (const QString& ref : job.files) {
+        BatchSource::Entry entry = BatchSource::Entry::fromRef(ref);
+        if (entry.page >= 0) pageCounts[entry.path]++;
+        scan.entries.append(entry);
+    }
+    for (BatchSource::Entry& entry : scan.entries) {
+        if (entry.page >= 0) entry.pageCount = pageCounts.value(entry.path);
+    }
+    beginBatch(scan, job.source, &job);
+}
+
 void MainWindow::dispatchBatchJobs()
 {
     if (!m_batchRunning)
         return;
 
-    while (m_batchInFlight < kMaxBatchConcurrent && m_batchIndex < m_batchFiles.size()) {
-        int idx = m_batchIndex++;
+    // 并发上限由流水线按模型的延迟与限流情况自适应调整；矩阵中各模型分别受自己的上限约束
+    QHash<ModelAdapter*, int> limits;
+    int concurrency = 0;
+    for (int v = 0; v < batchVariantCount(); ++v) {
+        ModelAdapter* adapter = batchVariantAdapter(v);
+        if (adapter && !limits.contains(adapter)) {
+            limits.insert(adapter, m_pipeline->concurrencyLimit(adapter));
+            concurrency += limits.value(adapter);
+        }
+    }
+    if (limits.isEmpty()) {
+        concurrency = m_pipeline->concurrencyLimit();
+    }
+    m_batchStats.setConcurrency(concurrency);
+    while (!m_batchRetryQueue.isEmpty() || m_batchIndex < m_batchFiles.size()) {
+        // 重试的失败项优先提交
+        const bool retry = !m_batchRetryQueue.isEmpty();
+        const int idx = retry ? m_batchRetryQueue.head() : m_batchIndex;
         if (idx >= m_batchItems.size())
             break;
-
-        BatchItem& item = m_batchItems[idx];
-        if (item.image.isNull()) {
+        if (m_batchItems.at(idx).finished) {
+            // 恢复的任务中已完成的项
+            if (retry) m_batchRetryQueue.dequeue(); else m_batchIndex++;
             continue;
         }
 
+        ModelAdapter* adapter = batchVariantAdapter(m_batchItems.at(idx).variant);
+        // 按提交顺序派发 (同一图片的组合共用一次解码)，队首的模型已满时等待其完成
+        if (adapter && m_batchAdapterInFlight.value(adapter) >= limits.value(adapter, concurrency))
+            break;
+        if (!adapter && m_batchInFlight >= concurrency)
+            break;
+        if (retry) m_batchRetryQueue.dequeue(); else m_batchIndex++;
+
         QString filePath = m_batchFiles.at(idx);
-        QString hash;
-        if (m_pipeline->currentAdapter()) {
-            const auto& config = m_pipeline->currentAdapter()->config();
-            hash = HistoryManager::computeContentHash(item.image, m_batchPrompt, config.id, config.params);
-            
-            // 缓存检查
-            HistoryItem cached = m_historyManager->findItemByHash(hash);
-            if (cached.result.success) {
-                qDebug() << "Batch Cache Hit! Index:" << idx << "Hash:" << hash;
-                
-                // 更新批量项
-                m_batchItems[idx].result = cached.result;
-                m_batchItems[idx].finished = true;
-                m_batchItems[idx].error.clear();
-                
-                // 添加到历史记录 (保持时间线更新)
-                HistoryItem newItem = cached;
-                newItem.timestamp = QDateTime::currentDateTime();
-                newItem.source = m_batchSource;
-                addHistoryItem(newItem);
-                
-                // 跳过提交，继续下一个
+        // 解码、哈希与缓存探测都由流水线在工作线程完成，命中时直接回调完成信号
+        OCRRequest request;
+        request.imageLoader = BatchSource::loader(m_batchLoader, idx / batchVariantCount());
+        request.filePath = filePath;
+        request.source = m_batchSource;
+        request.prompt = m_batchPrompt;
+        request.contextId = QString("batch:%1").arg(idx);
+        request.priority = OCRRequest::PriorityBatch;
+        m_batchInFlight++;
+        m_batchStats.recordSubmitted(idx);
+        if (!m_batchVariants.isEmpty()) {
+            // 批量矩阵：按组合指定提示词与模型；模型已不可用时该项记为失败，不改用当前模型
+            const BatchVariant& variant = m_batchVariants.at(m_batchItems.at(idx).variant);
+            if (!adapter) {
+                // 该组合不取用共享的解码结果；失败回调延后执行，避免在调度中重入
+                if (!retry) m_batchLoader->skip(idx / batchVariantCount());
+                const QString error = QString("模型 %1 不可用").arg(variant.modelId);
+                const QString contextId = request.contextId;
+                const std::weak_ptr<BatchSource> loader = m_batchLoader;
+                QTimer::singleShot(0, this, [this, error, contextId, loader]() {
+                    if (m_batchRunning && !loader.expired() && loader.lock() == m_batchLoader) {
+                        onRecognitionFailed(error, QImage(), m_batchSource, contextId);
+                    }
+                });
                 continue;
             }
+            request.prompt = variant.prompt;
+            request.adapter = adapter;
         }
+        m_batchItems[idx].adapter = adapter;
+        m_batchAdapterInFlight[adapter]++;
 
-        QString contextId = QString("batch:%1|hash:%2").arg(idx).arg(hash);
-        m_batchInFlight++;
+        // 进度由批量面板展示，这里不再逐张刷新状态栏
+        m_pipeline->submit(request);
+    }
 
-        showStatusMessage(QString("批量处理中 (%1/%2): %3")
-                              .arg(idx + 1)
-                              .arg(m_batchFiles.size())
-                              .arg(QFileInfo(filePath).fileName()));
-        m_pipeline->submitImage(item.image, m_batchSource, m_batchPrompt, contextId);
+    // 为即将提交的图片提前解码（有界窗口，已提交的由任务自行取走）
+    if (m_batchLoader && m_batchIndex < m_batchFiles.size()) {
+        m_batchLoader->prefetch(m_batchIndex / batchVariantCount());
     }
 
-    if (m_batchIndex >= m_batchFiles.size() && m_batchInFlight == 0) {
+    if (!hasPendingBatchWork()) {
         m_batchRunning = false;
-        showStatusMessage("批量处理完成");
+        // 有失败项时保留日志：可在失败面板中重试，或下次启动时恢复
+        if (m_batchErrorPanel->errorCount() > 0) {
+            m_batchJournal.close();
+        } else {
+            m_batchJournal.finish();
+        }
+        m_batchDashboard->stopTracking();
+
+        // 批量模式下只在结束时汇总通知一次
+        const BatchStats::Snapshot stats = m_batchStats.snapshot();
+        const QString summary = QString("成功 %1 张，失败 %2 张，用时 %3 秒")
+                                    .arg(stats.restored + stats.completed)
+                                    .arg(stats.failed)
+                                    .arg(stats.elapsedMs / 1000);
+        m_trayIcon->showMessage("批量处理完成", summary, QSystemTrayIcon::Information, 3000);
+        showStatusMessage("批量处理完成: " + summary);
         m_recognizing = false;
         m_recognizeBtn->setEnabled(true);
         setRecognizeButtonText("询问AI");
     }
 
+    m_batchDashboard->refresh();
     updateBatchNav();
 }
 
+ModelAdapter* MainWindow::batchVariantAdapter(int variant) const
+{
+    if (m_batchVariants.isEmpty())
+        return m_pipeline->currentAdapter();
+    return m_modelManager->getModel(m_batchVariants.at(variant).modelId);
+}
+
+void MainWindow::releaseBatchSlot(int index)
+{
+    if (index < 0 || index >= m_batchItems.size())
+        return;
+    ModelAdapter* adapter = m_batchItems.at(index).adapter;
+    m_batchItems[index].adapter = nullptr;
+    auto it = m_batchAdapterInFlight.find(adapter);
+    if (adapter && it != m_batchAdapterInFlight.end() && --it.value() <= 0) {
+        m_batchAdapterInFlight.erase(it);
+    }
+}
+
+bool MainWindow::hasPendingBatchWork() const
+{
+    return m_batchInFlight > 0 || !m_batchRetryQueue.isEmpty() || m_batchIndex < m_batchFiles.size();
+}
+
+BatchSource::Entry MainWindow::batchEntry(int index) const
+{
+    BatchSource::Entry entry;
+    if (index < 0 || index >= m_batchItems.size())
+        return entry;
+    const BatchItem& item = m_batchItems.at(index);
+    entry.path = item.path;
+    entry.page = item.page;
+    entry.pageCount = item.pageCount;
+    return entry;
+}
+
+bool MainWindow::documentRange(int index, int& first, int& last) const
+{
+    if (index < 0 || index >= m_batchItems.size() || m_batchItems.at(index).page < 0)
+        return false;
+
+    // 同一文档的各页在 scan 时连续展开
+    const QString& path = m_batchItems.at(index).path;
+    first = index;
+    while (first > 0 && m_batchItems.at(first - 1).path == path && m_batchItems.at(first - 1).page >= 0)
+        first--;
+    last = index;
+    while (last + 1 < m_batchItems.size() && m_batchItems.at(last + 1).path == path && m_batchItems.at(last + 1).page >= 0)
+        last++;
+    return true;
+}
+
+QString MainWindow::batchItemText(int index) const
+{
+    const BatchItem& item = m_batchItems.at(index);
+    if (!item.finished) {
+        return "(未识别)";
+    } else if (item.result.success) {
+        return item.result.fullText;
+    }
+    return QString("(识别失败: %1)").arg(item.error);
+}
+
+QString MainWindow::assembleDocumentText(int first, int last) const
+{
+    // 批量矩阵中各组合的页面交错排列，按组合分节后再按页序拼接
+    QStringList sections;
+    for (int v = 0; v < batchVariantCount(); ++v) {
+        QStringList pages;
+        for (int i = first; i <= last; ++i) {
+            const BatchItem& item = m_batchItems.at(i);
+            if (item.variant != v) continue;
+            pages << QString("--- 第 %1 页 ---\n\n%2").arg(item.page + 1).arg(batchItemText(i));
+        }
+        if (m_batchVariants.isEmpty()) {
+            return pages.join("\n\n");
+        }
+        sections << QString("【%1】\n\n%2").arg(m_batchVariants.at(v).name).arg(pages.join("\n\n"));
+    }
+    return sections.join("\n\n");
+}
+
+QString MainWindow::assembleVariantText(int index) const
+{
+    // 同一图片的各组合结果依次展示
+    const int first = index - index % batchVariantCount();
+    QStringList sections;
+    for (int v = 0; v < m_batchVariants.size() && first + v < m_batchItems.size(); ++v) {
+        sections << QString("【%1】\n\n%2").arg(m_batchVariants.at(v).name).arg(batchItemText(first + v));
+    }
+    return sections.join("\n\n");
+}
+
+void MainWindow::onBatchItemFinished(int index)
+{
+    int first = 0;
+    int last = 0;
+    if (!documentRange(index, first, last) || !documentFinished(first, last))
+        return;
+
+    // 文档全部页面完成：按页序拼接为一份结果
+    const QString fileName = QFileInfo(m_batchItems.at(index).path).fileName();
+    showStatusMessage(QString("%1 共 %2 页识别完成").arg(fileName).arg(last - first + 1));
+
+    // 正在查看该文档的某一页时展示整份结果
+    if (m_batchViewIndex >= first && m_batchViewIndex <= last) {
+        m_resultText->setPlainText(assembleDocumentText(first, last));
+    }
+    // 本批次只有这一份文档时同时复制整份结果
+    if (first == 0 && last == m_batchItems.size() - 1) {
+        m_clipboardManager->copyText(assembleDocumentText(first, last));
+    }
+}
+
+bool MainWindow::documentFinished(int first, int last) const
+{
+    for (int i = first; i <= last; ++i) {
+        if (!m_batchItems.at(i).finished)
+            return false;
+    }
+    return true;
+}
+
+void MainWindow::retryFailedBatchItems()
+{
+    if (m_batchItems.isEmpty())
+        return;
+
+    int count = 0;
+    for (int i = 0; i < m_batchItems.size(); ++i) {
+        BatchItem& item = m_batchItems[i];
+        if (!item.finished || item.result.success)
+            continue;
+        item.finished = false;
+        item.error.clear();
+        item.result = OCRResult();
+        m_batchRetryQueue.enqueue(i);
+        count++;
+    }
+    if (count == 0)
+        return;
+
+    m_batchErrorPanel->clearErrors();
+    m_batchStats.recordRetry(count);
+
+    // 批次已结束：重新打开日志并恢复调度
+    if (!m_batchRunning) {
+        if (!m_batchJournal.isActive()) {
+            m_batchJournal.reopen();
+        }
+        m_batchRunning = true;
+        m_batchDashboard->track(&m_batchStats);
+        m_recognizing = true;
+        m_recognizeBtn->setEnabled(false);
+        setRecognizeButtonText("执行中...");
+    }
+
+    showStatusMessage(QString("重试 %1 张失败图片").arg(count));
+    dispatchBatchJobs();
+}
+
+void MainWindow::dismissBatchErrors()
+{
+    m_batchErrorPanel->clearErrors();
+    // 批次已结束且放弃重试，不再需要恢复
+    if (!m_batchRunning) {
+        m_batchJournal.finish();
+    }
+}
+
 void MainWindow::showBatchItem(int index)
 {
     if (index < 0 || index >= m_batchItems.size())
@@ -1467,12 +1977,47 @@ void MainWindow::showBatchItem(int index)
 
     const BatchItem& item = m_batchItems.at(index);
     m_batchViewIndex = index;
-    if (!item.image.isNull()) {
-        loadImage(item.image, m_batchSource);
+    m_viewingHistoryId = -1;
+    // 批量项不持有原图，需要单独识别时再从文件解码
+    m_currentImage = QImage();
+
+    // 预览图只生成一次并进入缩略图缓存，来回切换时不再重复缩放原图
+    const BatchSource::Entry entry = batchEntry(index);
+    const QString previewKey = "preview:" + entry.ref();
+    QImage preview = ThumbnailCache::instance().get(previewKey);
+    if (!preview.isNull()) {
+        showPreviewImage(preview);
+    } else {
+        m_imageLabel->clear();
+        m_imageLabel->setText("正在加载预览...");
+        QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+        connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, index]() {
+            QImage image = watcher->result();
+            watcher->deleteLater();
+            // 用户可能已切换到其它图片
+            if (m_batchViewIndex == index && !image.isNull()) {
+                showPreviewImage(image);
+            }
+        });
+        if (entry.page >= 0) {
+            // 文档页需要先渲染
+            watcher->setFuture(ThumbnailCache::instance().previewAsync(previewKey, [entry]() {
+                return BatchSource::decode(entry);
+            }));
+        } else {
+            watcher->setFuture(ThumbnailCache::instance().previewAsync(previewKey, QImage(), item.path));
+        }
     }
 
+    int first = 0;
+    int last = 0;
     if (m_resultText) {
-    if (item.finished) {
+    if (documentRange(index, first, last) && documentFinished(first, last)) {
+        // 多页文档全部完成后，查看其中任意一页都展示整份文档的结果
+        m_resultText->setPlainText(assembleDocumentText(first, last));
+    } else if (!m_batchVariants.isEmpty()) {
+        m_resultText->setPlainText(assembleVariantText(index));
+    } else if (item.finished) {
         if (item.result.success) {
             m_resultText->setPlainText(item.result.fullText);
         } else {
@@ -1490,6 +2035,8 @@ void MainWindow::onCloseImageClicked()
 {
     // 清除图片
     m_currentImage = QImage();
+    m_viewingHistoryId = -1;
+    m_batchViewIndex = -1;
     
     // 恢复初始提示文字
     m_imageLabel->clear();
@@ -1526,19 +2073,22 @@ void MainWindow::updateCloseButtonPosition()
 
 void MainWindow::onUploadImageClicked()
 {
+    QString filters = BatchSource::pdfSupported()
+        ? "图片或文档 (*.png *.jpg *.jpeg *.bmp *.gif *.webp *.tif *.tiff *.pdf)"
+        : "图片文件 (*.png *.jpg *.jpeg *.bmp *.gif *.webp *.tif *.tiff)";
     QStringList fileNames = QFileDialog::getOpenFileNames(
         this,
         "选择图片",
         QString(),
-        "图片文件 (*.png *.jpg *.jpeg *.bmp *.gif *.webp)");
+        filters);
 
     if (fileNames.isEmpty())
     {
         return;
     }
 
-    // 单张图片：沿用原有逻辑
-    if (fileNames.size() == 1)
+    // 单张图片：沿用原有逻辑；PDF / 多页 TIFF 按页批量处理
+    if (fileNames.size() == 1 && !BatchSource::isDocument(fileNames.first()))
     {
         QImage image(fileNames.first());
         if (image.isNull())
@@ -1571,16 +2121,34 @@ void MainWindow::onPasteImageClicked()
 
 void MainWindow::onRecognizeClicked()
 {
-    // 手动点击识别时，视为单次任务，清理批量状态
+    // 正在查看的批量项没有常驻原图，先从文件解码
+    if (m_currentImage.isNull() && m_batchViewIndex >= 0 && m_batchViewIndex < m_batchItems.size()) {
+        m_currentImage = BatchSource::decode(batchEntry(m_batchViewIndex));
+    }
+
+    // 手动点击识别时，视为单次任务，清理批量状态；未完成的批量任务保留日志供下次恢复
+    m_batchJournal.close();
+    if (m_batchLoader) {
+        m_batchLoader->cancel();
+        m_batchLoader.reset();
+    }
     m_batchRunning = false;
     m_batchFiles.clear();
     m_batchIndex = 0;
     m_batchItems.clear();
+    m_batchVariants.clear();
     m_batchViewIndex = -1;
     m_batchInFlight = 0;
+    m_batchAdapterInFlight.clear();
     if (m_batchInfoLabel) m_batchInfoLabel->hide();
     if (m_prevImageBtn) m_prevImageBtn->hide();
     if (m_nextImageBtn) m_nextImageBtn->hide();
+    m_batchRetryQueue.clear();
+    if (m_batchDashboard) {
+        m_batchDashboard->stopTracking();
+        m_batchDashboard->hide();
+    }
+    if (m_batchErrorPanel) m_batchErrorPanel->clearErrors();
 
     if (!m_pipeline->currentAdapter())
     {
@@ -1613,6 +2181,19 @@ void MainWindow::onRecognizeClicked()
                         "3. 网络连接问题\n\n"
                         "请点击设置按钮，在「模型配置」标签页填写 API Key 和 API URL";
         } 
+        else if (engine == "paddle_onnx")
+        {
+            detailMsg = "请检查本地 PP-OCR 模型：\n"
+                        "1. 程序需以 -DXS_WITH_ONNXRUNTIME=ON 构建\n"
+                        "2. det.onnx / rec.onnx / ppocr_keys_v1.txt 位于 models/ppocrv4 目录，\n"
+                        "   或在模型参数 model_dir 中指定";
+        }
+        else if (engine == "cascade")
+        {
+            detailMsg = "请检查级联模型的参数：\n"
+                        "1. local_model / vlm_model 需指向已启用的其它模型 ID\n"
+                        "2. 被引用的模型本身需要能初始化成功";
+        }
         else 
         {
             detailMsg = "请检查模型配置。";
@@ -1640,26 +2221,9 @@ void MainWindow::onRecognizeClicked()
     qDebug() << "Model:" << m_pipeline->currentAdapter()->config().displayName;
 
     QString prompt = m_promptEdit->toPlainText().trimmed();
-    QString hash;
-    if (m_pipeline->currentAdapter()) {
-        const auto& config = m_pipeline->currentAdapter()->config();
-        hash = HistoryManager::computeContentHash(imageToSubmit, prompt, config.id, config.params);
-        
-        // 缓存检查
-        HistoryItem cached = m_historyManager->findItemByHash(hash);
-        if (cached.result.success) {
-            qDebug() << "Cache Hit! Hash:" << hash;
-            OCRResult result = cached.result;
-            result.timestamp = QDateTime::currentDateTime();
-            result.processingTimeMs = 0; // 标识为缓存结果
-            
-            onRecognitionCompleted(result, imageToSubmit, SubmitSource::Upload, "hash:" + hash);
-            showStatusMessage("命中缓存，直接返回结果");
-            return;
-        }
-    }
 
-    m_pipeline->submitImage(imageToSubmit, SubmitSource::Upload, prompt, "hash:" + hash);
+    // 内容哈希与缓存探测在流水线工作线程中完成，界面线程不再编码大图
+    m_pipeline->submitImage(imageToSubmit, SubmitSource::Upload, prompt);
     
     // 重新应用当前主题样式，防止折叠/展开状态下按钮图标错位
     applyTheme(m_isGrayTheme);
@@ -1815,6 +2379,19 @@ void MainWindow::onPreviewResultClicked()
 
 void MainWindow::onExportResultClicked()
 {
+    // 批量结果：可一次导出全部图片的结果
+    if (m_batchItems.size() > 1) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, "导出结果",
+            QString("是否导出本批次全部 %1 张图片的结果？\n选择“否”仅导出当前显示的内容。").arg(m_batchItems.size()),
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+        if (reply == QMessageBox::Cancel) return;
+        if (reply == QMessageBox::Yes) {
+            exportBatchResults();
+            return;
+        }
+    }
+
     if (m_resultText->toPlainText().isEmpty())
     {
         QMessageBox::information(this, "提示", "没有可导出的内容");
@@ -1942,7 +2519,9 @@ void MainWindow::onRecognitionStarted(const QImage &image, SubmitSource source,
 {
     Q_UNUSED(image);
     Q_UNUSED(source);
-    Q_UNUSED(contextId);
+
+    // 监视文件夹的任务由 HotFolderManager 处理，不占用界面状态
+    if (HotFolderManager::isHotFolderContext(contextId)) return;
 
     qDebug() << "========================================";
     qDebug() << "UI: 识别任务开始";
@@ -1956,26 +2535,29 @@ void MainWindow::onRecognitionStarted(const QImage &image, SubmitSource source,
 
 void MainWindow::onRecognitionCompleted(const OCRResult &result, const QImage &image, SubmitSource source, const QString& contextId)
 {
+    if (HotFolderManager::isHotFolderContext(contextId)) return;
+
     if (!result.success)
     {
         onRecognitionFailed(result.errorMessage, image, source, contextId);
         return;
     }
 
-    // 添加到历史
+    // 添加到历史；批量项不带原图，避免逐张在界面线程落盘编码并在内存中保留像素
     HistoryItem item;
-    item.image = image;
+    if (!m_batchRunning) item.image = image;
     item.result = result;
     item.source = source;
     item.timestamp = result.timestamp;
+    item.contentHash = result.contentHash;
+    item.requestKey = result.requestKey;
+    item.perceptualHash = result.perceptualHash;
     
-    // 解析 ContextID 获取 Hash 和 BatchIndex
+    // 解析 ContextID 获取 BatchIndex
     int batchIdx = -1;
     QStringList parts = contextId.split('|');
     for (const QString& part : parts) {
-        if (part.startsWith("hash:")) {
-            item.contentHash = part.mid(5);
-        } else if (part.startsWith("batch:")) {
+        if (part.startsWith("batch:")) {
             bool ok = false;
             batchIdx = part.mid(6).toInt(&ok);
             if (!ok) batchIdx = -1;
@@ -1983,21 +2565,30 @@ void MainWindow::onRecognitionCompleted(const OCRResult &result, const QImage &i
     }
 
     addHistoryItem(item);
-    updateResultDisplay(item);
-
-    // 自动复制结果
-    m_clipboardManager->copyText(result.fullText);
-
-    // 显示通知
-    m_trayIcon->showMessage(
-        "识别完成",
-        QString("识别出 %1 个字符，耗时 %2ms")
-            .arg(result.fullText.length())
-            .arg(result.processingTimeMs),
-        QSystemTrayIcon::Information,
-        3000);
-
-    showStatusMessage(QString("识别完成，耗时 %1ms").arg(result.processingTimeMs));
+    // 批量模式下不逐张刷新预览 (整图缩放在界面线程进行，且会替换用户正在查看的图片)，只刷新正在查看的批量项
+    if (!m_batchRunning) {
+        updateResultDisplay(item);
+    }
+
+    // 批量模式下逐张复制结果、弹出托盘通知会拖慢界面并覆盖用户的剪贴板，进度由批量面板展示，结束时汇总通知
+    if (!m_batchRunning) {
+        m_clipboardManager->copyText(result.fullText);
+        m_trayIcon->showMessage(
+            "识别完成",
+            QString("识别出 %1 个字符，耗时 %2ms")
+                .arg(result.fullText.length())
+                .arg(result.processingTimeMs),
+            QSystemTrayIcon::Information,
+            3000);
+
+        if (result.fromCache) {
+            ResultCache::Stats stats = m_historyManager->resultCacheStats();
+            showStatusMessage(QString("命中缓存，直接返回结果 (缓存命中率 %1%)")
+                                  .arg(stats.hitRatio() * 100.0, 0, 'f', 1));
+        } else {
+            showStatusMessage(QString("识别完成，耗时 %1ms").arg(result.processingTimeMs));
+        }
+    }
 
     // 批量任务则继续下一张
     if (m_batchRunning) {
@@ -2005,10 +2596,17 @@ void MainWindow::onRecognitionCompleted(const OCRResult &result, const QImage &i
             m_batchItems[batchIdx].result = result;
             m_batchItems[batchIdx].finished = true;
             m_batchItems[batchIdx].error.clear();
+            m_batchJournal.recordDone(batchIdx, result);
+            m_batchStats.recordCompleted(batchIdx, result.fromCache);
+            if (batchIdx == m_batchViewIndex) {
+                showBatchItem(batchIdx);   // 预览取自 "preview:" 缓存
+            }
+            onBatchItemFinished(batchIdx);
         }
         m_batchInFlight = qMax(0, m_batchInFlight - 1);
+        releaseBatchSlot(batchIdx);
         dispatchBatchJobs();
-        bool busy = m_batchRunning && (m_batchInFlight > 0 || m_batchIndex < m_batchFiles.size());
+        bool busy = m_batchRunning && hasPendingBatchWork();
         m_recognizing = busy;
         m_recognizeBtn->setEnabled(!busy);
         setRecognizeButtonText(busy ? "执行中..." : "询问AI");
@@ -2025,19 +2623,14 @@ void MainWindow::onRecognitionFailed(const QString &error, const QImage &image,
     Q_UNUSED(image);
     Q_UNUSED(source);
 
+    if (HotFolderManager::isHotFolderContext(contextId)) return;
+
     qDebug() << "========================================";
     qDebug() << "UI: 识别失败";
     qDebug() << "  - 错误:" << error;
     qDebug() << "========================================";
 
-    m_recognizing = false;
-    m_recognizeBtn->setEnabled(true);
-    setRecognizeButtonText("询问AI");
-
-    QMessageBox::warning(this, "识别失败", error);
-    showStatusMessage("识别失败: " + error);
-
-    // 批量任务失败后继续下一张
+    // 批量任务：失败项汇总到失败面板，不弹出模态对话框，调度继续保持满并发
     if (m_batchRunning) {
         int batchIdx = -1;
         QStringList parts = contextId.split('|');
@@ -2055,10 +2648,19 @@ void MainWindow::onRecognitionFailed(const QString &error, const QImage &image,
             m_batchItems[batchIdx].error = error;
             m_batchItems[batchIdx].result.success = false;
             m_batchItems[batchIdx].result.errorMessage = error;
+            m_batchJournal.recordFailed(batchIdx, error);
+            m_batchStats.recordFailed(batchIdx);
+            QString itemName = QFileInfo(m_batchItems.at(batchIdx).path).fileName();
+            if (!m_batchVariants.isEmpty()) {
+                itemName += QString(" [%1]").arg(m_batchVariants.at(m_batchItems.at(batchIdx).variant).name);
+            }
+            m_batchErrorPanel->addError(batchIdx, itemName, error);
+            onBatchItemFinished(batchIdx);
         }
         m_batchInFlight = qMax(0, m_batchInFlight - 1);
+        releaseBatchSlot(batchIdx);
         dispatchBatchJobs();
-        bool busy = m_batchRunning && (m_batchInFlight > 0 || m_batchIndex < m_batchFiles.size());
+        bool busy = m_batchRunning && hasPendingBatchWork();
         m_recognizing = busy;
         m_recognizeBtn->setEnabled(!busy);
         setRecognizeButtonText(busy ? "执行中..." : "询问AI");
@@ -2068,6 +2670,9 @@ void MainWindow::onRecognitionFailed(const QString &error, const QImage &image,
     m_recognizing = false;
     m_recognizeBtn->setEnabled(true);
     setRecognizeButtonText("询问AI");
+
+    QMessageBox::warning(this, "识别失败", error);
+    showStatusMessage("识别失败: " + error);
 }
 
 void MainWindow::addHistoryItem(const HistoryItem &item)
@@ -2077,35 +2682,127 @@ void MainWindow::addHistoryItem(const HistoryItem &item)
 
 void MainWindow::updateResultDisplay(const HistoryItem &item)
 {
-    // 显示图像
-    QPixmap pixmap = QPixmap::fromImage(item.image);
-    int maxWidth = 600;
-    if (pixmap.width() > maxWidth)
+    // 显示图像（历史详情先显示缩略图，原图在后台解码完成后替换）
+    if (!item.image.isNull())
     {
-        pixmap = pixmap.scaledToWidth(maxWidth, Qt::SmoothTransformation);
+        showPreviewImage(item.image);
     }
-    m_imageLabel->setPixmap(pixmap);
-    m_imageLabel->setText(""); // 清除提示文字
-    
-    // 显示关闭按钮并定位到右上角
-    if (m_closeImageBtn && m_imageContainer)
+    else
     {
-        m_closeImageBtn->show();
-        // 延迟定位，确保容器大小已确定
-        QTimer::singleShot(10, this, &MainWindow::updateCloseButtonPosition);
+        QImage thumb = m_historyManager->cachedThumbnail(item);
+        if (!thumb.isNull())
+        {
+            showPreviewImage(thumb);
+        }
     }
 
     // 显示结果
     m_resultText->setPlainText(item.result.fullText);
 }
 
-void MainWindow::loadHistoryPage(int page)
+void MainWindow::exportBatchResults()
+{
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        "导出批量结果",
+        QString("ocr_batch_%1.jsonl").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+        ResultExporter::fileFilters());
+    if (fileName.isEmpty())
+        return;
+
+    // 在界面线程拷贝一份记录（字符串隐式共享），写出在后台完成
+    QVector<ResultExporter::Record> records;
+    records.reserve(m_batchItems.size());
+    for (int i = 0; i < m_batchItems.size(); ++i) {
+        const BatchItem& item = m_batchItems.at(i);
+        ResultExporter::Record record;
+        record.path = item.path;
+        record.modelName = item.result.modelName;
+        record.prompt = m_batchVariants.isEmpty() ? m_batchPrompt : m_batchVariants.at(item.variant).prompt;
+        record.processingTimeMs = item.result.processingTimeMs;
+        record.timestamp = item.result.timestamp;
+        record.success = item.finished && item.result.success;
+        record.fullText = item.result.fullText;
+        record.error = item.finished ? item.error : QString("未完成");
+
+        // 多页文档合并为一条记录，页面按页序拼接
+        int first = 0;
+        int last = 0;
+        if (documentRange(i, first, last)) {
+            record.fullText = assembleDocumentText(first, last);
+            record.processingTimeMs = 0;
+            record.success = true;
+            QStringList errors;
+            for (int page = first; page <= last; ++page) {
+                const BatchItem& pageItem = m_batchItems.at(page);
+                record.processingTimeMs += pageItem.result.processingTimeMs;
+                if (!pageItem.finished || !pageItem.result.success) {
+                    record.success = false;
+                    errors << QString("第 %1 页: %2").arg(pageItem.page + 1)
+                                  .arg(pageItem.finished ? pageItem.error : QString("未完成"));
+                }
+            }
+            record.error = errors.join("; ");
+            i = last;
+        }
+        records.append(record);
+    }
+    runExport(fileName, ResultExporter::listSource(records));
+}
+
+void MainWindow::onExportHistoryClicked()
+{
+    HistoryManager::HistoryFilter filter = currentHistoryFilter();
+    int total = m_historyManager->getTotalCount(filter);
+    if (total == 0) {
+        QMessageBox::information(this, "提示", "当前筛选条件下没有可导出的记录");
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        "导出历史记录",
+        QString("ocr_history_%1.jsonl").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+        ResultExporter::fileFilters());
+    if (fileName.isEmpty())
+        return;
+
+    if (m_historyManager->isPersistenceEnabled()) {
+        // 数据库分页读取，工作线程使用独立连接
+        runExport(fileName, ResultExporter::historySource(m_historyManager, filter));
+    } else {
+        // 内存历史数量受上限约束，直接快照
+        QVector<ResultExporter::Record> records;
+        for (const HistoryItem& item : m_historyManager->getHistoryList(1, total, filter)) {
+            records.append(ResultExporter::fromHistoryItem(item));
+        }
+        runExport(fileName, ResultExporter::listSource(records));
+    }
+}
+
+void MainWindow::runExport(const QString& fileName, const ResultExporter::RecordSource& source)
+{
+    const ResultExporter::Format format = ResultExporter::formatForFile(fileName);
+    std::shared_ptr<QString> error = std::make_shared<QString>();
+    showStatusMessage("正在导出: " + QFileInfo(fileName).fileName());
+
+    QFutureWatcher<int>* watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this, [this, watcher, error, fileName]() {
+        int count = watcher->result();
+        watcher->deleteLater();
+        if (count < 0) {
+            QMessageBox::warning(this, "导出失败", QString("无法写入文件: %1\n%2").arg(fileName, *error));
+            return;
+        }
+        showStatusMessage(QString("已导出 %1 条结果到 %2").arg(count).arg(QFileInfo(fileName).fileName()));
+    });
+    watcher->setFuture(QtConcurrent::run([fileName, format, source, error]() {
+        return ResultExporter::exportTo(fileName, format, source, error.get());
+    }));
+}
+
+HistoryManager::HistoryFilter MainWindow::currentHistoryFilter() const
 {
-    if (page < 1) page = 1;
-    m_historyPageNum = page;
-    m_pageLabel->setText(QString("第 %1 页").arg(page));
-    
-    // 构建筛选条件
     HistoryManager::HistoryFilter filter;
     filter.startTime = m_startDateEdit->dateTime();
     // 结束时间设为当天的23:59:59
@@ -2113,6 +2810,17 @@ void MainWindow::loadHistoryPage(int page)
     end.setTime(QTime(23, 59, 59));
     filter.endTime = end;
     filter.keyword = m_searchEdit->text().trimmed();
+    return filter;
+}
+
+void MainWindow::loadHistoryPage(int page)
+{
+    if (page < 1) page = 1;
+    m_historyPageNum = page;
+    m_pageLabel->setText(QString("第 %1 页").arg(page));
+    
+    // 构建筛选条件
+    HistoryManager::HistoryFilter filter = currentHistoryFilter();
     
     // 获取数据
     int total = m_historyManager->getTotalCount(filter);
@@ -2143,18 +2851,48 @@ void MainWindow::loadHistoryPage(int page)
         // 存储ID以便点击时查询详情
         listItem->setData(Qt::UserRole, item.id);
         m_historyList->addItem(listItem);
+
+        // 缩略图：内存命中直接显示，否则后台加载后通过 thumbnailReady 回填
+        QImage thumb = m_historyManager->cachedThumbnail(item);
+        if (!thumb.isNull()) {
+            listItem->setIcon(QIcon(QPixmap::fromImage(thumb)));
+        } else {
+            m_historyManager->requestThumbnail(item);
+        }
+    }
+}
+
+void MainWindow::onHistoryThumbnailReady(long long id, const QImage& thumbnail)
+{
+    for (int i = 0; i < m_historyList->count(); ++i) {
+        QListWidgetItem* listItem = m_historyList->item(i);
+        if (listItem->data(Qt::UserRole).toLongLong() == id) {
+            listItem->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+            break;
+        }
     }
 }
 
+void MainWindow::onHistoryImageReady(long long id, const QImage& image)
+{
+    // 仅当用户仍在查看该记录时替换为原图
+    if (id != m_viewingHistoryId)
+        return;
+    showPreviewImage(image);
+}
+
 void MainWindow::onHistoryItemClicked(QListWidgetItem *item)
 {
     long long id = item->data(Qt::UserRole).toLongLong();
-    HistoryItem detail = m_historyManager->getHistoryDetail(id);
+    // 不在界面线程解码原图：先展示缩略图与文本，原图由 requestFullImage 后台加载
+    HistoryItem detail = m_historyManager->getHistoryDetail(id, false);
     
     if (detail.id != -1) // 有效记录
     {
+        m_viewingHistoryId = detail.id;
         // 确保 m_currentHistoryIndex 逻辑不再依赖旧的 index，而是直接展示
         updateResultDisplay(detail);
+        m_historyManager->requestFullImage(detail);
         // 切换回首页以显示预览与结果区域
         switchToPage("home");
         showStatusMessage("已加载历史记录");
@@ -2249,6 +2987,19 @@ void MainWindow::onSettingsChanged()
             m_historyManager->setMaxHistory(maxHistory);
         }
 
+        // 应用结果缓存预算
+        int cacheMb = m_configManager->getSetting("result_cache_mb", 32).toInt();
+        if (m_historyManager) {
+            m_historyManager->setResultCacheBudget(static_cast<qint64>(cacheMb) * 1024 * 1024);
+        }
+        if (m_resultStore) {
+            int storeMb = m_configManager->getSetting("result_store_max_mb", 256).toInt();
+            int storeTtlDays = m_configManager->getSetting("result_store_ttl_days", 30).toInt();
+            m_resultStore->setPolicy(static_cast<qint64>(storeMb) * 1024 * 1024, storeTtlDays);
+        }
+        applyHotFolderSettings();
+        BatchSource::setRenderDpi(m_configManager->getSetting("pdf_render_dpi", 150).toInt());
+
         // 清空现有模型（安全地删除）
         if (m_modelManager) {
             QList<ModelAdapter*> oldModels = m_modelManager->getAllModels();
@@ -2294,6 +3045,10 @@ void MainWindow::onSettingsChanged()
                     adapter = new PaddleAdapter(config, this);
                 } else if (config.engine == "doubao") {
                     adapter = new DoubaoAdapter(config, this);
+                } else if (config.engine == "paddle_onnx") {
+                    adapter = new PaddleOnnxAdapter(config, this);
+                } else if (config.engine == "cascade") {
+                    adapter = createCascadeAdapter(config);
                 }
                 
                 if (adapter && m_modelManager) {
@@ -2578,7 +3333,7 @@ void MainWindow::dropEvent(QDropEvent *event)
         if (files.isEmpty())
             return;
 
-    if (files.size() == 1) {
+    if (files.size() == 1 && !BatchSource::isDocument(files.first())) {
         QImage image(files.first());
         if (!image.isNull())
         {
@@ -2736,7 +3491,7 @@ void MainWindow::updateBatchNav()
         return;
 
     int total = m_batchItems.size();
-    bool showNav = total > 1;
+    bool showNav = total > batchVariantCount();
 
     if (m_prevImageBtn && m_nextImageBtn) {
         m_prevImageBtn->setVisible(showNav);
@@ -2757,12 +3512,26 @@ void MainWindow::updateBatchNav()
             if (m_batchViewIndex >= 0 && m_batchViewIndex < m_batchItems.size()) {
                 const BatchItem& item = m_batchItems[m_batchViewIndex];
                 QString fileName = QFileInfo(item.path).fileName();
-                if (!item.finished) {
-                    status = QString("第 %1/%2 张 · %3 · 处理中/待处理").arg(m_batchViewIndex + 1).arg(total).arg(fileName);
-                } else if (item.result.success) {
-                    status = QString("第 %1/%2 张 · %3 · 完成").arg(m_batchViewIndex + 1).arg(total).arg(fileName);
+                if (item.page >= 0) {
+                    fileName += QString(" 第 %1/%2 页").arg(item.page + 1).arg(item.pageCount);
+                }
+                // 批量矩阵按图片计数，各组合全部完成才算完成
+                const int step = batchVariantCount();
+                const int first = m_batchViewIndex - m_batchViewIndex % step;
+                bool finished = true;
+                bool success = true;
+                for (int i = first; i < first + step && i < m_batchItems.size(); ++i) {
+                    finished = finished && m_batchItems.at(i).finished;
+                    success = success && m_batchItems.at(i).result.success;
+                }
+                const int position = m_batchViewIndex / step + 1;
+                const int count = total / step;
+                if (!finished) {
+                    status = QString("第 %1/%2 张 · %3 · 处理中/待处理").arg(position).arg(count).arg(fileName);
+                } else if (success) {
+                    status = QString("第 %1/%2 张 · %3 · 完成").arg(position).arg(count).arg(fileName);
                 } else {
-                    status = QString("第 %1/%2 张 · %3 · 失败").arg(m_batchViewIndex + 1).arg(total).arg(fileName);
+                    status = QString("第 %1/%2 张 · %3 · 失败").arg(position).arg(count).arg(fileName);
                 }
             }
             m_batchInfoLabel->setText(status);
@@ -12,6 +12,8 @@
 #include <QMenuBar>
 #include <QMenu>
 #include <QTimer>
+#include <QQueue>
+#include <QHash>
 #include <QShortcut>
 #include <QCloseEvent>
 #include <QDateEdit>
@@ -20,9 +22,18 @@
 #include "SidebarWidget.h"
 #include "../core/OCRPipeline.h"
 #include "../core/HistoryItem.h"
+#include "../core/BatchSource.h"
 #include "../managers/ModelManager.h"
 #include "../managers/ClipboardManager.h"
 #include "../managers/HistoryManager.h"
+#include "../managers/ResultStore.h"
+#include "../managers/BatchJournal.h"
+#include "../managers/HotFolderManager.h"
+#include "../managers/ResultExporter.h"
+#include "../core/BatchStats.h"
+#include "BatchDashboard.h"
+#include "BatchErrorPanel.h"
+#include "BatchMatrixDialog.h"
 #include "../utils/ConfigManager.h"
 
 #ifdef _WIN32
@@ -66,6 +77,7 @@ private slots:
     void onClearHistoryClicked();
     void onModelChanged(int index);
     void onExportResultClicked();
+    void onExportHistoryClicked();
     void onSettingsClicked();
     
     // OCR Pipeline 回调
@@ -75,6 +87,9 @@ private slots:
     
     // 历史列表选择
     void onHistoryItemClicked(QListWidgetItem* item);
+    // 历史缩略图 / 原图异步加载完成
+    void onHistoryThumbnailReady(long long id, const QImage& thumbnail);
+    void onHistoryImageReady(long long id, const QImage& image);
     // 历史分页查询
     void loadHistoryPage(int page);
     // 系统托盘
@@ -104,11 +119,42 @@ private:
     
     // 初始化后台服务
     void initializeServices();
+    void applyHotFolderSettings();
+    // 级联模型按 ID 引用其它模型，从模型管理器中查找
+    ModelAdapter* createCascadeAdapter(const ModelConfig& config);
     // 加载图像
     void loadImage(const QImage& image, SubmitSource source);
+    // 在预览区显示图像（超宽时缩放到预览宽度）
+    void showPreviewImage(const QImage& image);
     // 批量处理
-    void startBatchProcessing(const QStringList& files, SubmitSource source);
+    void startBatchProcessing(const QStringList& files, SubmitSource source,
+                              const BatchVariantList& variants = BatchVariantList());
+    void beginBatch(const BatchSource::ScanResult& scan, SubmitSource source, const BatchJournal::Job* resumeJob = nullptr,
+                    const BatchVariantList& variants = BatchVariantList());
+    // 批量矩阵：多个提示词 / 模型组合共用同一批图片
+    void onMatrixBatchRequested();
+    int batchVariantCount() const { return qMax(1, m_batchVariants.size()); }
+    // 组合使用的模型，普通批量为当前模型；矩阵中的模型已不可用时返回 nullptr
+    ModelAdapter* batchVariantAdapter(int variant) const;
+    QString batchItemText(int index) const;
+    QString assembleVariantText(int index) const;
+    void checkPendingBatch();   // 启动时检查未完成的批量任务
+    void resumeBatch(const BatchJournal::Job& job);
     void dispatchBatchJobs();
+    bool hasPendingBatchWork() const;
+    void releaseBatchSlot(int index);   // 批量项结束，归还其模型的在途名额
+    void retryFailedBatchItems();
+    void dismissBatchErrors();
+    // 多页文档：按页序拼接整份文档的结果
+    BatchSource::Entry batchEntry(int index) const;
+    bool documentRange(int index, int& first, int& last) const;
+    bool documentFinished(int first, int last) const;
+    QString assembleDocumentText(int first, int last) const;
+    void onBatchItemFinished(int index);
+    // 导出全部批量结果 / 后台流式导出
+    void exportBatchResults();
+    void runExport(const QString& fileName, const ResultExporter::RecordSource& source);
+    HistoryManager::HistoryFilter currentHistoryFilter() const;
     void showBatchItem(int index);
     void updateBatchNav();
     // 添加历史记录
@@ -158,6 +204,8 @@ private:
     QPushButton* m_prevImageBtn;
     QPushButton* m_nextImageBtn;
     QLabel* m_batchInfoLabel;
+    BatchDashboard* m_batchDashboard = nullptr; // 批量进度/吞吐面板
+    BatchErrorPanel* m_batchErrorPanel = nullptr; // 批量失败汇总（非模态）
     QImage m_currentImage;
     // 结果显示
     QTextEdit* m_resultText;
@@ -167,6 +215,7 @@ private:
     // 历史页面组件
     QListWidget* m_historyList;
     QPushButton* m_clearHistoryBtn;
+    QPushButton* m_exportHistoryBtn;
     // 历史筛选与分页
     QDateEdit* m_startDateEdit;
     QDateEdit* m_endDateEdit;
@@ -177,6 +226,7 @@ private:
     QLabel* m_pageLabel;
     int m_historyPageNum = 1;
     int m_historyPageSize = 20;
+    long long m_viewingHistoryId = -1; // 当前查看的历史记录（用于异步原图回填）
     
     // 设置按钮
     QPushButton* m_settingsBtn;
@@ -190,6 +240,8 @@ private:
     ClipboardManager* m_clipboardManager;
     ConfigManager* m_configManager;
     HistoryManager* m_historyManager;
+    ResultStore* m_resultStore;      // 持久化结果缓存（独立于历史记录）
+    HotFolderManager* m_hotFolderManager = nullptr; // 监视文件夹自动识别
     // 快捷键
     QShortcut* m_screenshotShortcut;
     QShortcut* m_recognizeShortcut;
@@ -202,12 +254,16 @@ private:
 #endif
     
     // 数据
+    // 批量项只保存路径与结果，图片由 BatchSource 在工作线程中按需解码
     struct BatchItem {
         QString path;
-        QImage image;
+        int variant = 0;     // 批量矩阵中的组合下标
+        int page = -1;       // 多页文档的页码，普通图片为 -1
+        int pageCount = 1;
         OCRResult result;
         bool finished = false;
         QString error;
+        ModelAdapter* adapter = nullptr;  // 提交时使用的模型，用于按模型统计在途数
     };
     QVector<BatchItem> m_batchItems;
     int m_currentHistoryIndex;
@@ -217,13 +273,19 @@ private:
     QSplitter* m_mainSplitter;  // 主分割器
     // 批量处理状态
     QStringList m_batchFiles;
+    std::shared_ptr<BatchSource> m_batchLoader; // 当前批次的图片来源（延迟解码 + 有界预取）
+    bool m_batchScanning = false;               // 正在后台校验文件头
+    BatchJournal m_batchJournal;                // 批量任务日志（中断后可恢复）
     int m_batchIndex = 0;
     QString m_batchPrompt;
+    BatchVariantList m_batchVariants;           // 批量矩阵的组合（为空表示单提示词批量）
     bool m_batchRunning = false;
     SubmitSource m_batchSource = SubmitSource::Upload;
     int m_batchViewIndex = -1;
     int m_batchInFlight = 0;
-    static constexpr int kMaxBatchConcurrent = 4; // 默认并发数，可根据需要调整
+    QHash<ModelAdapter*, int> m_batchAdapterInFlight;  // 各模型的在途数，分别受该模型的并发上限约束
+    BatchStats m_batchStats;                    // 批量吞吐、耗时分布与剩余时间统计
+    QQueue<int> m_batchRetryQueue;              // 待重试的失败项（优先于新项提交）
 
     // 托盘提示是否已展示（避免重复弹出）
     bool m_trayNotified;
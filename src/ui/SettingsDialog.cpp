@@ -12,6 +12,7 @@
 #include <QImage>
 
 #include "../core/OCRResult.h"
+#include "../core/ImageTiler.h"
 #include "../adapters/TesseractAdapter.h"
 #include "../adapters/QwenAdapter.h"
 #include "../adapters/CustomAdapter.h"
@@ -460,6 +461,18 @@ void SettingsDialog::setupGeneralTab()
     m_autoRecognizeAfterScreenshot = new QCheckBox("截图后自动识别");
     m_autoRecognizeAfterScreenshot->setChecked(true);
     featureLayout->addWidget(m_autoRecognizeAfterScreenshot);
+
+    QHBoxLayout* dpiRow = new QHBoxLayout();
+    m_pdfDpiSpin = new QSpinBox();
+    m_pdfDpiSpin->setRange(72, 600);
+    m_pdfDpiSpin->setSingleStep(50);
+    m_pdfDpiSpin->setValue(150);
+    m_pdfDpiSpin->setSuffix(" DPI");
+    m_pdfDpiSpin->setToolTip("PDF 页面渲染为图片的分辨率，越高越清晰但请求越大");
+    dpiRow->addWidget(new QLabel("PDF 渲染分辨率:"));
+    dpiRow->addWidget(m_pdfDpiSpin);
+    dpiRow->addStretch();
+    featureLayout->addLayout(dpiRow);
     
     layout->addWidget(featureGroup);
     
@@ -475,8 +488,70 @@ void SettingsDialog::setupGeneralTab()
     m_maxHistorySpin->setValue(50);
     m_maxHistorySpin->setSuffix(" 条");
     historyLayout->addRow("最大历史记录数:", m_maxHistorySpin);
+
+    m_resultCacheSpin = new QSpinBox();
+    m_resultCacheSpin->setRange(4, 1024);
+    m_resultCacheSpin->setValue(32);
+    m_resultCacheSpin->setSuffix(" MB");
+    m_resultCacheSpin->setToolTip("内存中缓存的识别结果上限（不含图片），超出后淘汰最久未使用的结果");
+    historyLayout->addRow("结果缓存上限:", m_resultCacheSpin);
+
+    m_resultStoreSpin = new QSpinBox();
+    m_resultStoreSpin->setRange(16, 8192);
+    m_resultStoreSpin->setValue(256);
+    m_resultStoreSpin->setSuffix(" MB");
+    m_resultStoreSpin->setToolTip("磁盘结果缓存上限（cache 目录），与历史记录数量和是否持久化无关，超出后淘汰最旧的结果");
+    historyLayout->addRow("磁盘缓存上限:", m_resultStoreSpin);
+
+    m_resultStoreTtlSpin = new QSpinBox();
+    m_resultStoreTtlSpin->setRange(0, 3650);
+    m_resultStoreTtlSpin->setValue(30);
+    m_resultStoreTtlSpin->setSuffix(" 天");
+    m_resultStoreTtlSpin->setSpecialValueText("永久");
+    m_resultStoreTtlSpin->setToolTip("磁盘缓存结果的有效期，过期结果不再命中并在压缩时删除");
+    historyLayout->addRow("磁盘缓存有效期:", m_resultStoreTtlSpin);
     
     layout->addWidget(historyGroup);
+
+    // 监视文件夹：新放入的图片自动识别
+    QGroupBox* hotFolderGroup = new QGroupBox("监视文件夹");
+    QFormLayout* hotFolderLayout = new QFormLayout(hotFolderGroup);
+
+    m_hotFolderCheck = new QCheckBox("自动识别放入监视文件夹的图片");
+    hotFolderLayout->addRow(m_hotFolderCheck);
+
+    QHBoxLayout* folderRow = new QHBoxLayout();
+    m_hotFoldersEdit = new QLineEdit();
+    m_hotFoldersEdit->setPlaceholderText("多个文件夹用 ; 分隔");
+    QPushButton* browseFolderBtn = new QPushButton("添加...");
+    connect(browseFolderBtn, &QPushButton::clicked, this, [this]() {
+        QString dir = QFileDialog::getExistingDirectory(this, "选择监视文件夹");
+        if (dir.isEmpty()) return;
+        QStringList folders = m_hotFoldersEdit->text().split(';', Qt::SkipEmptyParts);
+        if (!folders.contains(dir)) folders << dir;
+        m_hotFoldersEdit->setText(folders.join(';'));
+    });
+    folderRow->addWidget(m_hotFoldersEdit);
+    folderRow->addWidget(browseFolderBtn);
+    hotFolderLayout->addRow("文件夹:", folderRow);
+
+    m_hotFolderConcurrencySpin = new QSpinBox();
+    m_hotFolderConcurrencySpin->setRange(1, 8);
+    m_hotFolderConcurrencySpin->setValue(2);
+    m_hotFolderConcurrencySpin->setToolTip("同时识别的文件数，以批量优先级执行，不影响截图等交互识别");
+    hotFolderLayout->addRow("并发数:", m_hotFolderConcurrencySpin);
+
+    m_hotFolderOutputCombo = new QComboBox();
+    m_hotFolderOutputCombo->addItem("图片旁 .ocr.txt 文件", "sidecar");
+    m_hotFolderOutputCombo->addItem("历史记录", "history");
+    m_hotFolderOutputCombo->addItem("两者都保存", "both");
+    hotFolderLayout->addRow("结果输出:", m_hotFolderOutputCombo);
+
+    m_hotFolderPromptEdit = new QLineEdit();
+    m_hotFolderPromptEdit->setPlaceholderText("留空使用当前模型的默认提示词");
+    hotFolderLayout->addRow("提示词:", m_hotFolderPromptEdit);
+
+    layout->addWidget(hotFolderGroup);
     layout->addStretch();
     
     QIcon generalTabIcon(":/res/11.png");
@@ -573,8 +648,18 @@ void SettingsDialog::loadSettings()
     // 加载通用设置
     m_autoCopyCheck->setChecked(m_configManager->getSetting("auto_copy_result", true).toBool());
     m_autoRecognizeAfterScreenshot->setChecked(m_configManager->getSetting("auto_recognize_after_screenshot", false).toBool());
+    m_pdfDpiSpin->setValue(m_configManager->getSetting("pdf_render_dpi", 150).toInt());
     m_persistenceCheck->setChecked(m_configManager->getSetting("history_persistence", false).toBool());
     m_maxHistorySpin->setValue(m_configManager->getSetting("max_history", 50).toInt());
+    m_resultCacheSpin->setValue(m_configManager->getSetting("result_cache_mb", 32).toInt());
+    m_resultStoreSpin->setValue(m_configManager->getSetting("result_store_max_mb", 256).toInt());
+    m_resultStoreTtlSpin->setValue(m_configManager->getSetting("result_store_ttl_days", 30).toInt());
+    m_hotFolderCheck->setChecked(m_configManager->getSetting("hot_folder_enabled", false).toBool());
+    m_hotFoldersEdit->setText(m_configManager->getSetting("hot_folders", "").toString());
+    m_hotFolderConcurrencySpin->setValue(m_configManager->getSetting("hot_folder_concurrency", 2).toInt());
+    int outputIndex = m_hotFolderOutputCombo->findData(m_configManager->getSetting("hot_folder_output", "sidecar").toString());
+    m_hotFolderOutputCombo->setCurrentIndex(outputIndex >= 0 ? outputIndex : 0);
+    m_hotFolderPromptEdit->setText(m_configManager->getSetting("hot_folder_prompt", "").toString());
     
     // 加载快捷键
     m_screenshotShortcut->setKeySequence(QKeySequence(m_configManager->getSetting("shortcut_screenshot", "Ctrl+R").toString()));
@@ -664,9 +749,19 @@ bool SettingsDialog::saveSettings()
     // 保存通用设置
     m_configManager->setSetting("auto_copy_result", m_autoCopyCheck->isChecked());
     m_configManager->setSetting("auto_recognize_after_screenshot", m_autoRecognizeAfterScreenshot->isChecked());
+    m_configManager->setSetting("pdf_render_dpi", m_pdfDpiSpin->value());
     // 历史记录相关设置
     m_configManager->setSetting("history_persistence", m_persistenceCheck->isChecked());
     m_configManager->setSetting("max_history", m_maxHistorySpin->value());
+    m_configManager->setSetting("result_cache_mb", m_resultCacheSpin->value());
+    m_configManager->setSetting("result_store_max_mb", m_resultStoreSpin->value());
+    m_configManager->setSetting("result_store_ttl_days", m_resultStoreTtlSpin->value());
+    // 监视文件夹
+    m_configManager->setSetting("hot_folder_enabled", m_hotFolderCheck->isChecked());
+    m_configManager->setSetting("hot_folders", m_hotFoldersEdit->text().trimmed());
+    m_configManager->setSetting("hot_folder_concurrency", m_hotFolderConcurrencySpin->value());
+    m_configManager->setSetting("hot_folder_output", m_hotFolderOutputCombo->currentData().toString());
+    m_configManager->setSetting("hot_folder_prompt", m_hotFolderPromptEdit->text().trimmed());
     
     // 保存快捷键
     m_configManager->setSetting("shortcut_screenshot", screenshotKey);
@@ -1638,10 +1733,12 @@ void ModelEditDialog::setupUI()
     m_engineCombo->addItem("qwen (阿里通义千问)", "qwen");
     m_engineCombo->addItem("glm (智谱清言)", "glm");
     m_engineCombo->addItem("paddle (百度PaddleOCR)", "paddle");
+    m_engineCombo->addItem("paddle_onnx (本地PP-OCRv4 / ONNX Runtime)", "paddle_onnx");
     m_engineCombo->addItem("doubao (字节豆包)", "doubao");
     m_engineCombo->addItem("gemini (谷歌Gemini)", "gemini");
     m_engineCombo->addItem("gen (通用OpenAI兼容)", "gen");
     m_engineCombo->addItem("custom (自定义OpenAI格式API)", "custom");
+    m_engineCombo->addItem("cascade (级联：本地优先，低置信度转 VLM)", "cascade");
     formLayout->addRow("引擎*:", m_engineCombo);
     
     // Provider 选择
@@ -1730,6 +1827,62 @@ void ModelEditDialog::setupUI()
     m_enableThinkingCheck->setChecked(false);  // 默认关闭
     paramsLayout->addRow("", m_enableThinkingCheck);
     
+    // 近似去重
+    m_phashThresholdSpin = new QSpinBox();
+    m_phashThresholdSpin->setRange(0, 16);
+    m_phashThresholdSpin->setValue(0);
+    m_phashThresholdSpin->setSpecialValueText("关闭");
+    m_phashThresholdSpin->setToolTip("重复截取同一区域时，光标、选框等细微差异会导致缓存无法命中。\n"
+                                     "开启后按感知哈希比较图片，汉明距离不超过该值即直接返回缓存结果。\n"
+                                     "0 表示关闭，推荐 3-6；数值越大越宽松，也越容易误命中");
+    QLabel* phashLabel = new QLabel("近似去重阈值:");
+    phashLabel->setToolTip(m_phashThresholdSpin->toolTip());
+    paramsLayout->addRow(phashLabel, m_phashThresholdSpin);
+    
+    // 超大图分块
+    m_tileMaxSideSpin = new QSpinBox();
+    m_tileMaxSideSpin->setRange(0, 8192);
+    m_tileMaxSideSpin->setSingleStep(256);
+    m_tileMaxSideSpin->setValue(0);
+    m_tileMaxSideSpin->setSuffix(" px");
+    m_tileMaxSideSpin->setSpecialValueText("关闭");
+    m_tileMaxSideSpin->setToolTip("图纸、长截图等超大图片直接上传会被压缩或超出服务商像素上限。\n"
+                                  "开启后长边超过该值的图片切成带重叠的分块并发识别，再合并结果。\n"
+                                  "0 表示关闭，最小 512，推荐 2048");
+    // 0 与下限之间的值不能分块，输入后抬到下限
+    connect(m_tileMaxSideSpin, &QSpinBox::editingFinished, this, [this]() {
+        const int value = m_tileMaxSideSpin->value();
+        if (value > 0 && value < ImageTiler::kMinMaxSide) {
+            m_tileMaxSideSpin->setValue(ImageTiler::kMinMaxSide);
+        }
+    });
+    QLabel* tileLabel = new QLabel("分块最长边:");
+    tileLabel->setToolTip(m_tileMaxSideSpin->toolTip());
+    paramsLayout->addRow(tileLabel, m_tileMaxSideSpin);
+    
+    m_tileOverlapSpin = new QSpinBox();
+    m_tileOverlapSpin->setRange(0, 1024);
+    m_tileOverlapSpin->setSingleStep(32);
+    m_tileOverlapSpin->setValue(128);
+    m_tileOverlapSpin->setSuffix(" px");
+    m_tileOverlapSpin->setToolTip("相邻分块的重叠宽度，应大于一行文字的高度，避免文字被切断");
+    m_tileOverlapSpin->setEnabled(false);
+    connect(m_tileMaxSideSpin, QOverload<int>::of(&QSpinBox::valueChanged), m_tileOverlapSpin, [this](int value) {
+        m_tileOverlapSpin->setEnabled(value > 0);
+    });
+    paramsLayout->addRow("分块重叠:", m_tileOverlapSpin);
+    
+    // 批量并发上限
+    m_maxConcurrencySpin = new QSpinBox();
+    m_maxConcurrencySpin->setRange(0, 64);
+    m_maxConcurrencySpin->setValue(0);
+    m_maxConcurrencySpin->setSpecialValueText("默认 (16)");
+    m_maxConcurrencySpin->setToolTip("批量识别时并发数会根据响应延迟与限流、超时自动增减，这里设置其上限。\n"
+                                     "本地服务或有严格速率限制的接口可调低");
+    QLabel* concurrencyLabel = new QLabel("最大并发:");
+    concurrencyLabel->setToolTip(m_maxConcurrencySpin->toolTip());
+    paramsLayout->addRow(concurrencyLabel, m_maxConcurrencySpin);
+    
     mainLayout->addWidget(paramsGroup);
     
     QHBoxLayout* btnLayout = new QHBoxLayout();
@@ -1800,6 +1953,15 @@ void ModelEditDialog::setupUI()
 
 void ModelEditDialog::loadConfig(const ModelConfig& config)
 {
+    static const QStringList editedKeys = {
+        "api_key", "api_host", "model_name", "lang", "path", "temperature", "enable_thinking",
+        "phash_threshold", "tile_max_side", "tile_overlap", "max_concurrency", "deploy_type"
+    };
+    m_extraParams = config.params;
+    for (const QString& key : editedKeys) {
+        m_extraParams.remove(key);
+    }
+    
     m_idEdit->setText(config.id);
     m_nameEdit->setText(config.displayName);
     
@@ -1831,12 +1993,19 @@ void ModelEditDialog::loadConfig(const ModelConfig& config)
     if (provider.isEmpty() || config.type == "local") {
         m_apiKeyEdit->setText(config.params.value("api_key", ""));
         // 优先使用 api_url（PaddleOCR 使用），如果没有则使用 api_host 或 llm_host（其他引擎使用）
-        QString apiUrl = config.params.value("api_url", "");
-        if (apiUrl.isEmpty()) {
-            apiUrl = config.params.value("api_host", "");
+        // 记住来源参数，保存时写回同一个键；三个键都由该字段编辑，不再作为额外参数原样写回
+        static const QStringList urlKeys = { "api_url", "api_host", "llm_host" };
+        QString apiUrl;
+        m_urlParamKey = "api_host";
+        for (const QString& key : urlKeys) {
+            apiUrl = config.params.value(key, "");
+            if (!apiUrl.isEmpty()) {
+                m_urlParamKey = key;
+                break;
+            }
         }
-        if (apiUrl.isEmpty()) {
-            apiUrl = config.params.value("llm_host", "");
+        for (const QString& key : urlKeys) {
+            m_extraParams.remove(key);
         }
         m_apiUrlEdit->setText(apiUrl);
     } else {
@@ -1862,6 +2031,11 @@ void ModelEditDialog::loadConfig(const ModelConfig& config)
     bool enableThinking = (thinkingStr == "true" || thinkingStr == "1");
     m_enableThinkingCheck->setChecked(enableThinking);
     
+    m_phashThresholdSpin->setValue(config.params.value("phash_threshold", "0").toInt());
+    m_tileOverlapSpin->setValue(config.params.value("tile_overlap", "128").toInt());
+    m_tileMaxSideSpin->setValue(ImageTiler::fromParams(config.params).maxSide);
+    m_maxConcurrencySpin->setValue(config.params.value("max_concurrency", "0").toInt());
+    
     // 加载配置后，触发一次provider选择改变的处理，以更新字段状态（特别是离线模型的API URL字段）
     // 使用 QTimer::singleShot 确保在UI完全加载后再触发
     QMetaObject::invokeMethod(this, "onProviderComboChanged", Qt::QueuedConnection);
@@ -1877,13 +2051,14 @@ ModelConfig ModelEditDialog::getModelConfig() const
     config.engine = m_engineCombo->currentData().toString();
     config.enabled = m_enabledCheck->isChecked();
     config.provider = m_providerCombo->currentData().toString();
+    config.params = m_extraParams;
     
     // 只有在不使用 provider 时才保存这些字段
     if (config.provider.isEmpty()) {
         if (!m_apiKeyEdit->text().isEmpty())
             config.params["api_key"] = m_apiKeyEdit->text();
         if (!m_apiUrlEdit->text().isEmpty()) {
-            config.params["api_host"] = m_apiUrlEdit->text();
+            config.params[m_urlParamKey] = m_apiUrlEdit->text();
         }
     }
     
@@ -1897,6 +2072,17 @@ ModelConfig ModelEditDialog::getModelConfig() const
     
     config.params["enable_thinking"] = m_enableThinkingCheck->isChecked() ? "true" : "false";
     
+    if (m_phashThresholdSpin->value() > 0)
+        config.params["phash_threshold"] = QString::number(m_phashThresholdSpin->value());
+    
+    if (m_tileMaxSideSpin->value() > 0) {
+        config.params["tile_max_side"] = QString::number(qMax(m_tileMaxSideSpin->value(), int(ImageTiler::kMinMaxSide)));
+        config.params["tile_overlap"] = QString::number(m_tileOverlapSpin->value());
+    }
+    
+    if (m_maxConcurrencySpin->value() > 0)
+        config.params["max_concurrency"] = QString::number(m_maxConcurrencySpin->value());
+    
     config.params["deploy_type"] = config.type == "local" ? "local" : "online";
     
     return config;
@@ -1936,10 +2122,14 @@ void ModelEditDialog::onTestApiKey()
     }
 
     // 部分离线 OCR 模型需要图片，不做提示词测试
-    if (config.engine == "tesseract" || config.engine == "paddle") {
+    if (config.engine == "tesseract" || config.engine == "paddle" || config.engine == "paddle_onnx") {
         QMessageBox::information(this, "提示", "当前模型为 OCR 引擎，请在主页上传图片后测试识别效果。");
         return;
     }
+    if (config.engine == "cascade") {
+        QMessageBox::information(this, "提示", "级联模型引用其它模型 (参数 local_model / vlm_model)，请在主页上传图片后测试识别效果。");
+        return;
+    }
 
     m_testApiBtn->setEnabled(false);
     m_testApiBtn->setText("测试中...");
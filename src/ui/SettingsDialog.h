@@ -102,8 +102,17 @@ private:
     QWidget* m_generalTab;
     QCheckBox* m_autoCopyCheck;
     QCheckBox* m_autoRecognizeAfterScreenshot;
+    QSpinBox* m_pdfDpiSpin;
     QCheckBox* m_persistenceCheck;
     QSpinBox* m_maxHistorySpin;
+    QSpinBox* m_resultCacheSpin;
+    QSpinBox* m_resultStoreSpin;
+    QSpinBox* m_resultStoreTtlSpin;
+    QCheckBox* m_hotFolderCheck;
+    QLineEdit* m_hotFoldersEdit;
+    QSpinBox* m_hotFolderConcurrencySpin;
+    QComboBox* m_hotFolderOutputCombo;
+    QLineEdit* m_hotFolderPromptEdit;
 
     // 关于标签页
     QWidget* m_aboutTab;
@@ -133,6 +142,11 @@ private:
     void setupUI();
     void loadConfig(const ModelConfig& config);
     
+    // 对话框中没有对应控件的参数（如 tessdata、mode），保存时原样写回
+    QMap<QString, QString> m_extraParams;
+    // API URL 字段加载自哪个参数 (api_url / api_host / llm_host)，保存时写回同一个键
+    QString m_urlParamKey = "api_host";
+    
     QLineEdit* m_idEdit;
     QLineEdit* m_nameEdit;
     QComboBox* m_typeCombo;
@@ -150,6 +164,10 @@ private:
     QLineEdit* m_pathEdit;
     QDoubleSpinBox* m_temperatureEdit;
     QCheckBox* m_enableThinkingCheck;  // 思考模式开关
+    QSpinBox* m_phashThresholdSpin;    // 近似去重阈值（感知哈希汉明距离）
+    QSpinBox* m_tileMaxSideSpin;       // 超大图分块最长边（0 表示不分块）
+    QSpinBox* m_tileOverlapSpin;       // 分块重叠像素
+    QSpinBox* m_maxConcurrencySpin;    // 批量自适应并发上限（0 表示默认）
     QPushButton* m_testApiBtn;
     ConfigManager* m_configManager;
     
@@ -0,0 +1,139 @@
+#include "ThumbnailCache.h"
+#include <QImageReader>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+ThumbnailCache& ThumbnailCache::instance() {
+    static ThumbnailCache cache;
+    return cache;
+}
+
+ThumbnailCache::ThumbnailCache() {
+    // 默认 32MB：约可容纳 1000 张历史缩略图或 30 张预览图
+    m_cache.setMaxCost(32 * 1024 * 1024);
+}
+
+QImage ThumbnailCache::makeThumbnail(const QImage& image, int maxSide) {
+    if (image.isNull()) return QImage();
+    if (image.width() <= maxSide && image.height() <= maxSide) return image;
+    return image.scaled(maxSide, maxSide, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+QImage ThumbnailCache::readScaled(const QString& path, int maxSide) {
+    if (path.isEmpty() || !QFile::exists(path)) return QImage();
+
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    QSize size = reader.size();
+    if (size.isValid() && (size.width() > maxSide || size.height() > maxSide)) {
+        reader.setScaledSize(size.scaled(maxSide, maxSide, Qt::KeepAspectRatio));
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "ThumbnailCache: Failed to read" << path << reader.errorString();
+        return QImage();
+    }
+    // 部分格式不支持 setScaledSize，这里兜底再缩放一次
+    return makeThumbnail(image, maxSide);
+}
+
+QImage ThumbnailCache::get(const QString& key) const {
+    QMutexLocker locker(&m_mutex);
+    QImage* cached = m_cache.object(key);
+    return cached ? *cached : QImage();
+}
+
+void ThumbnailCache::insert(const QString& key, const QImage& image) {
+    if (key.isEmpty() || image.isNull()) return;
+    QMutexLocker locker(&m_mutex);
+    int cost = static_cast<int>(qMin<qint64>(image.sizeInBytes(), m_cache.maxCost()));
+    m_cache.insert(key, new QImage(image), cost);
+}
+
+void ThumbnailCache::remove(const QString& key) {
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(key);
+}
+
+void ThumbnailCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+void ThumbnailCache::setMaxBytes(int bytes) {
+    if (bytes <= 0) return;
+    QMutexLocker locker(&m_mutex);
+    m_cache.setMaxCost(bytes);
+}
+
+QImage ThumbnailCache::load(const QString& thumbPath, const QString& sourcePath) {
+    const QString key = thumbPath.isEmpty() ? sourcePath : thumbPath;
+    if (key.isEmpty()) return QImage();
+
+    QImage thumb = get(key);
+    if (!thumb.isNull()) return thumb;
+
+    // 1. 磁盘缩略图
+    if (!thumbPath.isEmpty() && QFile::exists(thumbPath)) {
+        thumb.load(thumbPath);
+    }
+
+    // 2. 旧记录没有缩略图：从原图降采样生成并回写，后续不再解码原图
+    if (thumb.isNull() && !sourcePath.isEmpty()) {
+        thumb = readScaled(sourcePath, kThumbnailSize);
+        if (!thumb.isNull() && !thumbPath.isEmpty()) {
+            QDir().mkpath(QFileInfo(thumbPath).absolutePath());
+            thumb.save(thumbPath, "JPG", 85);
+        }
+    }
+
+    if (!thumb.isNull()) insert(key, thumb);
+    return thumb;
+}
+
+QFuture<QImage> ThumbnailCache::loadAsync(const QString& thumbPath, const QString& sourcePath) {
+    return QtConcurrent::run([this, thumbPath, sourcePath]() -> QImage {
+        return load(thumbPath, sourcePath);
+    });
+}
+
+QFuture<QImage> ThumbnailCache::previewAsync(const QString& key, const QImage& source, const QString& sourcePath, int width) {
+    return QtConcurrent::run([this, key, source, sourcePath, width]() -> QImage {
+        QImage preview = get(key);
+        if (!preview.isNull()) return preview;
+
+        if (!source.isNull()) {
+            preview = source.width() > width
+                ? source.scaledToWidth(width, Qt::SmoothTransformation)
+                : source;
+        } else if (!sourcePath.isEmpty()) {
+            QImageReader reader(sourcePath);
+            reader.setAutoTransform(true);
+            QSize size = reader.size();
+            if (size.isValid() && size.width() > width) {
+                reader.setScaledSize(size.scaled(width, size.height() * width / size.width() + 1, Qt::KeepAspectRatio));
+            }
+            preview = reader.read();
+        }
+
+        if (!preview.isNull()) insert(key, preview);
+        return preview;
+    });
+}
+
+QFuture<QImage> ThumbnailCache::previewAsync(const QString& key, const std::function<QImage()>& sourceLoader, int width) {
+    return QtConcurrent::run([this, key, sourceLoader, width]() -> QImage {
+        QImage preview = get(key);
+        if (!preview.isNull()) return preview;
+
+        QImage source = sourceLoader ? sourceLoader() : QImage();
+        if (source.isNull()) return source;
+        preview = source.width() > width
+            ? source.scaledToWidth(width, Qt::SmoothTransformation)
+            : source;
+        insert(key, preview);
+        return preview;
+    });
+}
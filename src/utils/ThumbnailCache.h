@@ -0,0 +1,52 @@
+#pragma once
+#include <QImage>
+#include <QString>
+#include <QCache>
+#include <QMutex>
+#include <QFuture>
+#include <functional>
+
+// 缩略图缓存
+// 负责缩略图的生成、磁盘读写以及内存 LRU 缓存（线程安全，可在工作线程中调用）
+class ThumbnailCache {
+public:
+    static ThumbnailCache& instance();
+
+    static const int kThumbnailSize = 160;  // 历史列表缩略图最长边
+    static const int kPreviewWidth = 600;   // 首页预览图最大宽度
+
+    // 按最长边等比缩放生成缩略图（不放大小图）
+    static QImage makeThumbnail(const QImage& image, int maxSide = kThumbnailSize);
+
+    // 直接从文件按目标尺寸解码（JPEG 等格式由解码器直接降采样，不产生全尺寸位图）
+    static QImage readScaled(const QString& path, int maxSide);
+
+    // 内存缓存读写，未命中返回空图
+    QImage get(const QString& key) const;
+    void insert(const QString& key, const QImage& image);
+    void remove(const QString& key);
+    void clear();
+
+    // 内存缓存预算（字节）
+    void setMaxBytes(int bytes);
+
+    // 读取缩略图：内存 → 磁盘缩略图文件 → 原图降采样（可选，命中后写回缩略图文件）
+    QImage load(const QString& thumbPath, const QString& sourcePath = QString());
+
+    // 在全局线程池中异步执行 load()
+    QFuture<QImage> loadAsync(const QString& thumbPath, const QString& sourcePath = QString());
+
+    // 异步生成预览图：内存命中直接返回，否则从原图或文件降采样并写入缓存
+    QFuture<QImage> previewAsync(const QString& key, const QImage& source, const QString& sourcePath, int width = kPreviewWidth);
+
+    // 同上，原图由 sourceLoader 在工作线程中生成 (如渲染 PDF 页面)
+    QFuture<QImage> previewAsync(const QString& key, const std::function<QImage()>& sourceLoader, int width = kPreviewWidth);
+
+private:
+    ThumbnailCache();
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    mutable QMutex m_mutex;
+    QCache<QString, QImage> m_cache; // cost 为像素字节数
+};
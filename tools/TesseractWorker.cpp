@@ -0,0 +1,220 @@
+// Tesseract 常驻工作进程 (xs_tesseract_worker)
+// 进程模式下由 TesseractAdapter 按参数 workers 启动，每个语言组合的 traineddata 只加载一次 (最近用过的几个组合常驻)：
+//   请求: [4 字节大端长度][语言组合 '\n' 编码后的图片 (PNG 等 Leptonica 支持的格式)]，语言组合为空时使用启动参数
+//   响应: [4 字节大端长度][TSV，含表头]，长度为 0 表示识别失败
+//   语言组合为 "osd" 时只做脚本检测，响应为 "Script: <名称>\nScript confidence: <置信度>\n" (与 --psm 0 相同)
+// 标准输入关闭时退出。不依赖 Qt，可与只调用 tesseract 命令行的主程序分开部署
+// 用法: xs_tesseract_worker [-l <语言组合>] [--tessdata <目录>]
+#include <tesseract/baseapi.h>
+#include <leptonica/allheaders.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+const char kTsvHeader[] = "level\tpage_num\tblock_num\tpar_num\tline_num\tword_num\t"
+                          "left\ttop\twidth\theight\tconf\ttext\n";
+
+bool readFully(void* data, size_t size)
+{
+    return size == 0 || fread(data, 1, size, stdin) == size;
+}
+
+bool readLength(uint32_t& length)
+{
+    unsigned char header[4];
+    if (!readFully(header, sizeof(header))) return false;
+    length = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | header[3];
+    return true;
+}
+
+void writeFrame(const std::string& payload)
+{
+    const uint32_t length = static_cast<uint32_t>(payload.size());
+    const unsigned char header[4] = {
+        static_cast<unsigned char>(length >> 24), static_cast<unsigned char>(length >> 16),
+        static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length)
+    };
+    fwrite(header, 1, sizeof(header), stdout);
+    if (!payload.empty()) fwrite(payload.data(), 1, payload.size(), stdout);
+    fflush(stdout);
+}
+
+// 同时保留的识别引擎数 (每个语言组合一个)：自动语言在几种组合之间切换时不必逐张重新加载 traineddata
+const size_t kMaxEngines = 3;
+
+class Engine {
+public:
+    explicit Engine(const std::string& dataPath) : m_dataPath(dataPath) {}
+    ~Engine()
+    {
+        for (Loaded& loaded : m_engines) {
+            loaded.api->End();
+        }
+        m_osd.End();
+    }
+
+    // 返回该语言组合的识别引擎，最近使用的在前；不在缓存中时加载，缓存满时淘汰最久未用的
+    tesseract::TessBaseAPI* use(const std::string& lang)
+    {
+        for (std::list<Loaded>::iterator it = m_engines.begin(); it != m_engines.end(); ++it) {
+            if (it->lang == lang) {
+                m_engines.splice(m_engines.begin(), m_engines, it);
+                return m_engines.front().api.get();
+            }
+        }
+
+        std::unique_ptr<tesseract::TessBaseAPI> api(new tesseract::TessBaseAPI());
+        if (api->Init(m_dataPath.empty() ? nullptr : m_dataPath.c_str(), lang.c_str()) != 0) {
+            fprintf(stderr, "xs_tesseract_worker: failed to load language '%s'\n", lang.c_str());
+            return nullptr;
+        }
+        // 与命令行和库模式的引擎池一致 (API 的默认值不是 PSM_AUTO)
+        api->SetPageSegMode(tesseract::PSM_AUTO);
+
+        if (m_engines.size() >= kMaxEngines) {
+            m_engines.back().api->End();
+            m_engines.pop_back();
+        }
+        Loaded loaded;
+        loaded.lang = lang;
+        loaded.api = std::move(api);
+        m_engines.push_front(std::move(loaded));
+        return m_engines.front().api.get();
+    }
+
+    // 脚本检测使用独立的 osd 引擎，不影响识别引擎已加载的语言
+    std::string detectScript(const unsigned char* image, size_t size)
+    {
+        if (!m_osdReady) {
+            if (m_osd.Init(m_dataPath.empty() ? nullptr : m_dataPath.c_str(), "osd") != 0) {
+                fprintf(stderr, "xs_tesseract_worker: failed to load osd\n");
+                return std::string();
+            }
+            m_osdReady = true;
+        }
+        Pix* pix = decode(image, size);
+        if (!pix) return std::string();
+
+        std::string output;
+        int orientation = 0;
+        float orientationConfidence = 0.0f;
+        const char* script = nullptr;
+        float scriptConfidence = 0.0f;
+        m_osd.SetImage(pix);
+        if (m_osd.DetectOrientationScript(&orientation, &orientationConfidence, &script, &scriptConfidence) && script) {
+            char line[128];
+            snprintf(line, sizeof(line), "Script: %s\nScript confidence: %.2f\n", script, scriptConfidence);
+            output = line;
+        }
+        m_osd.Clear();
+        pixDestroy(&pix);
+        return output;
+    }
+
+    static std::string recognize(tesseract::TessBaseAPI* api, const unsigned char* image, size_t size)
+    {
+        Pix* pix = decode(image, size);
+        if (!pix) return std::string();
+        std::string tsv;
+        api->SetImage(pix);
+        if (api->Recognize(nullptr) == 0) {
+            char* text = api->GetTSVText(0);
+            if (text) {
+                tsv = std::string(kTsvHeader) + text;
+                delete[] text;
+            }
+        }
+        api->Clear();
+        pixDestroy(&pix);
+        return tsv;
+    }
+
+private:
+    static Pix* decode(const unsigned char* image, size_t size)
+    {
+        Pix* pix = pixReadMem(image, size);
+        if (!pix) fprintf(stderr, "xs_tesseract_worker: cannot decode image (%zu bytes)\n", size);
+        return pix;
+    }
+
+    struct Loaded {
+        std::string lang;
+        std::unique_ptr<tesseract::TessBaseAPI> api;
+    };
+
+    std::list<Loaded> m_engines;   // 最近使用的在前
+    tesseract::TessBaseAPI m_osd;
+    bool m_osdReady = false;
+    std::string m_dataPath;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    std::string lang = "chi_sim+eng";
+    std::string dataPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-l") == 0) {
+            lang = argv[i + 1];
+        } else if (strcmp(argv[i], "--tessdata") == 0) {
+            dataPath = argv[i + 1];
+        } else {
+            fprintf(stderr, "usage: %s [-l <lang>] [--tessdata <dir>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // 启动时预加载默认语言，语言数据缺失时立即退出而不是在第一张图片才失败
+    Engine engine(dataPath);
+    if (!engine.use(lang)) {
+        return 1;
+    }
+
+    std::vector<unsigned char> buffer;
+    uint32_t length = 0;
+    while (readLength(length)) {
+        buffer.resize(length);
+        if (!readFully(buffer.data(), length)) break;
+
+        const unsigned char* newline = length > 0
+            ? static_cast<const unsigned char*>(memchr(buffer.data(), '\n', length))
+            : nullptr;
+        if (!newline) {
+            writeFrame(std::string());
+            continue;
+        }
+        const std::string requested(reinterpret_cast<const char*>(buffer.data()),
+                                    static_cast<size_t>(newline - buffer.data()));
+        const unsigned char* image = newline + 1;
+        const size_t imageSize = length - static_cast<size_t>(image - buffer.data());
+
+        if (requested == "osd") {
+            writeFrame(engine.detectScript(image, imageSize));
+            continue;
+        }
+        tesseract::TessBaseAPI* api = engine.use(requested.empty() ? lang : requested);
+        if (!api) {
+            writeFrame(std::string());
+            continue;
+        }
+        writeFrame(Engine::recognize(api, image, imageSize));
+    }
+    return 0;
+}